@@ -0,0 +1,185 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "test_init.h"
+
+// Std
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// hermes
+#include "hermes_shm/data_structures/ipc/btree_map.h"
+
+/**
+ * A series of performance tests for ordered maps. Keys are inserted and
+ * looked up in a pseudo-random order.
+ * OUTPUT:
+ * [test_name] [map_type] [time_ms]
+ * */
+template <typename MapT>
+class OrderedMapTest {
+ public:
+  std::string map_type_;
+  MapT *map_;
+  std::vector<size_t> keys_;
+  void *ptr_;
+
+  /**====================================
+   * Test Runner
+   * ===================================*/
+
+  /** Test case constructor */
+  OrderedMapTest() {
+    if constexpr (std::is_same_v<MapT, std::map<size_t, size_t>>) {
+      map_type_ = "std::map";
+    } else if constexpr (std::is_same_v<MapT,
+                                        hipc::btree_map<size_t, size_t>>) {
+      map_type_ = "hipc::btree_map";
+    } else {
+      HELOG(kFatal, "none of the ordered map tests matched");
+    }
+  }
+
+  /** Run the tests */
+  void Test(size_t count) {
+    hshm::u64 x = 1;
+    for (size_t i = 0; i < count; ++i) {
+      // xorshift64 keys
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      keys_.emplace_back(x % (count * 4));
+    }
+    EmplaceTest();
+    GetTest();
+    RangeScanTest(100);
+    BulkLoadTest(count);
+  }
+
+  /**====================================
+   * Tests
+   * ===================================*/
+
+  /** Emplace performance */
+  void EmplaceTest() {
+    Timer t;
+    Allocate();
+    t.Resume();
+    Emplace();
+    t.Pause();
+    TestOutput("RandomEmplace", t);
+    Destroy();
+  }
+
+  /** Get performance */
+  void GetTest() {
+    Timer t;
+    Allocate();
+    Emplace();
+    t.Resume();
+    for (size_t key : keys_) {
+      size_t &val = (*map_->find(key)).second;
+      USE(val);
+    }
+    t.Pause();
+    TestOutput("RandomGet", t);
+    Destroy();
+  }
+
+  /** Visit the entries in [key, key + width) for every key */
+  void RangeScanTest(size_t width) {
+    Timer t;
+    size_t visited = 0;
+    Allocate();
+    Emplace();
+    t.Resume();
+    for (size_t key : keys_) {
+      auto end = map_->lower_bound(key + width);
+      for (auto iter = map_->lower_bound(key); iter != end; ++iter) {
+        visited += (*iter).second;
+      }
+    }
+    t.Pause();
+    USE(visited);
+    TestOutput("RangeScan", t);
+    Destroy();
+  }
+
+  /** Build the map from sorted entries */
+  void BulkLoadTest(size_t count) {
+    std::vector<std::pair<size_t, size_t>> entries;
+    for (size_t i = 0; i < count; ++i) {
+      entries.emplace_back(i, i);
+    }
+    Timer t;
+    Allocate();
+    t.Resume();
+    if constexpr (std::is_same_v<MapT, std::map<size_t, size_t>>) {
+      for (auto &entry : entries) {
+        map_->emplace_hint(map_->end(), entry.first, entry.second);
+      }
+    } else {
+      map_->bulk_load(entries.begin(), entries.end());
+    }
+    t.Pause();
+    TestOutput("SortedBulkLoad", t);
+    Destroy();
+  }
+
+ private:
+  /**====================================
+   * Helpers
+   * ===================================*/
+
+  /** Output as CSV */
+  void TestOutput(const std::string &test_name, Timer &t) {
+    HIPRINT("{},{},{}\n", test_name, map_type_, t.GetMsec());
+  }
+
+  /** Emplace the keys into the map */
+  void Emplace() {
+    for (size_t key : keys_) {
+      map_->emplace(key, key);
+    }
+  }
+
+  /** Allocate the map */
+  void Allocate() {
+    if constexpr (std::is_same_v<MapT, std::map<size_t, size_t>>) {
+      map_ = new MapT();
+    } else {
+      map_ = HSHM_DEFAULT_ALLOC
+                 ->template NewObjLocal<MapT>(HSHM_DEFAULT_MEM_CTX)
+                 .ptr_;
+    }
+  }
+
+  /** Destroy the map */
+  void Destroy() {
+    if constexpr (std::is_same_v<MapT, std::map<size_t, size_t>>) {
+      delete map_;
+    } else {
+      HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, map_);
+    }
+  }
+};
+
+void FullOrderedMapTest() {
+  const size_t count = 1000000;
+  OrderedMapTest<std::map<size_t, size_t>>().Test(count);
+  OrderedMapTest<hipc::btree_map<size_t, size_t>>().Test(count);
+}
+
+TEST_CASE("BtreeMapBenchmark") { FullOrderedMapTest(); }
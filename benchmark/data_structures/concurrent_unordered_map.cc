@@ -0,0 +1,144 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "test_init.h"
+
+// Std
+#include <string>
+
+// hermes
+#include "hermes_shm/data_structures/ipc/concurrent_unordered_map.h"
+#include "hermes_shm/data_structures/ipc/unordered_map.h"
+#include "hermes_shm/thread/lock/rwlock.h"
+
+typedef hipc::unordered_map<size_t, size_t> locked_map;
+typedef hipc::concurrent_unordered_map<size_t, size_t> concurrent_map;
+
+/**
+ * A read-mostly workload: 1 in 20 operations overwrites a key and the
+ * rest look keys up. hipc::unordered_map is shared behind one RwLock.
+ * OUTPUT:
+ * [test_name] [map_type] [nthreads] [time_ms] [MOps]
+ * */
+template <typename MapT>
+class ConcurrentMapTest {
+ public:
+  std::string map_type_;
+  MapT *map_;
+  hshm::RwLock lock_;
+  void *ptr_;
+
+  /**====================================
+   * Test Runner
+   * ===================================*/
+
+  /** Test case constructor */
+  ConcurrentMapTest() {
+    if constexpr (std::is_same_v<MapT, locked_map>) {
+      map_type_ = "hipc::unordered_map+RwLock";
+    } else if constexpr (std::is_same_v<MapT, concurrent_map>) {
+      map_type_ = "hipc::concurrent_unordered_map";
+    } else {
+      HELOG(kFatal, "none of the concurrent map tests matched");
+    }
+  }
+
+  /** Run the tests */
+  void Test(size_t count, size_t count_per_rank, int nthreads) {
+    Allocate(count);
+    Timer t;
+    t.Resume();
+    omp_set_dynamic(0);
+#pragma omp parallel num_threads(nthreads)
+    {
+      size_t rank = omp_get_thread_num();
+      hshm::u64 x = rank + 1;
+      for (size_t i = 0; i < count_per_rank; ++i) {
+        // xorshift64 keys
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        size_t key = x % count;
+        if (i % 20 == 0) {
+          Put(key, i);
+        } else {
+          size_t val = Get(key);
+          USE(val);
+        }
+      }
+    }
+    t.Pause();
+    TestOutput("ReadMostly", t, count_per_rank * nthreads, nthreads);
+    Destroy();
+  }
+
+ private:
+  /**====================================
+   * Helpers
+   * ===================================*/
+
+  /** Output as CSV */
+  void TestOutput(const std::string &test_name, Timer &t, size_t count,
+                  int nthreads) {
+    HIPRINT("{},{},{},{}ms,{}MOps\n", test_name, map_type_, nthreads,
+            t.GetMsec(), (float)count / t.GetUsec());
+  }
+
+  /** Overwrite a key */
+  void Put(size_t key, size_t val) {
+    if constexpr (std::is_same_v<MapT, locked_map>) {
+      hshm::ScopedRwWriteLock guard(lock_, 0);
+      map_->emplace(key, val);
+    } else {
+      map_->emplace(key, val);
+    }
+  }
+
+  /** Look a key up */
+  size_t Get(size_t key) {
+    size_t val = 0;
+    if constexpr (std::is_same_v<MapT, locked_map>) {
+      hshm::ScopedRwReadLock guard(lock_, 0);
+      auto iter = map_->find(key);
+      if (!iter.is_end()) {
+        val = (*iter).GetVal();
+      }
+    } else {
+      map_->find(key, val);
+    }
+    return val;
+  }
+
+  /** Allocate and fill the map */
+  void Allocate(size_t count) {
+    map_ = HSHM_DEFAULT_ALLOC
+               ->template NewObjLocal<MapT>(HSHM_DEFAULT_MEM_CTX, count)
+               .ptr_;
+    for (size_t i = 0; i < count; ++i) {
+      map_->emplace(i, i);
+    }
+  }
+
+  /** Destroy the map */
+  void Destroy() { HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, map_); }
+};
+
+void FullConcurrentMapTest() {
+  const size_t count = 1 << 16, count_per_rank = 1000000;
+  for (int nthreads = 1; nthreads <= 16; nthreads *= 2) {
+    ConcurrentMapTest<locked_map>().Test(count, count_per_rank, nthreads);
+    ConcurrentMapTest<concurrent_map>().Test(count, count_per_rank, nthreads);
+  }
+}
+
+TEST_CASE("ConcurrentUnorderedMapBenchmark") { FullConcurrentMapTest(); }
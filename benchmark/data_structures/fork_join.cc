@@ -0,0 +1,176 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "test_init.h"
+
+// Std
+#include <atomic>
+#include <string>
+#include <vector>
+
+// hermes
+#include "hermes_shm/data_structures/ipc/split_ticket_queue.h"
+#include "hermes_shm/data_structures/ipc/ws_deque.h"
+
+/**
+ * A fork-join benchmark for load balancing task queues. Each task is the
+ * depth of a subtree of a binary task tree: it forks two children until
+ * the depth reaches zero. The tree is seeded on a single worker, so the
+ * others only get work through load balancing.
+ * OUTPUT:
+ * [test_name] [queue_type] [nthreads] [time_ms] [MTasks]
+ * */
+template <typename QueueT>
+class ForkJoinTest {
+ public:
+  std::string queue_type_;
+  std::vector<QueueT *> queues_;
+  std::atomic<size_t> leaves_;
+
+  /**====================================
+   * Test Runner
+   * ===================================*/
+
+  /** Test case constructor */
+  ForkJoinTest() {
+    if constexpr (std::is_same_v<QueueT, hipc::ws_deque<size_t>>) {
+      queue_type_ = "hipc::ws_deque";
+    } else if constexpr (std::is_same_v<QueueT,
+                                        hipc::split_ticket_queue<size_t>>) {
+      queue_type_ = "hipc::split_ticket_queue";
+    } else {
+      HELOG(kFatal, "none of the queue tests matched");
+    }
+  }
+
+  /** Run a task tree of \a depth on \a nthreads workers */
+  void Test(size_t depth, int nthreads) {
+    Timer t;
+    Allocate(depth, nthreads);
+    leaves_ = 0;
+    size_t nleaves = (size_t)1 << depth;
+
+    t.Resume();
+    omp_set_dynamic(0);
+#pragma omp parallel num_threads(nthreads)
+    {
+      int rank = omp_get_thread_num();
+      hshm::u64 seed = rank + 1;
+      if (rank == 0) {
+        Push(0, depth);
+      }
+      while (leaves_.load() < nleaves) {
+        size_t task;
+        if (Get(rank, nthreads, seed, task)) {
+          Run(rank, task);
+        } else {
+          HSHM_THREAD_MODEL->Yield();
+        }
+      }
+    }
+    t.Pause();
+
+    TestOutput("ForkJoin", t, 2 * nleaves - 1, nthreads);
+    Destroy();
+  }
+
+ private:
+  /**====================================
+   * Helpers
+   * ===================================*/
+
+  /** Output as CSV */
+  void TestOutput(const std::string &test_name, Timer &t, size_t count,
+                  int nthreads) {
+    HIPRINT("{},{},{},{}ms,{}MTasks\n", test_name, queue_type_, nthreads,
+            t.GetMsec(), (float)count / t.GetUsec());
+  }
+
+  /** Execute a task, forking its children */
+  void Run(int rank, size_t task) {
+    if (task == 0) {
+      leaves_.fetch_add(1);
+      return;
+    }
+    Push(rank, task - 1);
+    Push(rank, task - 1);
+  }
+
+  /** Spawn a task on the worker \a rank */
+  void Push(int rank, size_t task) {
+    if constexpr (std::is_same_v<QueueT, hipc::ws_deque<size_t>>) {
+      queues_[rank]->push(task);
+    } else {
+      if (queues_[0]->emplace(task).IsNull()) {
+        Run(rank, task);
+      }
+    }
+  }
+
+  /** Get a task for the worker \a rank. False if none was found. */
+  bool Get(int rank, int nthreads, hshm::u64 &seed, size_t &task) {
+    if constexpr (std::is_same_v<QueueT, hipc::ws_deque<size_t>>) {
+      if (!queues_[rank]->pop(task).IsNull()) {
+        return true;
+      }
+      // xorshift64 to pick a victim
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      int victim = (int)(seed % nthreads);
+      return victim != rank && !queues_[victim]->steal(task).IsNull();
+    } else {
+      (void)rank;
+      (void)nthreads;
+      (void)seed;
+      return !queues_[0]->pop(task).IsNull();
+    }
+  }
+
+  /** Allocate the queues for the test cases */
+  void Allocate(size_t depth, int nthreads) {
+    auto alloc = HSHM_DEFAULT_ALLOC;
+    if constexpr (std::is_same_v<QueueT, hipc::ws_deque<size_t>>) {
+      for (int i = 0; i < nthreads; ++i) {
+        queues_.emplace_back(
+            alloc->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX, 64)
+                .ptr_);
+      }
+    } else {
+      // Tasks run inline once every split is full
+      queues_.emplace_back(alloc
+                               ->template NewObjLocal<QueueT>(
+                                   HSHM_DEFAULT_MEM_CTX,
+                                   (depth + 1) * 64, nthreads)
+                               .ptr_);
+    }
+  }
+
+  /** Destroy the queues */
+  void Destroy() {
+    for (QueueT *queue : queues_) {
+      HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue);
+    }
+    queues_.clear();
+  }
+};
+
+void FullForkJoinTest() {
+  const size_t depth = 18;
+  for (int nthreads = 1; nthreads <= 64; nthreads *= 2) {
+    ForkJoinTest<hipc::ws_deque<size_t>>().Test(depth, nthreads);
+    ForkJoinTest<hipc::split_ticket_queue<size_t>>().Test(depth, nthreads);
+  }
+}
+
+TEST_CASE("ForkJoinBenchmark") { FullForkJoinTest(); }
@@ -0,0 +1,131 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "test_init.h"
+
+// Std
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// hermes
+#include "hermes_shm/data_structures/ipc/hash.h"
+
+/** The byte-at-a-time string hash hshm::string_hash used to be */
+static size_t legacy_string_hash(const std::string &text) {
+  size_t sum = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    auto shift = static_cast<size_t>(i % sizeof(size_t));
+    auto c = static_cast<size_t>((unsigned char)text[i]);
+    sum = 31 * sum + (c << shift);
+  }
+  return sum;
+}
+
+/**
+ * Bucket distribution of integer keys. Keys follow a stride and are
+ * placed in buckets with a modulo, as hipc::unordered_map does. The
+ * identity hash is what hshm::hash used to be for integers.
+ * OUTPUT:
+ * [test_name] [hash] [stride] [max_bucket_load] [empty_bucket_pct]
+ * */
+class HashDistributionTest {
+ public:
+  /** Run the tests */
+  void Test(size_t nkeys, size_t nbuckets, size_t stride) {
+    std::vector<size_t> identity(nbuckets, 0), mixed(nbuckets, 0);
+    for (size_t i = 0; i < nkeys; ++i) {
+      size_t key = i * stride;
+      ++identity[key % nbuckets];
+      ++mixed[hshm::hash<size_t>{}(key) % nbuckets];
+    }
+    TestOutput("identity", stride, identity);
+    TestOutput("hshm::hash", stride, mixed);
+  }
+
+ private:
+  /** Output as CSV */
+  void TestOutput(const std::string &hash_name, size_t stride,
+                  std::vector<size_t> &buckets) {
+    size_t max_load = *std::max_element(buckets.begin(), buckets.end());
+    size_t empty = std::count(buckets.begin(), buckets.end(), 0);
+    HIPRINT("Distribution,{},{},{},{}%\n", hash_name, stride, max_load,
+            100.0 * empty / buckets.size());
+  }
+};
+
+/**
+ * Throughput of string hashes over strings of a fixed length
+ * OUTPUT:
+ * [test_name] [hash] [length] [time_ms] [GBps]
+ * */
+class StringHashTest {
+ public:
+  size_t sink_ = 0;
+
+  /** Run the tests */
+  void Test(size_t length, size_t total_bytes) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 64; ++i) {
+      std::string key(length, 'a');
+      for (size_t j = 0; j < length; ++j) {
+        key[j] = (char)('a' + (i * 31 + j * 7) % 26);
+      }
+      keys.emplace_back(std::move(key));
+    }
+    size_t count = total_bytes / length;
+    Timer t;
+
+    t.Resume();
+    for (size_t i = 0; i < count; ++i) {
+      sink_ += legacy_string_hash(keys[i % keys.size()]);
+    }
+    t.Pause();
+    TestOutput("legacy", length, t, count * length);
+
+    t.Reset();
+    for (size_t i = 0; i < count; ++i) {
+      sink_ += hshm::string_hash(keys[i % keys.size()]);
+    }
+    t.Pause();
+    TestOutput("hshm::string_hash", length, t, count * length);
+
+    t.Reset();
+    for (size_t i = 0; i < count; ++i) {
+      sink_ += std::hash<std::string_view>{}(keys[i % keys.size()]);
+    }
+    t.Pause();
+    TestOutput("std::hash", length, t, count * length);
+  }
+
+ private:
+  /** Output as CSV */
+  void TestOutput(const std::string &hash_name, size_t length, Timer &t,
+                  size_t bytes) {
+    HIPRINT("StringHash,{},{},{}ms,{}GBps\n", hash_name, length, t.GetMsec(),
+            (double)bytes / t.GetNsec());
+  }
+};
+
+TEST_CASE("HashBenchmark") {
+  const size_t nkeys = 1 << 16, nbuckets = 1024;
+  for (size_t stride : {1, 8, 1024, 4096}) {
+    HashDistributionTest().Test(nkeys, nbuckets, stride);
+  }
+  StringHashTest test;
+  for (size_t length : {8, 16, 32, 64, 256, 4096}) {
+    test.Test(length, 1 << 28);
+  }
+  REQUIRE(test.sink_ != 0);
+}
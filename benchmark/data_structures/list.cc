@@ -40,13 +40,14 @@ class ListTest {
   std::string internal_type_;
   ListT *lp_;
   void *ptr_;
+  hshm::u32 node_chunk_;
 
   /**====================================
    * Test Runner
    * ===================================*/
 
-  /** Test case constructor */
-  ListTest() {
+  /** Test case constructor. hipc lists pool nodes if \a node_chunk > 0. */
+  explicit ListTest(hshm::u32 node_chunk = 0) : node_chunk_(node_chunk) {
     if constexpr (std::is_same_v<std::list<T>, ListT>) {
       list_type_ = "std::list";
     } else if constexpr (std::is_same_v<hipc::list<T>, ListT>) {
@@ -58,6 +59,9 @@ class ListTest {
     } else {
       HELOG(kFatal, "none of the list tests matched");
     }
+    if (node_chunk_) {
+      list_type_ += "(pooled)";
+    }
     internal_type_ = InternalTypeName<T>::Get();
   }
 
@@ -214,8 +218,10 @@ class ListTest {
     auto alloc = HSHM_DEFAULT_ALLOC;
     if constexpr (std::is_same_v<ListT, hipc::list<T>>) {
       lp_ = alloc->template NewObjLocal<ListT>(HSHM_DEFAULT_MEM_CTX).ptr_;
+      lp_->set_node_chunk(node_chunk_);
     } else if constexpr (std::is_same_v<ListT, hipc::slist<T>>) {
       lp_ = alloc->template NewObjLocal<ListT>(HSHM_DEFAULT_MEM_CTX).ptr_;
+      lp_->set_node_chunk(node_chunk_);
     } else if constexpr (std::is_same_v<ListT, bipc_list<T>>) {
       lp_ = BOOST_SEGMENT->construct<ListT>("BoostList")(
           BOOST_ALLOCATOR((std::pair<int, T>)));
@@ -258,6 +264,12 @@ void FullListTest() {
   ListTest<size_t, hipc::slist<size_t>>().Test();
   ListTest<std::string, hipc::slist<std::string>>().Test();
   ListTest<hipc::string, hipc::slist<hipc::string>>().Test();
+
+  // Pooled hipc::list and hipc::slist tests
+  ListTest<size_t, hipc::list<size_t>>(64).Test();
+  ListTest<hipc::string, hipc::list<hipc::string>>(64).Test();
+  ListTest<size_t, hipc::slist<size_t>>(64).Test();
+  ListTest<hipc::string, hipc::slist<hipc::string>>(64).Test();
 }
 
 TEST_CASE("ListBenchmark") { FullListTest(); }
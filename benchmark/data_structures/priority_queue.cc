@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "test_init.h"
+
+// Std
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+
+// hermes
+#include "hermes_shm/data_structures/ipc/multi_priority_queue.h"
+#include "hermes_shm/data_structures/ipc/priority_queue.h"
+
+/** Deadlines are popped earliest first */
+typedef std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>>
+    std_deadline_queue;
+typedef hipc::priority_queue<size_t, std::greater<size_t>> deadline_queue;
+typedef hipc::multi_priority_queue<size_t, std::greater<size_t>>
+    multi_deadline_queue;
+
+/**
+ * A series of performance tests for priority queues. Each worker pushes
+ * pseudo-random deadlines and pops one after every push, so the queue
+ * stays at a steady depth. std::priority_queue and hipc::priority_queue
+ * are shared behind a mutex when there are several workers.
+ * OUTPUT:
+ * [test_name] [queue_type] [nthreads] [time_ms] [MOps]
+ * */
+template <typename QueueT>
+class PriorityQueueTest {
+ public:
+  std::string queue_type_;
+  QueueT *queue_;
+  std::mutex lock_;
+
+  /**====================================
+   * Test Runner
+   * ===================================*/
+
+  /** Test case constructor */
+  PriorityQueueTest() {
+    if constexpr (std::is_same_v<QueueT, std_deadline_queue>) {
+      queue_type_ = "std::priority_queue";
+    } else if constexpr (std::is_same_v<QueueT, deadline_queue>) {
+      queue_type_ = "hipc::priority_queue";
+    } else if constexpr (std::is_same_v<QueueT, multi_deadline_queue>) {
+      queue_type_ = "hipc::multi_priority_queue";
+    } else {
+      HELOG(kFatal, "none of the priority queue tests matched");
+    }
+  }
+
+  /** Run the tests */
+  void Test(size_t depth, size_t count_per_rank, int nthreads) {
+    Allocate(nthreads);
+    Fill(depth);
+    Timer t;
+    t.Resume();
+    omp_set_dynamic(0);
+#pragma omp parallel num_threads(nthreads)
+    {
+      size_t rank = omp_get_thread_num();
+      hshm::u64 x = rank + 1;
+      for (size_t i = 0; i < count_per_rank; ++i) {
+        // xorshift64 deadlines
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        Push(x % 1000000, nthreads);
+        Pop(nthreads);
+      }
+    }
+    t.Pause();
+    TestOutput("PushPop", t, 2 * count_per_rank * nthreads, nthreads);
+    Destroy();
+  }
+
+ private:
+  /**====================================
+   * Helpers
+   * ===================================*/
+
+  /** Output as CSV */
+  void TestOutput(const std::string &test_name, Timer &t, size_t count,
+                  int nthreads) {
+    HIPRINT("{},{},{},{}ms,{}MOps\n", test_name, queue_type_, nthreads,
+            t.GetMsec(), (float)count / t.GetUsec());
+  }
+
+  /** Push a deadline */
+  void Push(size_t deadline, int nthreads) {
+    if constexpr (std::is_same_v<QueueT, multi_deadline_queue>) {
+      queue_->push(deadline);
+    } else if (nthreads == 1) {
+      queue_->push(deadline);
+    } else {
+      std::lock_guard<std::mutex> guard(lock_);
+      queue_->push(deadline);
+    }
+  }
+
+  /** Pop the earliest deadline */
+  void Pop(int nthreads) {
+    if constexpr (std::is_same_v<QueueT, multi_deadline_queue>) {
+      size_t deadline;
+      queue_->pop(deadline);
+    } else if (nthreads == 1) {
+      queue_->pop();
+    } else {
+      std::lock_guard<std::mutex> guard(lock_);
+      queue_->pop();
+    }
+  }
+
+  /** Pre-fill the queue with \a depth deadlines */
+  void Fill(size_t depth) {
+    for (size_t i = 0; i < depth; ++i) {
+      queue_->push((i * 7919) % 1000000);
+    }
+  }
+
+  /** Allocate the queue */
+  void Allocate(int nthreads) {
+    if constexpr (std::is_same_v<QueueT, std_deadline_queue>) {
+      queue_ = new QueueT();
+    } else if constexpr (std::is_same_v<QueueT, multi_deadline_queue>) {
+      queue_ = HSHM_DEFAULT_ALLOC
+                   ->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX,
+                                                  2 * nthreads)
+                   .ptr_;
+    } else {
+      queue_ = HSHM_DEFAULT_ALLOC
+                   ->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX)
+                   .ptr_;
+    }
+  }
+
+  /** Destroy the queue */
+  void Destroy() {
+    if constexpr (std::is_same_v<QueueT, std_deadline_queue>) {
+      delete queue_;
+    } else {
+      HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
+    }
+  }
+};
+
+void FullPriorityQueueTest() {
+  const size_t depth = 4096, count_per_rank = 100000;
+  for (int nthreads = 1; nthreads <= 16; nthreads *= 2) {
+    PriorityQueueTest<std_deadline_queue>().Test(depth, count_per_rank,
+                                                 nthreads);
+    PriorityQueueTest<deadline_queue>().Test(depth, count_per_rank, nthreads);
+    PriorityQueueTest<multi_deadline_queue>().Test(depth, count_per_rank,
+                                                   nthreads);
+  }
+}
+
+TEST_CASE("PriorityQueueBenchmark") { FullPriorityQueueTest(); }
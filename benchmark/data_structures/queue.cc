@@ -19,12 +19,34 @@
 #include <string>
 
 // hermes
+#include "hermes_shm/data_structures/ipc/locked_ticket_queue.h"
 #include "hermes_shm/data_structures/ipc/ring_ptr_queue.h"
 #include "hermes_shm/data_structures/ipc/ring_queue.h"
 #include "hermes_shm/data_structures/ipc/split_ticket_queue.h"
 #include "hermes_shm/data_structures/ipc/string.h"
 #include "hermes_shm/data_structures/ipc/ticket_queue.h"
 
+/** Detect a split_ticket_queue and name its lane policy */
+template <typename QueueT>
+struct SplitTicketQueueInfo {
+  static constexpr bool value = false;
+};
+template <typename T, typename LaneT, typename AllocT,
+          hipc::ShmFlagField HSHM_FLAGS>
+struct SplitTicketQueueInfo<
+    hipc::split_ticket_queue<T, LaneT, AllocT, HSHM_FLAGS>> {
+  static constexpr bool value = true;
+  static std::string GetName() {
+    if constexpr (std::is_same_v<LaneT, hipc::split_rr_lanes>) {
+      return "hipc::split_ticket_queue<rr>";
+    } else if constexpr (std::is_same_v<LaneT, hipc::split_cpu_lanes>) {
+      return "hipc::split_ticket_queue<cpu>";
+    } else {
+      return "hipc::split_ticket_queue<tid>";
+    }
+  }
+};
+
 /**
  * A series of performance tests for vectors
  * OUTPUT:
@@ -55,10 +77,17 @@ class QueueTest {
       queue_type_ = "hipc::mpsc_ptr_queue";
     } else if constexpr (std::is_same_v<hipc::spsc_queue<T>, QueueT>) {
       queue_type_ = "hipc::spsc_queue";
+    } else if constexpr (std::is_same_v<hipc::fast_mpsc_queue<T>, QueueT>) {
+      queue_type_ = "hipc::fast_mpsc_queue";
+    } else if constexpr (std::is_same_v<hipc::fast_spsc_queue<T>, QueueT>) {
+      queue_type_ = "hipc::fast_spsc_queue";
     } else if constexpr (std::is_same_v<hipc::ticket_queue<T>, QueueT>) {
       queue_type_ = "hipc::ticket_queue";
-    } else if constexpr (std::is_same_v<hipc::split_ticket_queue<T>, QueueT>) {
-      queue_type_ = "hipc::split_ticket_queue";
+    } else if constexpr (std::is_same_v<hipc::locked_ticket_queue<T>,
+                                        QueueT>) {
+      queue_type_ = "hipc::locked_ticket_queue";
+    } else if constexpr (SplitTicketQueueInfo<QueueT>::value) {
+      queue_type_ = SplitTicketQueueInfo<QueueT>::GetName();
     } else {
       HELOG(kFatal, "none of the queue tests matched");
     }
@@ -150,10 +179,18 @@ class QueueTest {
           queue_->emplace(var.Get());
         } else if constexpr (std::is_same_v<QueueT, hipc::spsc_queue<T>>) {
           queue_->emplace(var.Get());
+        } else if constexpr (std::is_same_v<QueueT,
+                                            hipc::fast_mpsc_queue<T>>) {
+          queue_->emplace(var.Get());
+        } else if constexpr (std::is_same_v<QueueT,
+                                            hipc::fast_spsc_queue<T>>) {
+          queue_->emplace(var.Get());
         } else if constexpr (std::is_same_v<QueueT, hipc::ticket_queue<T>>) {
           queue_->emplace(var.Get());
         } else if constexpr (std::is_same_v<QueueT,
-                                            hipc::split_ticket_queue<T>>) {
+                                            hipc::locked_ticket_queue<T>>) {
+          queue_->emplace(var.Get());
+        } else if constexpr (SplitTicketQueueInfo<QueueT>::value) {
           queue_->emplace(var.Get());
         }
       }
@@ -181,10 +218,20 @@ class QueueTest {
         } else if constexpr (std::is_same_v<QueueT, hipc::spsc_queue<T>>) {
           queue_->pop(x_);
           USE(x_);
+        } else if constexpr (std::is_same_v<QueueT,
+                                            hipc::fast_mpsc_queue<T>>) {
+          queue_->pop(x_);
+          USE(x_);
+        } else if constexpr (std::is_same_v<QueueT,
+                                            hipc::fast_spsc_queue<T>>) {
+          queue_->pop(x_);
+          USE(x_);
         } else if constexpr (std::is_same_v<QueueT, hipc::ticket_queue<T>>) {
           while (queue_->pop(x_).IsNull());
         } else if constexpr (std::is_same_v<QueueT,
-                                            hipc::split_ticket_queue<T>>) {
+                                            hipc::locked_ticket_queue<T>>) {
+          while (queue_->pop(x_).IsNull());
+        } else if constexpr (SplitTicketQueueInfo<QueueT>::value) {
           while (queue_->pop(x_).IsNull());
         }
       }
@@ -207,12 +254,24 @@ class QueueTest {
     } else if constexpr (std::is_same_v<QueueT, hipc::spsc_queue<T>>) {
       queue_ =
           alloc->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX, count).ptr_;
+    } else if constexpr (std::is_same_v<QueueT, hipc::fast_mpsc_queue<T>>) {
+      queue_ =
+          alloc->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX, count).ptr_;
+    } else if constexpr (std::is_same_v<QueueT, hipc::fast_spsc_queue<T>>) {
+      queue_ =
+          alloc->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX, count).ptr_;
     } else if constexpr (std::is_same_v<QueueT, hipc::ticket_queue<T>>) {
       queue_ =
           alloc->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX, count).ptr_;
-    } else if constexpr (std::is_same_v<QueueT, hipc::split_ticket_queue<T>>) {
+    } else if constexpr (std::is_same_v<QueueT,
+                                        hipc::locked_ticket_queue<T>>) {
       queue_ =
-          alloc->template NewObjLocal<QueueT>(count_per_rank, nthreads).ptr_;
+          alloc->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX, count).ptr_;
+    } else if constexpr (SplitTicketQueueInfo<QueueT>::value) {
+      queue_ = alloc
+                   ->template NewObjLocal<QueueT>(HSHM_DEFAULT_MEM_CTX,
+                                                  count_per_rank, nthreads)
+                   .ptr_;
     }
   }
 
@@ -227,9 +286,16 @@ class QueueTest {
       HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
     } else if constexpr (std::is_same_v<QueueT, hipc::spsc_queue<T>>) {
       HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
+    } else if constexpr (std::is_same_v<QueueT, hipc::fast_mpsc_queue<T>>) {
+      HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
+    } else if constexpr (std::is_same_v<QueueT, hipc::fast_spsc_queue<T>>) {
+      HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
     } else if constexpr (std::is_same_v<QueueT, hipc::ticket_queue<T>>) {
       HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
-    } else if constexpr (std::is_same_v<QueueT, hipc::split_ticket_queue<T>>) {
+    } else if constexpr (std::is_same_v<QueueT,
+                                        hipc::locked_ticket_queue<T>>) {
+      HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
+    } else if constexpr (SplitTicketQueueInfo<QueueT>::value) {
       HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, queue_);
     }
   }
@@ -270,6 +336,44 @@ void FullQueueTest() {
   QueueTest<size_t, hipc::spsc_queue<size_t>>().Test(count_per_rank, 1);
   QueueTest<std::string, hipc::spsc_queue<std::string>>().Test();
   QueueTest<hipc::string, hipc::spsc_queue<hipc::string>>().Test();
+
+  // hipc::fast_mpsc_queue tests
+  QueueTest<size_t, hipc::fast_mpsc_queue<size_t>>().Test(count_per_rank, 1);
+
+  // hipc::fast_spsc_queue tests
+  QueueTest<size_t, hipc::fast_spsc_queue<size_t>>().Test(count_per_rank, 1);
 }
 
 TEST_CASE("QueueBenchmark") { FullQueueTest(); }
+
+/** Compare the lock-free ticket_queue against the mutex-based one */
+void TicketQueueTest() {
+  const size_t count_per_rank = (1 << 14);
+  for (int nthreads = 1; nthreads <= 64; nthreads *= 2) {
+    QueueTest<size_t, hipc::locked_ticket_queue<size_t>>().Test(
+        count_per_rank, nthreads);
+    QueueTest<size_t, hipc::ticket_queue<size_t>>().Test(count_per_rank,
+                                                         nthreads);
+  }
+}
+
+TEST_CASE("TicketQueueBenchmark") { TicketQueueTest(); }
+
+/**
+ * Compare split_ticket_queue lane policies. There is one split per
+ * thread, so throughput should scale with the number of splits.
+ * */
+template <typename LaneT>
+void SplitTicketQueueTest() {
+  const size_t count_per_rank = (1 << 14);
+  for (int nthreads = 1; nthreads <= 64; nthreads *= 2) {
+    QueueTest<size_t, hipc::split_ticket_queue<size_t, LaneT>>().Test(
+        count_per_rank, nthreads);
+  }
+}
+
+TEST_CASE("SplitTicketQueueBenchmark") {
+  SplitTicketQueueTest<hipc::split_rr_lanes>();
+  SplitTicketQueueTest<hipc::split_cpu_lanes>();
+  SplitTicketQueueTest<hipc::split_tid_lanes>();
+}
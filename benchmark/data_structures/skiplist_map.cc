@@ -0,0 +1,135 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "test_init.h"
+
+// Std
+#include <string>
+
+// hermes
+#include "hermes_shm/data_structures/ipc/skiplist_map.h"
+#include "hermes_shm/data_structures/ipc/unordered_map.h"
+#include "hermes_shm/thread/lock/mutex.h"
+
+typedef hipc::unordered_map<size_t, size_t> locked_map;
+typedef hipc::skiplist_map<size_t, size_t> skiplist;
+
+/**
+ * Concurrent inserts of distinct keys. hipc::unordered_map is shared
+ * behind one Mutex.
+ * OUTPUT:
+ * [test_name] [map_type] [nthreads] [time_ms] [MOps]
+ * */
+template <typename MapT>
+class ConcurrentInsertTest {
+ public:
+  std::string map_type_;
+  MapT *map_;
+  hshm::Mutex lock_;
+
+  /**====================================
+   * Test Runner
+   * ===================================*/
+
+  /** Test case constructor */
+  ConcurrentInsertTest() {
+    if constexpr (std::is_same_v<MapT, locked_map>) {
+      map_type_ = "hipc::unordered_map+Mutex";
+    } else if constexpr (std::is_same_v<MapT, skiplist>) {
+      map_type_ = "hipc::skiplist_map";
+    } else {
+      HELOG(kFatal, "none of the concurrent insert tests matched");
+    }
+  }
+
+  /** Run the tests */
+  void Test(size_t count_per_rank, int nthreads) {
+    Allocate(count_per_rank * nthreads, nthreads);
+    lock_.Init();
+    Timer t;
+    t.Resume();
+    omp_set_dynamic(0);
+#pragma omp parallel num_threads(nthreads)
+    {
+      size_t rank = omp_get_thread_num();
+      hipc::MemContext ctx;
+      Register(ctx);
+      for (size_t i = 0; i < count_per_rank; ++i) {
+        // Interleave the keys of the threads in a scrambled order
+        size_t key = ((i * 0x9e3779b97f4a7c15ULL) >> 16) * nthreads + rank;
+        Insert(ctx, key, i);
+      }
+      Unregister(ctx);
+    }
+    t.Pause();
+    TestOutput("ConcurrentInsert", t, count_per_rank * nthreads, nthreads);
+    Destroy();
+  }
+
+ private:
+  /**====================================
+   * Helpers
+   * ===================================*/
+
+  /** Output as CSV */
+  void TestOutput(const std::string &test_name, Timer &t, size_t count,
+                  int nthreads) {
+    HIPRINT("{},{},{},{}ms,{}MOps\n", test_name, map_type_, nthreads,
+            t.GetMsec(), (float)count / t.GetUsec());
+  }
+
+  /** Insert a key */
+  void Insert(const hipc::MemContext &ctx, size_t key, size_t val) {
+    if constexpr (std::is_same_v<MapT, locked_map>) {
+      hshm::ScopedMutex guard(lock_, 0);
+      map_->try_emplace(key, val);
+    } else {
+      map_->try_emplace(ctx, key, val);
+    }
+  }
+
+  /** Register the calling thread with the map */
+  void Register(hipc::MemContext &ctx) {
+    if constexpr (std::is_same_v<MapT, skiplist>) {
+      map_->Register(ctx);
+    }
+  }
+
+  /** Unregister the calling thread */
+  void Unregister(hipc::MemContext &ctx) {
+    if constexpr (std::is_same_v<MapT, skiplist>) {
+      map_->Unregister(ctx);
+    }
+  }
+
+  /** Allocate the map */
+  void Allocate(size_t count, int nthreads) {
+    size_t arg = std::is_same_v<MapT, skiplist> ? nthreads : count;
+    map_ = HSHM_DEFAULT_ALLOC
+               ->template NewObjLocal<MapT>(HSHM_DEFAULT_MEM_CTX, arg)
+               .ptr_;
+  }
+
+  /** Destroy the map */
+  void Destroy() { HSHM_DEFAULT_ALLOC->DelObj(HSHM_DEFAULT_MEM_CTX, map_); }
+};
+
+void FullConcurrentInsertTest() {
+  const size_t count_per_rank = 250000;
+  for (int nthreads = 1; nthreads <= 16; nthreads *= 2) {
+    ConcurrentInsertTest<locked_map>().Test(count_per_rank, nthreads);
+    ConcurrentInsertTest<skiplist>().Test(count_per_rank, nthreads);
+  }
+}
+
+TEST_CASE("SkiplistMapBenchmark") { FullConcurrentInsertTest(); }
@@ -21,6 +21,7 @@
 #include <unordered_map>
 
 // hermes
+#include "hermes_shm/data_structures/ipc/flat_map.h"
 #include "hermes_shm/data_structures/ipc/string.h"
 #include "hermes_shm/data_structures/ipc/unordered_map.h"
 
@@ -54,6 +55,8 @@ class UnorderedMapTest {
       map_type_ = "hipc::unordered_map";
     } else if constexpr (std::is_same_v<bipc_unordered_map<size_t, T>, MapT>) {
       map_type_ = "bipc::unordered_map";
+    } else if constexpr (std::is_same_v<hipc::flat_map<size_t, T>, MapT>) {
+      map_type_ = "hipc::flat_map";
     } else {
       std::cout << "INVALID: none of the unordered_map tests matched"
                 << std::endl;
@@ -67,6 +70,7 @@ class UnorderedMapTest {
     size_t count = 100000;
     // AllocateTest(count);
     EmplaceTest(count);
+    EmplaceLatencyTest(count);
     GetTest(count);
     ForwardIteratorTest(count);
     // CopyTest(count);
@@ -103,6 +107,25 @@ class UnorderedMapTest {
     Destroy();
   }
 
+  /** Slowest single emplace (e.g., one that triggers a rehash) */
+  void EmplaceLatencyTest(size_t count) {
+    Timer t, worst;
+    StringOrInt<T> var(124);
+    Allocate();
+
+    for (size_t i = 0; i < count; ++i) {
+      t.Reset();
+      map_->emplace(i, var.Get());
+      t.Pause();
+      if (t.GetNsec() > worst.GetNsec()) {
+        worst = t;
+      }
+    }
+
+    TestOutput("EmplaceMaxLatency", worst);
+    Destroy();
+  }
+
   /** Get performance */
   void GetTest(size_t count) {
     Timer t;
@@ -192,6 +215,9 @@ class UnorderedMapTest {
     } else if constexpr (std::is_same_v<MapT, hipc::unordered_map<size_t, T>>) {
       T &x = (*map_)[i];
       USE(x);
+    } else if constexpr (std::is_same_v<MapT, hipc::flat_map<size_t, T>>) {
+      T &x = (*map_)[i];
+      USE(x);
     }
   }
 
@@ -207,6 +233,8 @@ class UnorderedMapTest {
       } else if constexpr (std::is_same_v<MapT,
                                           hipc::unordered_map<size_t, T>>) {
         map_->emplace(i, var.Get());
+      } else if constexpr (std::is_same_v<MapT, hipc::flat_map<size_t, T>>) {
+        map_->emplace(i, var.Get());
       }
     }
   }
@@ -216,6 +244,8 @@ class UnorderedMapTest {
     auto alloc = HSHM_DEFAULT_ALLOC;
     if constexpr (std::is_same_v<MapT, hipc::unordered_map<size_t, T>>) {
       map_ = alloc->template NewObjLocal<MapT>(HSHM_DEFAULT_MEM_CTX, 5000).ptr_;
+    } else if constexpr (std::is_same_v<MapT, hipc::flat_map<size_t, T>>) {
+      map_ = alloc->template NewObjLocal<MapT>(HSHM_DEFAULT_MEM_CTX).ptr_;
     } else if constexpr (std::is_same_v<MapT, std::unordered_map<size_t, T>>) {
       map_ = new std::unordered_map<size_t, T>();
     } else if constexpr (std::is_same_v<MapT, bipc_unordered_map<size_t, T>>) {
@@ -227,7 +257,8 @@ class UnorderedMapTest {
   /** Destroy the unordered_map */
   void Destroy() {
     auto alloc = HSHM_DEFAULT_ALLOC;
-    if constexpr (std::is_same_v<MapT, hipc::unordered_map<size_t, T>>) {
+    if constexpr (std::is_same_v<MapT, hipc::unordered_map<size_t, T>> ||
+                  std::is_same_v<MapT, hipc::flat_map<size_t, T>>) {
       alloc->DelObj(HSHM_DEFAULT_MEM_CTX, map_);
     } else if constexpr (std::is_same_v<MapT, std::unordered_map<size_t, T>>) {
       delete map_;
@@ -256,6 +287,12 @@ void FullUnorderedMapTest() {
       .Test();
   UnorderedMapTest<hipc::string, hipc::unordered_map<size_t, hipc::string>>()
       .Test();
+
+  // hipc::flat_map tests
+  UnorderedMapTest<size_t, hipc::flat_map<size_t, size_t>>().Test();
+  UnorderedMapTest<std::string, hipc::flat_map<size_t, std::string>>().Test();
+  UnorderedMapTest<hipc::string, hipc::flat_map<size_t, hipc::string>>()
+      .Test();
 }
 
 TEST_CASE("UnorderedMapBenchmark") { FullUnorderedMapTest(); }
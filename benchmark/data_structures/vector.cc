@@ -65,6 +65,11 @@ class VectorTest {
     // AllocateTest(count);
     // ResizeTest(count);
     ReserveEmplaceTest(count);
+    GrowEmplaceTest(count);
+    MiddleInsertTest(count / 10);
+    if constexpr (std::is_same_v<T, size_t>) {
+      BulkAppendTest(count);
+    }
     // GetTest(count);
     // BeginIteratorTest(count);
     // EndIteratorTest(count);
@@ -119,6 +124,56 @@ class VectorTest {
     Destroy();
   }
 
+  /** Emplace without reserving, so the vector grows repeatedly */
+  void GrowEmplaceTest(size_t count) {
+    Timer t;
+
+    Allocate();
+    t.Resume();
+    Emplace(count);
+    t.Pause();
+
+    TestOutput("GrowEmplace", t);
+    Destroy();
+  }
+
+  /** Insert into the middle, shifting half of the vector each time */
+  void MiddleInsertTest(size_t count) {
+    Timer t;
+    StringOrInt<T> var(124);
+
+    Allocate();
+    vec_->reserve(count);
+    t.Resume();
+    for (size_t i = 0; i < count; ++i) {
+      vec_->emplace(vec_->begin() + vec_->size() / 2, var.Get());
+    }
+    t.Pause();
+
+    TestOutput("MiddleInsert", t);
+    Destroy();
+  }
+
+  /** Append a large array in chunks of 1000 elements */
+  void BulkAppendTest(size_t count) {
+    Timer t;
+    std::vector<T> src(1000, 124);
+
+    Allocate();
+    t.Resume();
+    for (size_t i = 0; i < count; i += src.size()) {
+      if constexpr (std::is_same_v<hipc::vector<T>, VecT>) {
+        vec_->append_n(src.data(), src.size());
+      } else {
+        vec_->insert(vec_->end(), src.begin(), src.end());
+      }
+    }
+    t.Pause();
+
+    TestOutput("BulkAppend", t);
+    Destroy();
+  }
+
   /** Get performance */
   void GetTest(size_t count) {
     Timer t;
@@ -229,6 +229,11 @@ namespace hipc = hshm::ipc;
 #endif
 #endif
 
+/** The size of a cache line, used to avoid false sharing */
+#ifndef HSHM_CACHE_LINE_SIZE
+#define HSHM_CACHE_LINE_SIZE 64
+#endif
+
 /** Default memory context object */
 #define HSHM_DEFAULT_MEM_CTX (hipc::MemContext{})
 #define HSHM_MCTX HSHM_DEFAULT_MEM_CTX
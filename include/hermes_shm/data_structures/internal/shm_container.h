@@ -13,6 +13,8 @@
 #ifndef HSHM_SHM_CONTAINER_H_
 #define HSHM_SHM_CONTAINER_H_
 
+#include <type_traits>
+
 #include "hermes_shm/constants/macros.h"
 #include "hermes_shm/memory/memory_manager_.h"
 #include "hermes_shm/types/bitfield.h"
@@ -26,6 +28,27 @@ namespace hshm::ipc {
  * */
 class ShmContainer {};
 
+/**
+ * Whether a T can be moved to another address by copying its bytes, after
+ * which the old bytes are dropped without being destroyed. True for
+ * trivially copyable types. Containers whose state is only offsets and
+ * sizes (never pointers into themselves) opt in with
+ * HSHM_TRIVIALLY_RELOCATABLE; other types may specialize this trait.
+ * */
+template <typename T, typename = void>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+template <typename T>
+struct is_trivially_relocatable<
+    T, std::void_t<typename T::hshm_trivially_relocatable_t>>
+    : std::true_type {};
+
+/** Whether a T can be relocated with memcpy */
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/** Declare that the enclosing class is trivially relocatable */
+#define HSHM_TRIVIALLY_RELOCATABLE typedef void hshm_trivially_relocatable_t;
+
 /**
  * Flags
  * */
@@ -34,6 +57,8 @@ struct ShmFlag {
   CLS_CONST ShmFlagField kIsPrivate = BIT_OPT(ShmFlagField, 0);
   CLS_CONST ShmFlagField kIsUndestructable = BIT_OPT(ShmFlagField, 1);
   CLS_CONST ShmFlagField kIsThreadLocal = kIsPrivate | kIsUndestructable;
+  /** Store node links as CompactOffsetPointer (list, slist, unordered_map) */
+  CLS_CONST ShmFlagField kCompactLinks = BIT_OPT(ShmFlagField, 2);
 };
 
 /**
@@ -77,6 +102,12 @@ struct ShmFlag {
                             hipc::CtxAllocator<AllocT>,             \
                             hipc::AllocatorId>::type
 
+/** The offset type a container uses to link its nodes */
+#define HSHM_LINK_POINTER                                              \
+  typename std::conditional<HSHM_FLAGS & hipc::ShmFlag::kCompactLinks, \
+                            hipc::CompactOffsetPointer,                \
+                            hipc::OffsetPointer>::type
+
 /** Typed nullptr */
 template <typename T>
 HSHM_INLINE_CROSS_FUN static T *typed_nullptr() {
@@ -0,0 +1,118 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_SHM_NODE_POOL_H_
+#define HSHM_SHM_NODE_POOL_H_
+
+#include "hermes_shm/constants/macros.h"
+#include "hermes_shm/memory/memory_manager_.h"
+
+namespace hshm::ipc {
+
+/** Header of a node pool chunk. Its entries follow it. */
+struct node_pool_chunk {
+  OffsetPointer next_; /**< The chunk allocated before this one, or null */
+};
+
+/**
+ * A pool of linked-list entries stored inline in a container header.
+ * Entries are carved out of chunks of chunk_nodes_ entries, so
+ * neighboring entries share cache lines and most inserts avoid the
+ * allocator. Freed entries go on a free list threaded through their
+ * next_ptr_ and are only returned to the allocator by Release.
+ *
+ * The pool is disabled when chunk_nodes_ is 0, in which case every entry
+ * is allocated and freed individually.
+ * */
+template <typename EntryT>
+struct node_pool {
+  static_assert(alignof(EntryT) <= alignof(node_pool_chunk),
+                "node_pool entries are over-aligned");
+
+  OffsetPointer free_ptr_;   /**< Free entries, linked through next_ptr_ */
+  OffsetPointer chunks_ptr_; /**< The most recently allocated chunk */
+  u32 chunk_nodes_ = 0;      /**< Entries per chunk, or 0 if disabled */
+
+  /** Forget all chunks without freeing them */
+  HSHM_INLINE_CROSS_FUN
+  void SetNull() {
+    free_ptr_.SetNull();
+    chunks_ptr_.SetNull();
+  }
+
+  /** Whether the pool owns no chunks */
+  HSHM_INLINE_CROSS_FUN
+  bool IsNull() const { return chunks_ptr_.IsNull(); }
+
+  /** Get an uninitialized entry, storing its offset in \a p */
+  template <typename AllocT>
+  HSHM_INLINE_CROSS_FUN EntryT *Allocate(AllocT *alloc, const MemContext &ctx,
+                                         OffsetPointer &p) {
+    if (chunk_nodes_ == 0) {
+      return alloc->template AllocateObjs<EntryT>(ctx, 1, p);
+    }
+    if (free_ptr_.IsNull()) {
+      AllocateChunk(alloc, ctx);
+    }
+    p = free_ptr_;
+    EntryT *entry = alloc->template Convert<EntryT>(p);
+    free_ptr_ = entry->next_ptr_;
+    return entry;
+  }
+
+  /** Return the entry \a entry at offset \a p to the pool */
+  template <typename AllocT>
+  HSHM_INLINE_CROSS_FUN void Free(AllocT *alloc, const MemContext &ctx,
+                                  OffsetPointer p, EntryT *entry) {
+    if (chunk_nodes_ == 0) {
+      alloc->Free(ctx, p);
+      return;
+    }
+    entry->next_ptr_ = free_ptr_;
+    free_ptr_ = p;
+  }
+
+  /** Free every chunk. All entries must have been returned first. */
+  template <typename AllocT>
+  HSHM_CROSS_FUN void Release(AllocT *alloc, const MemContext &ctx) {
+    OffsetPointer chunk_ptr = chunks_ptr_;
+    while (!chunk_ptr.IsNull()) {
+      OffsetPointer next = alloc->template Convert<node_pool_chunk>(chunk_ptr)
+                               ->next_;
+      alloc->template Free<OffsetPointer>(ctx, chunk_ptr);
+      chunk_ptr = next;
+    }
+    SetNull();
+  }
+
+ private:
+  /** Allocate a chunk and push its entries on the free list in order */
+  template <typename AllocT>
+  HSHM_CROSS_FUN void AllocateChunk(AllocT *alloc, const MemContext &ctx) {
+    size_t size = sizeof(node_pool_chunk) + chunk_nodes_ * sizeof(EntryT);
+    FullPtr<char, OffsetPointer> p =
+        alloc->template AllocateLocalPtr<char, OffsetPointer>(ctx, size);
+    auto *chunk = reinterpret_cast<node_pool_chunk *>(p.ptr_);
+    auto *entries = reinterpret_cast<EntryT *>(chunk + 1);
+    size_t entry_off = p.shm_.load() + sizeof(node_pool_chunk);
+    chunk->next_ = chunks_ptr_;
+    chunks_ptr_ = p.shm_;
+    for (size_t i = chunk_nodes_; i-- > 0;) {
+      entries[i].next_ptr_ = free_ptr_;
+      free_ptr_ = OffsetPointer(entry_off + i * sizeof(EntryT));
+    }
+  }
+};
+
+}  // namespace hshm::ipc
+
+#endif  // HSHM_SHM_NODE_POOL_H_
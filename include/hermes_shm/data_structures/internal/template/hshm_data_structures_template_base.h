@@ -4,15 +4,37 @@ using chararr_templ = HSHM_NS::chararr_templ<LENGTH, WithNull>;
 
 using HSHM_NS::chararr;
 
+using spsc_byte_ring = HSHM_NS::spsc_byte_ring<ALLOC_T>;
+
+using mpsc_byte_ring = HSHM_NS::mpsc_byte_ring<ALLOC_T>;
+
+template <typename DestroyF = HSHM_NS::epoch_no_destroy>
+using epoch_manager = HSHM_NS::epoch_manager<DestroyF, ALLOC_T>;
+
+template <typename T>
+using broadcast_ring = HSHM_NS::broadcast_ring<T, ALLOC_T>;
+
 template <typename T>
 using lifo_list_queue = HSHM_NS::lifo_list_queue<T, ALLOC_T>;
 
 template <typename T>
 using list = HSHM_NS::list<T, ALLOC_T>;
 
+template <typename T>
+using locked_ticket_queue = HSHM_NS::locked_ticket_queue<T, ALLOC_T>;
+
 template <typename T>
 using mpsc_lifo_list_queue = HSHM_NS::mpsc_lifo_list_queue<T, ALLOC_T>;
 
+template <typename T>
+using mpmc_lifo_list_queue = HSHM_NS::mpmc_lifo_list_queue<T, ALLOC_T>;
+
+template <typename T>
+using mpmc_ring_queue = HSHM_NS::mpmc_ring_queue<T, ALLOC_T>;
+
+template <typename T>
+using mpmc_segment_queue = HSHM_NS::mpmc_segment_queue<T, ALLOC_T>;
+
 template <typename T>
 using spsc_fifo_list_queue = HSHM_NS::spsc_fifo_list_queue<T, ALLOC_T>;
 
@@ -33,6 +55,14 @@ template <typename T>
 using circular_spsc_queue = HSHM_NS::circular_spsc_queue<T, ALLOC_T>;
 template <typename T>
 using ext_ring_buffer = HSHM_NS::ext_ring_buffer<T, ALLOC_T>;
+template <typename T>
+using fast_mpsc_queue = HSHM_NS::fast_mpsc_queue<T, ALLOC_T>;
+template <typename T>
+using fast_spsc_queue = HSHM_NS::fast_spsc_queue<T, ALLOC_T>;
+template <typename T>
+using blocking_mpsc_queue = HSHM_NS::blocking_mpsc_queue<T, ALLOC_T>;
+template <typename T>
+using blocking_spsc_queue = HSHM_NS::blocking_spsc_queue<T, ALLOC_T>;
 
 template <typename T>
 using spsc_ptr_queue = HSHM_NS::spsc_ptr_queue<T, ALLOC_T>;
@@ -49,11 +79,21 @@ using circular_spsc_ptr_queue = HSHM_NS::circular_spsc_queue<T, ALLOC_T>;
 template <typename T>
 using ext_ptr_ring_buffer = HSHM_NS::ext_ring_buffer<T, ALLOC_T>;
 
+template <typename T, class Compare = std::less<T>>
+using priority_queue = HSHM_NS::priority_queue<T, Compare, ALLOC_T>;
+
+template <typename T, class Compare = std::less<T>>
+using multi_priority_queue =
+    HSHM_NS::multi_priority_queue<T, Compare, ALLOC_T>;
+
 template <typename T>
 using slist = HSHM_NS::slist<T, ALLOC_T>;
 
-template <typename T>
-using split_ticket_queue = HSHM_NS::split_ticket_queue<T, ALLOC_T>;
+template <typename T, size_t N>
+using small_vector = HSHM_NS::small_vector<T, N, ALLOC_T>;
+
+template <typename T, typename LaneT = hipc::split_tid_lanes>
+using split_ticket_queue = HSHM_NS::split_ticket_queue<T, LaneT, ALLOC_T>;
 
 using string = HSHM_NS::string_templ<HSHM_STRING_SSO, 0, ALLOC_T>;
 
@@ -65,12 +105,28 @@ using charwrap =
 template <typename T>
 using ticket_queue = HSHM_NS::ticket_queue<T, ALLOC_T>;
 
+template <typename Key, typename T, class Compare = std::less<Key>>
+using btree_map = HSHM_NS::btree_map<Key, T, Compare, ALLOC_T>;
+
+template <typename Key, typename T, class Compare = std::less<Key>>
+using skiplist_map = HSHM_NS::skiplist_map<Key, T, Compare, ALLOC_T>;
+
+template <typename Key, typename T, class Hash = hshm::hash<Key>>
+using flat_map = HSHM_NS::flat_map<Key, T, Hash, ALLOC_T>;
+
 template <typename Key, typename T, class Hash = hshm::hash<Key>>
 using unordered_map = HSHM_NS::unordered_map<Key, T, Hash, ALLOC_T>;
 
+template <typename Key, typename T, class Hash = hshm::hash<Key>>
+using concurrent_unordered_map =
+    HSHM_NS::concurrent_unordered_map<Key, T, Hash, ALLOC_T>;
+
 template <typename T>
 using vector = HSHM_NS::vector<T, ALLOC_T>;
 
+template <typename T>
+using ws_deque = HSHM_NS::ws_deque<T, ALLOC_T>;
+
 template <typename T>
 using spsc_key_set = HSHM_NS::spsc_key_set<T, ALLOC_T>;
 
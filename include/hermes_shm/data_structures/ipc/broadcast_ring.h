@@ -0,0 +1,368 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_BROADCAST_RING_H_
+#define HSHM_DATA_STRUCTURES_IPC_BROADCAST_RING_H_
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/introspect/system_info.h"
+#include "hermes_shm/types/numbers.h"
+#include "hermes_shm/types/qtok.h"
+#include "ring_queue.h"
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/** The read cursor of one broadcast_ring consumer */
+struct broadcast_cursor {
+  CLS_CONST hshm::min_u64 kFree = 0;
+  CLS_CONST hshm::min_u64 kReaping = (hshm::min_u64)-1;
+
+  hipc::atomic<qtok_id> pos_;         /**< Next position to read */
+  hipc::atomic<hshm::min_u64> owner_; /**< Owning pid, or kFree */
+  ring_queue_pad<true> pad_;
+
+  /** Default constructor */
+  HSHM_INLINE_CROSS_FUN
+  broadcast_cursor() : pos_(0), owner_(kFree) {}
+
+  /** Whether the producer must wait for this cursor */
+  HSHM_INLINE_CROSS_FUN
+  bool IsActive() const {
+    hshm::min_u64 owner = owner_.load();
+    return owner != kFree && owner != kReaping;
+  }
+};
+
+/** Forward declaration of broadcast_ring */
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class broadcast_ring;
+
+/**
+ * MACROS used to simplify the broadcast_ring namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME broadcast_ring
+#define CLASS_NEW_ARGS T
+
+/**
+ * A single-producer multi-consumer broadcast ring (disruptor). The
+ * producer writes each entry once and every registered consumer reads
+ * it in place through its own cursor, so fan-out does not copy payloads.
+ * The producer may run at most one ring ahead of the slowest active
+ * cursor; the minimum is cached and only recomputed when the producer
+ * reaches it. Consumers may register and unregister at any time. A new
+ * consumer starts at the current tail. The depth is rounded up to a
+ * power of two.
+ *
+ * A consumer which stops reading pins the producer. Each cursor records
+ * the pid of its owner. ReapDeadConsumers releases the cursors of exited
+ * processes, and Unregister may evict any consumer, e.g. one the
+ * application considers stalled.
+ * */
+template <typename T, HSHM_CLASS_TEMPL>
+class broadcast_ring : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+
+ public:
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef vector<T, HSHM_CLASS_TEMPL_ARGS> vector_t;
+  typedef vector<broadcast_cursor, HSHM_CLASS_TEMPL_ARGS> cursor_vector_t;
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<vector_t> queue_;
+  delay_ar<cursor_vector_t> cursors_;
+  ring_queue_pad<true> pad0_;
+  hipc::atomic<qtok_id> tail_;
+  qtok_id gate_; /**< Producer's cached minimum cursor */
+  ring_queue_pad<true> pad1_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit broadcast_ring(size_t depth = 1024, size_t max_consumers = 64) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), depth,
+             max_consumers);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit broadcast_ring(const hipc::CtxAllocator<AllocT> &alloc,
+                          size_t depth = 1024, size_t max_consumers = 64) {
+    shm_init(alloc, depth, max_consumers);
+  }
+
+  /** SHM Constructor */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc, size_t depth = 1024,
+                size_t max_consumers = 64) {
+    init_shm_container(alloc);
+    HSHM_MAKE_AR(queue_, GetCtxAllocator(), hshm::RoundUpPow2(depth));
+    HSHM_MAKE_AR(cursors_, GetCtxAllocator(), max_consumers);
+    SetNull();
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Cursors are shared with concurrent consumers; copying is disabled */
+  broadcast_ring(const broadcast_ring &other) = delete;
+
+  /** Cursors are shared with concurrent consumers; copying is disabled */
+  broadcast_ring &operator=(const broadcast_ring &other) = delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor.  */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    (*queue_).shm_destroy();
+    (*cursors_).shm_destroy();
+  }
+
+  /** Check if the ring is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*queue_).IsNull(); }
+
+  /** Sets this ring as empty */
+  HSHM_CROSS_FUN
+  void SetNull() {
+    tail_ = 0;
+    gate_ = 0;
+  }
+
+  /**====================================
+   * Consumer Registration
+   * ===================================*/
+
+  /**
+   * Claim a cursor starting at the current tail. False if every cursor is
+   * owned by a live process.
+   * */
+  HSHM_CROSS_FUN
+  bool Register(size_t &id) {
+    if (TryRegister(id)) {
+      return true;
+    }
+#ifdef HSHM_IS_HOST
+    if (ReapDeadConsumers() > 0) {
+      return TryRegister(id);
+    }
+#endif
+    return false;
+  }
+
+  /**
+   * Release the cursor \a id; the producer stops waiting for it. Any
+   * process may call this to evict a stalled consumer.
+   * */
+  HSHM_CROSS_FUN
+  void Unregister(size_t id) {
+    (*cursors_)[id].owner_.store(broadcast_cursor::kFree);
+  }
+
+  /**
+   * Release the cursors of processes which are no longer alive.
+   * Returns the number of cursors released.
+   * */
+  HSHM_HOST_FUN
+  size_t ReapDeadConsumers() {
+    size_t count = 0;
+    for (broadcast_cursor &cursor : *cursors_) {
+      hshm::min_u64 owner = cursor.owner_.load();
+      if (owner == broadcast_cursor::kFree ||
+          owner == broadcast_cursor::kReaping) {
+        continue;
+      }
+      if (SystemInfo::IsProcessAlive((int)owner)) {
+        continue;
+      }
+      if (!cursor.owner_.compare_exchange_strong(owner,
+                                                 broadcast_cursor::kReaping)) {
+        continue;
+      }
+      cursor.owner_.store(broadcast_cursor::kFree);
+      ++count;
+    }
+    return count;
+  }
+
+  /**====================================
+   * Producer Methods
+   * ===================================*/
+
+  /** Construct an entry. Null if the slowest consumer is a ring behind. */
+  template <typename... Args>
+  HSHM_CROSS_FUN qtok_t emplace(Args &&...args) {
+    vector_t &queue = (*queue_);
+    size_t depth = queue.size();
+    qtok_id tail = tail_.load(std::memory_order_relaxed);
+    if (tail - gate_ >= depth) {
+      gate_ = GetGate(tail);
+      if (tail - gate_ >= depth) {
+        return qtok_t::GetNull();
+      }
+    }
+    queue.replace(queue.begin() + (tail & (depth - 1)),
+                  std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return qtok_t(tail);
+  }
+
+  /** Push an entry (wrapper) */
+  template <typename... Args>
+  HSHM_INLINE_CROSS_FUN qtok_t push(Args &&...args) {
+    return emplace(std::forward<Args>(args)...);
+  }
+
+  /**====================================
+   * Consumer Methods
+   * ===================================*/
+
+  /**
+   * Call \a f on up to \a count unread entries of consumer \a id in place,
+   * then advance its cursor past them. Returns the number of entries.
+   * */
+  template <typename F>
+  HSHM_CROSS_FUN size_t consume(size_t id, size_t count, F &&f) {
+    broadcast_cursor &cursor = (*cursors_)[id];
+    vector_t &queue = (*queue_);
+    size_t mask = queue.size() - 1;
+    qtok_id pos = cursor.pos_.load(std::memory_order_relaxed);
+    qtok_id tail = tail_.load(std::memory_order_acquire);
+    if (tail - pos < count) {
+      count = (size_t)(tail - pos);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const T &entry = queue[(pos + i) & mask];
+      f(entry);
+    }
+    if (count) {
+      cursor.pos_.store(pos + count, std::memory_order_release);
+    }
+    return count;
+  }
+
+  /** Copy the next entry of consumer \a id. Null if none is unread. */
+  HSHM_CROSS_FUN
+  qtok_t pop(size_t id, T &val) {
+    qtok_id pos = (*cursors_)[id].pos_.load(std::memory_order_relaxed);
+    if (consume(id, 1, [&val](const T &entry) { val = entry; }) == 0) {
+      return qtok_t::GetNull();
+    }
+    return qtok_t(pos);
+  }
+
+  /** Copy up to \a count entries of consumer \a id into \a vals */
+  HSHM_CROSS_FUN
+  size_t pop_n(size_t id, T *vals, size_t count) {
+    size_t i = 0;
+    return consume(id, count,
+                   [vals, &i](const T &entry) { vals[i++] = entry; });
+  }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** Get queue depth */
+  HSHM_CROSS_FUN
+  size_t GetDepth() { return queue_->size(); }
+
+  /** Get the maximum number of consumers */
+  HSHM_CROSS_FUN
+  size_t GetMaxConsumers() { return cursors_->size(); }
+
+  /** Get the number of entries consumer \a id has not read */
+  HSHM_CROSS_FUN
+  size_t GetSize(size_t id) {
+    qtok_id tail = tail_.load();
+    qtok_id pos = (*cursors_)[id].pos_.load();
+    return tail > pos ? (size_t)(tail - pos) : 0;
+  }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t size(size_t id) { return GetSize(id); }
+
+ private:
+  /** The slowest active cursor, or \a tail if there are no consumers */
+  HSHM_CROSS_FUN
+  qtok_id GetGate(qtok_id tail) {
+    cursor_vector_t &cursors = (*cursors_);
+    qtok_id gate = tail;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+      broadcast_cursor &cursor = cursors[i];
+      if (!cursor.IsActive()) {
+        continue;
+      }
+      qtok_id pos = cursor.pos_.load(std::memory_order_acquire);
+      if (pos < gate) {
+        gate = pos;
+      }
+    }
+    return gate;
+  }
+
+  /** Claim the first free cursor */
+  HSHM_CROSS_FUN
+  bool TryRegister(size_t &id) {
+    cursor_vector_t &cursors = (*cursors_);
+    hshm::min_u64 pid = (hshm::min_u64)HSHM_SYSTEM_INFO->pid_;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+      broadcast_cursor &cursor = cursors[i];
+      // Claim the cursor inactive, so the producer ignores its stale pos_
+      hshm::min_u64 owner = broadcast_cursor::kFree;
+      if (cursor.owner_.load() != owner ||
+          !cursor.owner_.compare_exchange_strong(owner,
+                                                 broadcast_cursor::kReaping)) {
+        continue;
+      }
+      // Until the producer sees the cursor, it may overwrite slots up to a
+      // ring past its last gate. That gate is behind any tail read after
+      // activation, so the second store starts the cursor at a safe point.
+      cursor.pos_.store(tail_.load());
+      cursor.owner_.store(pid);
+      cursor.pos_.store(tail_.load());
+      id = i;
+      return true;
+    }
+    return false;
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using broadcast_ring = hipc::broadcast_ring<T, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_BROADCAST_RING_H_
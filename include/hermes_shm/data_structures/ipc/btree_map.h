@@ -0,0 +1,1068 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_BTREE_MAP_H_
+#define HSHM_DATA_STRUCTURES_IPC_BTREE_MAP_H_
+
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/memory/memory.h"
+#include "hermes_shm/types/numbers.h"
+
+namespace hshm::ipc {
+
+/**
+ * The header of every btree_map node. A leaf stores count_ keys followed
+ * by count_ values. An inner node stores count_ separator keys followed by
+ * count_ + 1 child offsets. Every key in child i + 1 is not less than
+ * separator i, and every key in child i is less than it.
+ * */
+struct btree_node {
+  hshm::u32 count_;    /**< The number of keys in the node */
+  hshm::u32 is_leaf_;  /**< Whether the node is a leaf */
+  OffsetPointer next_; /**< The next leaf in key order (leaves only) */
+};
+
+/** Round \a off up to a multiple of \a align */
+HSHM_INLINE_CROSS_FUN constexpr size_t btree_align_up(size_t off,
+                                                      size_t align) {
+  return (off + align - 1) / align * align;
+}
+
+/** The larger of \a a and \a b */
+HSHM_INLINE_CROSS_FUN constexpr size_t btree_max(size_t a, size_t b) {
+  return a > b ? a : b;
+}
+
+/** forward pointer for btree_map */
+template <typename Key, typename T, class Compare = std::less<Key>,
+          HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class btree_map;
+
+/**
+ * A (key, value) entry of a btree_map. Keys and values are stored in
+ * separate arrays, so iterators return this view instead of a pair.
+ * */
+template <typename Key, typename T>
+struct btree_map_entry {
+  const Key &first;
+  T &second;
+
+  /** Get the key */
+  HSHM_INLINE_CROSS_FUN const Key &GetKey() const { return first; }
+
+  /** Get the value */
+  HSHM_INLINE_CROSS_FUN T &GetVal() const { return second; }
+};
+
+/**
+ * The btree_map iterator (leaf, slot). Walks the leaves in key order.
+ * */
+template <typename Key, typename T, class Compare, HSHM_CLASS_TEMPL>
+struct btree_map_iterator {
+ public:
+  using MAP_T = btree_map<Key, T, Compare, HSHM_CLASS_TEMPL_ARGS>;
+  using ENTRY_T = btree_map_entry<Key, T>;
+
+ public:
+  MAP_T *map_;
+  btree_node *leaf_; /**< The current leaf, or nullptr at the end */
+  size_t i_;         /**< The slot in the leaf */
+
+  /** Default constructor */
+  HSHM_CROSS_FUN btree_map_iterator() = default;
+
+  /** Construct the iterator at slot \a i of \a leaf */
+  HSHM_INLINE_CROSS_FUN explicit btree_map_iterator(MAP_T &map,
+                                                    btree_node *leaf, size_t i)
+      : map_(&map), leaf_(leaf), i_(i) {}
+
+  /** Get the pointed entry */
+  HSHM_INLINE_CROSS_FUN ENTRY_T operator*() const {
+    return ENTRY_T{GetKey(), GetVal()};
+  }
+
+  /** Get the pointed key */
+  HSHM_INLINE_CROSS_FUN const Key &GetKey() const {
+    return MAP_T::Keys(leaf_)[i_].get_ref();
+  }
+
+  /** Get the pointed value */
+  HSHM_INLINE_CROSS_FUN T &GetVal() const {
+    return MAP_T::Vals(leaf_)[i_].get_ref();
+  }
+
+  /** Go to the next entry */
+  HSHM_INLINE_CROSS_FUN btree_map_iterator &operator++() {
+    ++i_;
+    make_correct();
+    return *this;
+  }
+
+  /** Return the next iterator */
+  HSHM_INLINE_CROSS_FUN btree_map_iterator operator++(int) const {
+    btree_map_iterator next(*this);
+    ++next;
+    return next;
+  }
+
+  /** Move past the end of a leaf to the start of the next one */
+  HSHM_INLINE_CROSS_FUN void make_correct() {
+    if (leaf_ && i_ >= leaf_->count_) {
+      leaf_ = map_->GetNextLeaf(leaf_);
+      i_ = 0;
+    }
+  }
+
+  /** Check if two iterators are equal */
+  HSHM_INLINE_CROSS_FUN friend bool operator==(const btree_map_iterator &a,
+                                               const btree_map_iterator &b) {
+    return a.leaf_ == b.leaf_ && a.i_ == b.i_;
+  }
+
+  /** Check if two iterators are inequal */
+  HSHM_INLINE_CROSS_FUN friend bool operator!=(const btree_map_iterator &a,
+                                               const btree_map_iterator &b) {
+    return !(a == b);
+  }
+
+  /** Determine whether this iterator is the end iterator */
+  HSHM_INLINE_CROSS_FUN bool is_end() const { return leaf_ == nullptr; }
+
+  /** Set this iterator to the end iterator */
+  HSHM_INLINE_CROSS_FUN void set_end() {
+    leaf_ = nullptr;
+    i_ = 0;
+  }
+};
+
+/** A [begin, end) range of a btree_map, usable in a range-based for */
+template <typename IterT>
+struct btree_map_range {
+  IterT begin_;
+  IterT end_;
+
+  /** The first entry of the range */
+  HSHM_INLINE_CROSS_FUN IterT begin() const { return begin_; }
+
+  /** One past the last entry of the range */
+  HSHM_INLINE_CROSS_FUN IterT end() const { return end_; }
+};
+
+/**
+ * MACROS to simplify the btree_map namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+
+#define CLASS_NAME btree_map
+#define CLASS_NEW_ARGS Key, T, Compare
+
+/**
+ * An ordered map stored as a B+-tree in shared memory. Nodes are a few
+ * cache lines wide and keep their keys contiguous, so a lookup scans a
+ * handful of cache lines per level. Entries live only in the leaves,
+ * which are chained in key order for range scans. Nodes split on the way
+ * down during inserts and borrow from or merge with a sibling when
+ * erasing leaves them under half full.
+ *
+ * Inserting or erasing invalidates iterators.
+ * */
+template <typename Key, typename T, class Compare, HSHM_CLASS_TEMPL>
+class btree_map : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  HSHM_TRIVIALLY_RELOCATABLE
+
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef btree_map_iterator<Key, T, Compare, HSHM_CLASS_TEMPL_ARGS>
+      iterator_t;
+  friend iterator_t;
+  typedef btree_map_range<iterator_t> range_t;
+
+  /** The target size of a node in bytes */
+  static constexpr size_t kNodeBytes = 4 * HSHM_CACHE_LINE_SIZE;
+  /** The fewest keys a node holds, however large Key and T are */
+  static constexpr size_t kMinSlots = 4;
+  /** The deepest tree the map supports */
+  static constexpr size_t kMaxHeight = 32;
+
+ private:
+  /** Node layout: the header, the keys, then the values or children */
+  static constexpr size_t kKeysOff =
+      btree_align_up(sizeof(btree_node), alignof(Key));
+  static constexpr size_t kLeafSlots = btree_max(
+      kMinSlots, (kNodeBytes - kKeysOff) / (sizeof(Key) + sizeof(T)));
+  static constexpr size_t kValsOff =
+      btree_align_up(kKeysOff + kLeafSlots * sizeof(Key), alignof(T));
+  static constexpr size_t kLeafBytes = kValsOff + kLeafSlots * sizeof(T);
+  static constexpr size_t kInnerSlots =
+      btree_max(kMinSlots, (kNodeBytes - kKeysOff - sizeof(OffsetPointer)) /
+                               (sizeof(Key) + sizeof(OffsetPointer)));
+  static constexpr size_t kChildrenOff = btree_align_up(
+      kKeysOff + kInnerSlots * sizeof(Key), alignof(OffsetPointer));
+  static constexpr size_t kInnerBytes =
+      kChildrenOff + (kInnerSlots + 1) * sizeof(OffsetPointer);
+  static constexpr size_t kMinLeaf = kLeafSlots / 2;
+  static constexpr size_t kMinInner = (kInnerSlots - 1) / 2;
+  /** Arithmetic keys are counted branch-free, which vectorizes */
+  static constexpr bool kLinearSearch =
+      std::is_arithmetic_v<Key> && std::is_same_v<Compare, std::less<Key>>;
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  OffsetPointer root_;  /**< The root node */
+  OffsetPointer first_; /**< The leftmost leaf */
+  hshm::size_t length_;
+  hshm::u32 height_; /**< The number of levels, 0 when empty */
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** SHM constructor. */
+  HSHM_CROSS_FUN
+  explicit btree_map() {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>());
+  }
+
+  /** SHM constructor. */
+  HSHM_CROSS_FUN
+  explicit btree_map(const hipc::CtxAllocator<AllocT> &alloc) {
+    shm_init(alloc);
+  }
+
+  /** SHM constructor. */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc) {
+    init_shm_container(alloc);
+    SetNull();
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Copy constructor */
+  HSHM_CROSS_FUN
+  explicit btree_map(const btree_map &other) {
+    init_shm_container(other.GetCtxAllocator());
+    SetNull();
+    shm_strong_copy_op(other);
+  }
+
+  /** SHM copy constructor */
+  HSHM_CROSS_FUN
+  explicit btree_map(const hipc::CtxAllocator<AllocT> &alloc,
+                     const btree_map &other) {
+    init_shm_container(alloc);
+    SetNull();
+    shm_strong_copy_op(other);
+  }
+
+  /** SHM copy assignment operator */
+  HSHM_CROSS_FUN
+  btree_map &operator=(const btree_map &other) {
+    if (this != &other) {
+      shm_destroy();
+      shm_strong_copy_op(other);
+    }
+    return *this;
+  }
+
+  /** Internal copy operation. Rebuilds the tree with full nodes. */
+  HSHM_CROSS_FUN
+  void shm_strong_copy_op(const btree_map &other) {
+    BuildSorted(other.begin(), other.size());
+  }
+
+  /**====================================
+   * Move Constructors
+   * ===================================*/
+
+  /** Move constructor. */
+  HSHM_INLINE_CROSS_FUN btree_map(btree_map &&other) noexcept {
+    shm_move_op<false>(other.GetCtxAllocator(), std::move(other));
+  }
+
+  /** SHM move constructor. */
+  HSHM_INLINE_CROSS_FUN btree_map(const hipc::CtxAllocator<AllocT> &alloc,
+                                  btree_map &&other) noexcept {
+    shm_move_op<false>(alloc, std::move(other));
+  }
+
+  /** SHM move assignment operator. */
+  HSHM_CROSS_FUN
+  btree_map &operator=(btree_map &&other) noexcept {
+    if (this != &other) {
+      shm_move_op<true>(GetCtxAllocator(), std::move(other));
+    }
+    return *this;
+  }
+
+  /** SHM move operator. */
+  template <bool IS_ASSIGN>
+  HSHM_CROSS_FUN void shm_move_op(const hipc::CtxAllocator<AllocT> &alloc,
+                                  btree_map &&other) noexcept {
+    if constexpr (!IS_ASSIGN) {
+      init_shm_container(alloc);
+      SetNull();
+    } else {
+      shm_destroy();
+    }
+    if (GetAllocator() == other.GetAllocator()) {
+      root_ = other.root_;
+      first_ = other.first_;
+      length_ = other.length_;
+      height_ = other.height_;
+      other.SetNull();
+    } else {
+      shm_strong_copy_op(other);
+      other.shm_destroy();
+    }
+  }
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** Check if the map has no nodes */
+  HSHM_INLINE_CROSS_FUN bool IsNull() const { return root_.IsNull(); }
+
+  /** Sets this map as empty */
+  HSHM_INLINE_CROSS_FUN void SetNull() {
+    root_.SetNull();
+    first_.SetNull();
+    length_ = 0;
+    height_ = 0;
+  }
+
+  /** Destroy the entries and free the nodes */
+  HSHM_CROSS_FUN void shm_destroy_main() {
+    DestroyNode(root_);
+    SetNull();
+  }
+
+  /**====================================
+   * Emplace Methods
+   * ===================================*/
+
+  /**
+   * Construct an object directly in the map. Overrides the object if
+   * key already exists.
+   *
+   * @param key the key to future index the map
+   * @param args the arguments to construct the object
+   * @return true
+   * */
+  template <typename... Args>
+  HSHM_CROSS_FUN bool emplace(const Key &key, Args &&...args) {
+    return emplace_templ<true>(key, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Construct an object directly in the map. Does not modify the key
+   * if it already exists.
+   *
+   * @param key the key to future index the map
+   * @param args the arguments to construct the object
+   * @return whether the object was inserted
+   * */
+  template <typename... Args>
+  HSHM_CROSS_FUN bool try_emplace(const Key &key, Args &&...args) {
+    return emplace_templ<false>(key, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Replace the contents of the map with the entries in [first, last).
+   * Entries are pairs whose first is a Key (e.g., std::pair<Key, T>).
+   * If the keys are strictly increasing, the tree is built bottom-up
+   * with full nodes in one pass. Otherwise, the entries are emplaced
+   * one at a time.
+   * */
+  template <typename Iter>
+  HSHM_CROSS_FUN void bulk_load(Iter first, Iter last) {
+    clear();
+    size_t count = 0;
+    bool sorted = true;
+    for (Iter prev = first, it = first; it != last; prev = it, ++it) {
+      if (count++ > 0 && !Less((*prev).first, (*it).first)) {
+        sorted = false;
+      }
+    }
+    if (sorted) {
+      BuildSorted(first, count);
+      return;
+    }
+    for (Iter it = first; it != last; ++it) {
+      emplace((*it).first, (*it).second);
+    }
+  }
+
+ private:
+  /**
+   * Insert (key, value), optionally replacing an existing entry. Full
+   * nodes are split on the way down, so the leaf always has room.
+   * */
+  template <bool modify_existing, typename... Args>
+  HSHM_CROSS_FUN bool emplace_templ(const Key &key, Args &&...args) {
+    if (IsNull()) {
+      FullPtr<btree_node, OffsetPointer> leaf = AllocateNode(true);
+      root_ = leaf.shm_;
+      first_ = leaf.shm_;
+      height_ = 1;
+    }
+    btree_node *node = GetNode(root_);
+    if (IsFull(node)) {
+      FullPtr<btree_node, OffsetPointer> root = AllocateNode(false);
+      Children(root.ptr_)[0] = root_;
+      SplitChild(root.ptr_, 0);
+      root_ = root.shm_;
+      ++height_;
+      node = root.ptr_;
+    }
+    while (!node->is_leaf_) {
+      size_t ci = UpperBound(node, key);
+      btree_node *child = GetChild(node, ci);
+      if (IsFull(child)) {
+        SplitChild(node, ci);
+        if (!Less(key, Keys(node)[ci].get_ref())) {
+          ++ci;
+        }
+        child = GetChild(node, ci);
+      }
+      node = child;
+    }
+
+    // Insert into the leaf
+    size_t i = LowerBound(node, key);
+    delay_ar<T> *vals = Vals(node);
+    if (i < node->count_ && !Less(key, Keys(node)[i].get_ref())) {
+      if constexpr (!modify_existing) {
+        return false;
+      } else {
+        HSHM_DESTROY_AR(vals[i])
+        HSHM_MAKE_AR(vals[i], GetCtxAllocator(), std::forward<Args>(args)...)
+        return true;
+      }
+    }
+    MoveSlots(Keys(node) + i + 1, Keys(node) + i, node->count_ - i);
+    MoveSlots(vals + i + 1, vals + i, node->count_ - i);
+    HSHM_MAKE_AR(Keys(node)[i], GetCtxAllocator(), key)
+    HSHM_MAKE_AR(vals[i], GetCtxAllocator(), std::forward<Args>(args)...)
+    ++node->count_;
+    ++length_;
+    return true;
+  }
+
+ public:
+  /**====================================
+   * Erase Methods
+   * ===================================*/
+
+  /** Erase the object indexable by \a key */
+  HSHM_CROSS_FUN
+  void erase(const Key &key) {
+    if (IsNull()) {
+      return;
+    }
+    btree_node *path[kMaxHeight];
+    size_t path_idx[kMaxHeight];
+    size_t depth = 0;
+    btree_node *node = GetNode(root_);
+    while (!node->is_leaf_) {
+      size_t ci = UpperBound(node, key);
+      path[depth] = node;
+      path_idx[depth] = ci;
+      ++depth;
+      node = GetChild(node, ci);
+    }
+    size_t i = LowerBound(node, key);
+    if (i == node->count_ || Less(key, Keys(node)[i].get_ref())) {
+      return;
+    }
+    EraseSlot(node, i);
+    Rebalance(path, path_idx, depth, node);
+  }
+
+  /** Erase the object at the iterator */
+  HSHM_CROSS_FUN
+  void erase(iterator_t &iter) {
+    if (iter.is_end()) return;
+    erase(iter.GetKey());
+  }
+
+  /** Erase the entire map */
+  HSHM_CROSS_FUN void clear() { shm_destroy_main(); }
+
+  /**====================================
+   * Index Methods
+   * ===================================*/
+
+  /**
+   * Locate an entry in the btree_map
+   *
+   * @return the object pointed by key
+   * @exception UNORDERED_MAP_CANT_FIND the key was not in the map
+   * */
+  HSHM_INLINE_CROSS_FUN T &operator[](const Key &key) {
+    auto iter = find(key);
+    if (!iter.is_end()) {
+      return iter.GetVal();
+    }
+    HSHM_THROW_ERROR(UNORDERED_MAP_CANT_FIND);
+  }
+
+  /** Find an object in the btree_map */
+  HSHM_CROSS_FUN
+  iterator_t find(const Key &key) const {
+    iterator_t iter = lower_bound(key);
+    if (!iter.is_end() && Less(key, iter.GetKey())) {
+      iter.set_end();
+    }
+    return iter;
+  }
+
+  /** Check whether \a key is in the map */
+  HSHM_INLINE_CROSS_FUN
+  bool contains(const Key &key) const { return !find(key).is_end(); }
+
+  /** The first entry whose key is not less than \a key */
+  HSHM_CROSS_FUN
+  iterator_t lower_bound(const Key &key) const {
+    btree_node *leaf = FindLeaf(key);
+    return MakeIterator(leaf, leaf ? LowerBound(leaf, key) : 0);
+  }
+
+  /** The first entry whose key is greater than \a key */
+  HSHM_CROSS_FUN
+  iterator_t upper_bound(const Key &key) const {
+    btree_node *leaf = FindLeaf(key);
+    return MakeIterator(leaf, leaf ? UpperBound(leaf, key) : 0);
+  }
+
+  /** The entries whose keys are in [\a lo, \a hi) */
+  HSHM_CROSS_FUN
+  range_t range(const Key &lo, const Key &hi) const {
+    iterator_t begin = lower_bound(lo);
+    if (!Less(lo, hi)) {
+      return range_t{begin, begin};
+    }
+    return range_t{begin, lower_bound(hi)};
+  }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** The number of entries in the map */
+  HSHM_INLINE_CROSS_FUN size_t size() const { return length_; }
+
+  /** The number of levels in the tree */
+  HSHM_INLINE_CROSS_FUN size_t height() const { return height_; }
+
+  /**====================================
+   * Iterators
+   * ===================================*/
+
+  /** Forward iterator begin */
+  HSHM_INLINE_CROSS_FUN iterator_t begin() const {
+    if (length_ == 0) {
+      return end();
+    }
+    return iterator_t(const_cast<btree_map &>(*this), GetNode(first_), 0);
+  }
+
+  /** Forward iterator end */
+  HSHM_INLINE_CROSS_FUN iterator_t end() const {
+    return iterator_t(const_cast<btree_map &>(*this), nullptr, 0);
+  }
+
+ private:
+  /**====================================
+   * Node Helpers
+   * ===================================*/
+
+  /** Compare two keys */
+  HSHM_INLINE_CROSS_FUN static bool Less(const Key &a, const Key &b) {
+    return Compare{}(a, b);
+  }
+
+  /** The keys of \a node */
+  HSHM_INLINE_CROSS_FUN static delay_ar<Key> *Keys(btree_node *node) {
+    return reinterpret_cast<delay_ar<Key> *>(reinterpret_cast<char *>(node) +
+                                             kKeysOff);
+  }
+
+  /** The values of the leaf \a node */
+  HSHM_INLINE_CROSS_FUN static delay_ar<T> *Vals(btree_node *node) {
+    return reinterpret_cast<delay_ar<T> *>(reinterpret_cast<char *>(node) +
+                                           kValsOff);
+  }
+
+  /** The children of the inner \a node */
+  HSHM_INLINE_CROSS_FUN static OffsetPointer *Children(btree_node *node) {
+    return reinterpret_cast<OffsetPointer *>(reinterpret_cast<char *>(node) +
+                                             kChildrenOff);
+  }
+
+  /** Convert an offset to a node */
+  HSHM_INLINE_CROSS_FUN btree_node *GetNode(const OffsetPointer &p) const {
+    return GetAllocator()->template Convert<btree_node>(p);
+  }
+
+  /** Child \a i of the inner \a node */
+  HSHM_INLINE_CROSS_FUN btree_node *GetChild(btree_node *node,
+                                             size_t i) const {
+    return GetNode(Children(node)[i]);
+  }
+
+  /** The leaf after \a leaf, or nullptr */
+  HSHM_INLINE_CROSS_FUN btree_node *GetNextLeaf(btree_node *leaf) const {
+    return leaf->next_.IsNull() ? nullptr : GetNode(leaf->next_);
+  }
+
+  /** Whether \a node has no room for another key */
+  HSHM_INLINE_CROSS_FUN static bool IsFull(btree_node *node) {
+    return node->count_ == (node->is_leaf_ ? kLeafSlots : kInnerSlots);
+  }
+
+  /** Allocate an empty node */
+  HSHM_CROSS_FUN
+  FullPtr<btree_node, OffsetPointer> AllocateNode(bool is_leaf) {
+    FullPtr<btree_node, OffsetPointer> p =
+        GetAllocator()->template AllocateLocalPtr<btree_node, OffsetPointer>(
+            GetMemCtx(), is_leaf ? kLeafBytes : kInnerBytes);
+    p.ptr_->count_ = 0;
+    p.ptr_->is_leaf_ = is_leaf;
+    p.ptr_->next_.SetNull();
+    return p;
+  }
+
+  /** Free a node without destroying its contents */
+  HSHM_INLINE_CROSS_FUN void FreeNode(OffsetPointer p) {
+    GetAllocator()->template Free<OffsetPointer>(GetMemCtx(), p);
+  }
+
+  /** Destroy the entries under \a p and free its nodes */
+  HSHM_CROSS_FUN
+  void DestroyNode(const OffsetPointer &p) {
+    if (p.IsNull()) {
+      return;
+    }
+    btree_node *node = GetNode(p);
+    delay_ar<Key> *keys = Keys(node);
+    for (size_t i = 0; i < node->count_; ++i) {
+      HSHM_DESTROY_AR(keys[i])
+    }
+    if (node->is_leaf_) {
+      delay_ar<T> *vals = Vals(node);
+      for (size_t i = 0; i < node->count_; ++i) {
+        HSHM_DESTROY_AR(vals[i])
+      }
+    } else {
+      for (size_t i = 0; i <= node->count_; ++i) {
+        DestroyNode(Children(node)[i]);
+      }
+    }
+    FreeNode(p);
+  }
+
+  /** The index of the first key in \a node not less than \a key */
+  HSHM_INLINE_CROSS_FUN static size_t LowerBound(btree_node *node,
+                                                 const Key &key) {
+    delay_ar<Key> *keys = Keys(node);
+    size_t count = node->count_;
+    if constexpr (kLinearSearch) {
+      size_t i = 0;
+      for (size_t j = 0; j < count; ++j) {
+        i += keys[j].get_ref() < key;
+      }
+      return i;
+    } else {
+      size_t lo = 0;
+      while (count > 0) {
+        size_t half = count / 2;
+        if (Less(keys[lo + half].get_ref(), key)) {
+          lo += half + 1;
+          count -= half + 1;
+        } else {
+          count = half;
+        }
+      }
+      return lo;
+    }
+  }
+
+  /** The index of the first key in \a node greater than \a key */
+  HSHM_INLINE_CROSS_FUN static size_t UpperBound(btree_node *node,
+                                                 const Key &key) {
+    delay_ar<Key> *keys = Keys(node);
+    size_t count = node->count_;
+    if constexpr (kLinearSearch) {
+      size_t i = 0;
+      for (size_t j = 0; j < count; ++j) {
+        i += !(key < keys[j].get_ref());
+      }
+      return i;
+    } else {
+      size_t lo = 0;
+      while (count > 0) {
+        size_t half = count / 2;
+        if (!Less(key, keys[lo + half].get_ref())) {
+          lo += half + 1;
+          count -= half + 1;
+        } else {
+          count = half;
+        }
+      }
+      return lo;
+    }
+  }
+
+  /** The leaf \a key belongs in, or nullptr if the map is empty */
+  HSHM_CROSS_FUN
+  btree_node *FindLeaf(const Key &key) const {
+    if (IsNull()) {
+      return nullptr;
+    }
+    btree_node *node = GetNode(root_);
+    while (!node->is_leaf_) {
+      node = GetChild(node, UpperBound(node, key));
+    }
+    return node;
+  }
+
+  /** An iterator at slot \a i of \a leaf, moved past a leaf's end */
+  HSHM_INLINE_CROSS_FUN iterator_t MakeIterator(btree_node *leaf,
+                                                size_t i) const {
+    iterator_t iter(const_cast<btree_map &>(*this), leaf, i);
+    iter.make_correct();
+    return iter;
+  }
+
+  /**
+   * Move the \a count constructed slots at \a src to the unconstructed
+   * slots at \a dst. The ranges may overlap.
+   * */
+  template <typename U>
+  HSHM_INLINE_CROSS_FUN void MoveSlots(delay_ar<U> *dst, delay_ar<U> *src,
+                                       size_t count) {
+    if (count == 0 || dst == src) {
+      return;
+    }
+    if constexpr (std::is_trivially_copyable_v<U>) {
+      memmove((void *)dst, (void *)src, count * sizeof(U));
+    } else if (dst < src) {
+      for (size_t i = 0; i < count; ++i) {
+        HSHM_MAKE_AR(dst[i], GetCtxAllocator(), std::move(src[i].get_ref()))
+        HSHM_DESTROY_AR(src[i])
+      }
+    } else {
+      for (size_t i = count; i-- > 0;) {
+        HSHM_MAKE_AR(dst[i], GetCtxAllocator(), std::move(src[i].get_ref()))
+        HSHM_DESTROY_AR(src[i])
+      }
+    }
+  }
+
+  /** Replace the constructed key \a dst with a copy of \a key */
+  HSHM_INLINE_CROSS_FUN void CopyKey(delay_ar<Key> &dst, const Key &key) {
+    HSHM_DESTROY_AR(dst)
+    HSHM_MAKE_AR(dst, GetCtxAllocator(), key)
+  }
+
+  /** Children are offsets, so they are moved with memmove */
+  HSHM_INLINE_CROSS_FUN static void MoveChildren(OffsetPointer *dst,
+                                                 OffsetPointer *src,
+                                                 size_t count) {
+    memmove((void *)dst, (void *)src, count * sizeof(OffsetPointer));
+  }
+
+  /**====================================
+   * Insert Helpers
+   * ===================================*/
+
+  /**
+   * Split the full child \a ci of \a parent in two halves and insert the
+   * separator into \a parent, which is not full. A leaf keeps a copy of
+   * the separator, an inner node moves it up.
+   * */
+  HSHM_CROSS_FUN
+  void SplitChild(btree_node *parent, size_t ci) {
+    btree_node *child = GetChild(parent, ci);
+    FullPtr<btree_node, OffsetPointer> right = AllocateNode(child->is_leaf_);
+    delay_ar<Key> *pkeys = Keys(parent);
+    OffsetPointer *pchildren = Children(parent);
+    MoveSlots(pkeys + ci + 1, pkeys + ci, parent->count_ - ci);
+    MoveChildren(pchildren + ci + 2, pchildren + ci + 1, parent->count_ - ci);
+    pchildren[ci + 1] = right.shm_;
+    ++parent->count_;
+
+    size_t count = child->count_;
+    size_t mid = count / 2;
+    if (child->is_leaf_) {
+      MoveSlots(Keys(right.ptr_), Keys(child) + mid, count - mid);
+      MoveSlots(Vals(right.ptr_), Vals(child) + mid, count - mid);
+      right.ptr_->count_ = count - mid;
+      right.ptr_->next_ = child->next_;
+      child->next_ = right.shm_;
+      child->count_ = mid;
+      HSHM_MAKE_AR(pkeys[ci], GetCtxAllocator(),
+                   Keys(right.ptr_)[0].get_ref())
+    } else {
+      MoveSlots(Keys(right.ptr_), Keys(child) + mid + 1, count - mid - 1);
+      MoveChildren(Children(right.ptr_), Children(child) + mid + 1,
+                   count - mid);
+      right.ptr_->count_ = count - mid - 1;
+      child->count_ = mid;
+      MoveSlots(pkeys + ci, Keys(child) + mid, 1);
+    }
+  }
+
+  /**
+   * Build the tree bottom-up from \a count entries in strictly
+   * increasing key order. The entries are spread evenly over as few
+   * nodes as possible, so every node is at least half full.
+   * */
+  template <typename Iter>
+  HSHM_CROSS_FUN void BuildSorted(Iter it, size_t count) {
+    clear();
+    if (count == 0) {
+      return;
+    }
+
+    // Fill the leaves and chain them in order
+    size_t nnodes = (count + kLeafSlots - 1) / kLeafSlots;
+    btree_node *prev = nullptr;
+    for (size_t n = 0; n < nnodes; ++n) {
+      FullPtr<btree_node, OffsetPointer> leaf = AllocateNode(true);
+      size_t nkeys = count / nnodes + (n < count % nnodes);
+      for (size_t i = 0; i < nkeys; ++i, ++it) {
+        HSHM_MAKE_AR(Keys(leaf.ptr_)[i], GetCtxAllocator(), (*it).first)
+        HSHM_MAKE_AR(Vals(leaf.ptr_)[i], GetCtxAllocator(), (*it).second)
+      }
+      leaf.ptr_->count_ = nkeys;
+      if (prev) {
+        prev->next_ = leaf.shm_;
+      } else {
+        first_ = leaf.shm_;
+      }
+      prev = leaf.ptr_;
+    }
+    root_ = first_;
+    height_ = 1;
+    length_ = count;
+
+    // Build each inner level over the one below, using next_ as a
+    // temporary chain for inner nodes
+    while (nnodes > 1) {
+      size_t nchildren = nnodes;
+      nnodes = (nchildren + kInnerSlots) / (kInnerSlots + 1);
+      OffsetPointer child = root_;
+      prev = nullptr;
+      for (size_t n = 0; n < nnodes; ++n) {
+        FullPtr<btree_node, OffsetPointer> inner = AllocateNode(false);
+        size_t nkids = nchildren / nnodes + (n < nchildren % nnodes);
+        for (size_t i = 0; i < nkids; ++i) {
+          btree_node *child_node = GetNode(child);
+          Children(inner.ptr_)[i] = child;
+          if (i > 0) {
+            HSHM_MAKE_AR(Keys(inner.ptr_)[i - 1], GetCtxAllocator(),
+                         MinKey(child_node))
+          }
+          child = child_node->next_;
+          if (!child_node->is_leaf_) {
+            child_node->next_.SetNull();
+          }
+        }
+        inner.ptr_->count_ = nkids - 1;
+        if (prev) {
+          prev->next_ = inner.shm_;
+        } else {
+          root_ = inner.shm_;
+        }
+        prev = inner.ptr_;
+      }
+      ++height_;
+    }
+  }
+
+  /** The smallest key under \a node */
+  HSHM_INLINE_CROSS_FUN const Key &MinKey(btree_node *node) const {
+    while (!node->is_leaf_) {
+      node = GetChild(node, 0);
+    }
+    return Keys(node)[0].get_ref();
+  }
+
+  /**====================================
+   * Erase Helpers
+   * ===================================*/
+
+  /** Destroy slot \a i of the leaf \a node and close the gap */
+  HSHM_CROSS_FUN
+  void EraseSlot(btree_node *node, size_t i) {
+    delay_ar<Key> *keys = Keys(node);
+    delay_ar<T> *vals = Vals(node);
+    HSHM_DESTROY_AR(keys[i])
+    HSHM_DESTROY_AR(vals[i])
+    MoveSlots(keys + i, keys + i + 1, node->count_ - i - 1);
+    MoveSlots(vals + i, vals + i + 1, node->count_ - i - 1);
+    --node->count_;
+    --length_;
+  }
+
+  /**
+   * Restore the minimum fill of \a node, the child path_idx[depth - 1]
+   * of path[depth - 1], and then of each ancestor a merge shrank.
+   * */
+  HSHM_CROSS_FUN
+  void Rebalance(btree_node **path, size_t *path_idx, size_t depth,
+                 btree_node *node) {
+    for (; depth > 0; --depth) {
+      size_t min_keys = node->is_leaf_ ? kMinLeaf : kMinInner;
+      if (node->count_ >= min_keys) {
+        return;
+      }
+      btree_node *parent = path[depth - 1];
+      size_t ci = path_idx[depth - 1];
+      if (ci > 0 && GetChild(parent, ci - 1)->count_ > min_keys) {
+        BorrowLeft(parent, ci);
+        return;
+      }
+      if (ci < parent->count_ && GetChild(parent, ci + 1)->count_ > min_keys) {
+        BorrowRight(parent, ci);
+        return;
+      }
+      Merge(parent, ci > 0 ? ci - 1 : ci);
+      node = parent;
+    }
+
+    // Shrink the root
+    if (node->count_ > 0) {
+      return;
+    }
+    OffsetPointer old_root = root_;
+    if (node->is_leaf_) {
+      SetNull();
+    } else {
+      root_ = Children(node)[0];
+      --height_;
+    }
+    FreeNode(old_root);
+  }
+
+  /** Move the last entry of child \a ci - 1 to the front of child \a ci */
+  HSHM_CROSS_FUN
+  void BorrowLeft(btree_node *parent, size_t ci) {
+    btree_node *left = GetChild(parent, ci - 1);
+    btree_node *node = GetChild(parent, ci);
+    delay_ar<Key> *keys = Keys(node);
+    delay_ar<Key> *sep = Keys(parent) + ci - 1;
+    size_t last = left->count_ - 1;
+    MoveSlots(keys + 1, keys, node->count_);
+    if (node->is_leaf_) {
+      MoveSlots(Vals(node) + 1, Vals(node), node->count_);
+      MoveSlots(keys, Keys(left) + last, 1);
+      MoveSlots(Vals(node), Vals(left) + last, 1);
+      CopyKey(*sep, keys[0].get_ref());
+    } else {
+      OffsetPointer *children = Children(node);
+      MoveChildren(children + 1, children, node->count_ + 1);
+      MoveSlots(keys, sep, 1);
+      children[0] = Children(left)[last + 1];
+      MoveSlots(sep, Keys(left) + last, 1);
+    }
+    --left->count_;
+    ++node->count_;
+  }
+
+  /** Move the first entry of child \a ci + 1 to the end of child \a ci */
+  HSHM_CROSS_FUN
+  void BorrowRight(btree_node *parent, size_t ci) {
+    btree_node *node = GetChild(parent, ci);
+    btree_node *right = GetChild(parent, ci + 1);
+    delay_ar<Key> *rkeys = Keys(right);
+    delay_ar<Key> *sep = Keys(parent) + ci;
+    size_t end = node->count_;
+    if (node->is_leaf_) {
+      MoveSlots(Keys(node) + end, rkeys, 1);
+      MoveSlots(Vals(node) + end, Vals(right), 1);
+      MoveSlots(rkeys, rkeys + 1, right->count_ - 1);
+      MoveSlots(Vals(right), Vals(right) + 1, right->count_ - 1);
+      CopyKey(*sep, rkeys[0].get_ref());
+    } else {
+      OffsetPointer *rchildren = Children(right);
+      MoveSlots(Keys(node) + end, sep, 1);
+      Children(node)[end + 1] = rchildren[0];
+      MoveSlots(sep, rkeys, 1);
+      MoveSlots(rkeys, rkeys + 1, right->count_ - 1);
+      MoveChildren(rchildren, rchildren + 1, right->count_);
+    }
+    ++node->count_;
+    --right->count_;
+  }
+
+  /**
+   * Append child \a i + 1 of \a parent to child \a i, remove separator
+   * \a i from \a parent, and free the emptied node
+   * */
+  HSHM_CROSS_FUN
+  void Merge(btree_node *parent, size_t i) {
+    btree_node *left = GetChild(parent, i);
+    OffsetPointer right_p = Children(parent)[i + 1];
+    btree_node *right = GetNode(right_p);
+    delay_ar<Key> *pkeys = Keys(parent);
+    size_t end = left->count_;
+    if (left->is_leaf_) {
+      MoveSlots(Keys(left) + end, Keys(right), right->count_);
+      MoveSlots(Vals(left) + end, Vals(right), right->count_);
+      left->count_ += right->count_;
+      left->next_ = right->next_;
+      HSHM_DESTROY_AR(pkeys[i])
+    } else {
+      MoveSlots(Keys(left) + end, pkeys + i, 1);
+      MoveSlots(Keys(left) + end + 1, Keys(right), right->count_);
+      MoveChildren(Children(left) + end + 1, Children(right),
+                   right->count_ + 1);
+      left->count_ += right->count_ + 1;
+    }
+    MoveSlots(pkeys + i, pkeys + i + 1, parent->count_ - i - 1);
+    MoveChildren(Children(parent) + i + 1, Children(parent) + i + 2,
+                 parent->count_ - i - 1);
+    --parent->count_;
+    FreeNode(right_p);
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename Key, typename T, class Compare = std::less<Key>,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using btree_map = hipc::btree_map<Key, T, Compare, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_BTREE_MAP_H_
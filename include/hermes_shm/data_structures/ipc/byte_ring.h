@@ -0,0 +1,362 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_BYTE_RING_H_
+#define HSHM_DATA_STRUCTURES_IPC_BYTE_RING_H_
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/thread/thread_model_manager.h"
+#include "hermes_shm/types/numbers.h"
+#include "hermes_shm/types/qtok.h"
+#include "ring_queue.h"
+#include "ring_queue_flags.h"
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/** Header preceding each record of a byte_ring */
+struct byte_ring_header {
+  size_t size_;     /**< Payload bytes */
+  hshm::u32 flags_; /**< kPad if the record only fills the end of the ring */
+};
+
+/** A contiguous region of a byte_ring, valid until committed or released */
+struct byte_ring_span {
+  char *ptr_;    /**< The payload */
+  size_t size_;  /**< Payload bytes */
+  qtok_id pos_;  /**< Ring position of the record, including padding */
+  qtok_id next_; /**< Ring position following the record */
+
+  /** Null span */
+  HSHM_INLINE_CROSS_FUN
+  byte_ring_span() : ptr_(nullptr), size_(0), pos_(0), next_(0) {}
+
+  /** Whether the reservation or peek failed */
+  HSHM_INLINE_CROSS_FUN
+  bool IsNull() const { return ptr_ == nullptr; }
+
+  /** Get the payload */
+  HSHM_INLINE_CROSS_FUN
+  char *data() const { return ptr_; }
+
+  /** Get the payload size */
+  HSHM_INLINE_CROSS_FUN
+  size_t size() const { return size_; }
+};
+
+/** Forward declaration of byte_ring_base */
+template <RingQueueFlag RQ_FLAGS, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class byte_ring_base;
+
+/**
+ * MACROS used to simplify the byte_ring_base namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME byte_ring_base
+#define CLASS_NEW_ARGS RQ_FLAGS
+
+/**
+ * A ring of variable-length byte records (bip-buffer) for zero-copy
+ * messages with one consumer.
+ *
+ * A producer reserves a contiguous region, writes the payload in place
+ * and commits it. A reservation which would straddle the end of the ring
+ * first fills the end with a padding record and starts over at offset 0,
+ * so payloads are never split. Reservations advance tail_; commits
+ * advance commit_ in reservation order, so the consumer only reads whole
+ * records below commit_. The consumer peeks at the oldest record in
+ * place and releases it once done.
+ *
+ * With kPushAtomic, producers claim regions with a CAS on tail_. Since
+ * commits are published in reservation order, a producer stalled between
+ * reserve and commit holds back the commits of every later producer.
+ * With kWaitForSpace, reserve waits for the consumer instead of failing.
+ * */
+template <RingQueueFlag RQ_FLAGS, HSHM_CLASS_TEMPL>
+class byte_ring_base : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  RING_QUEUE_DEFS
+
+ public:
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef vector<char, HSHM_CLASS_TEMPL_ARGS> vector_t;
+
+  /** Record flags */
+  CLS_CONST hshm::u32 kPad = 1;
+  /** Records are aligned to the header */
+  CLS_CONST size_t kAlign = sizeof(byte_ring_header);
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<vector_t> buf_;
+  ring_queue_pad<true> pad0_;
+  hipc::atomic<qtok_id> tail_;
+  ring_queue_pad<true> pad1_;
+  hipc::atomic<qtok_id> commit_;
+  ring_queue_pad<true> pad2_;
+  hipc::atomic<qtok_id> head_;
+  ring_queue_pad<true> pad3_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit byte_ring_base(size_t size = 65536) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), size);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit byte_ring_base(const hipc::CtxAllocator<AllocT> &alloc,
+                          size_t size = 65536) {
+    shm_init(alloc, size);
+  }
+
+  /** SHM Constructor. The size is rounded up to a power of two. */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc, size_t size = 65536) {
+    init_shm_container(alloc);
+    if (size < 2 * kAlign) {
+      size = 2 * kAlign;
+    }
+    HSHM_MAKE_AR(buf_, GetCtxAllocator(), hshm::RoundUpPow2(size));
+    SetNull();
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Records are shared with concurrent threads; copying is disabled */
+  byte_ring_base(const byte_ring_base &other) = delete;
+
+  /** Records are shared with concurrent threads; copying is disabled */
+  byte_ring_base &operator=(const byte_ring_base &other) = delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor.  */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() { (*buf_).shm_destroy(); }
+
+  /** Check if the ring is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*buf_).IsNull(); }
+
+  /** Sets this ring as empty */
+  HSHM_CROSS_FUN
+  void SetNull() {
+    tail_ = 0;
+    commit_ = 0;
+    head_ = 0;
+  }
+
+  /**====================================
+   * Producer Methods
+   * ===================================*/
+
+  /**
+   * Reserve a contiguous region of \a size bytes. Null if the ring is
+   * full or \a size exceeds GetMaxRecordSize. The region must be
+   * committed.
+   * */
+  HSHM_CROSS_FUN
+  byte_ring_span reserve(size_t size) {
+    size_t cap = GetCapacity();
+    size_t need = RecordSize(size);
+    byte_ring_span span;
+    if (size > GetMaxRecordSize()) {
+      return span;
+    }
+    qtok_id pos = tail_.load(std::memory_order_relaxed);
+    size_t total;
+    while (true) {
+      size_t contig = cap - (size_t)(pos & (cap - 1));
+      total = need <= contig ? need : contig + need;
+      if (pos + total - head_.load(std::memory_order_acquire) > cap) {
+        if constexpr (!WaitForSpace) {
+          return span;
+        }
+        HSHM_THREAD_MODEL->Yield();
+        pos = tail_.load(std::memory_order_relaxed);
+        continue;
+      }
+      if constexpr (IsPushAtomic) {
+        if (tail_.compare_exchange_weak(pos, pos + total)) {
+          break;
+        }
+      } else {
+        tail_.store(pos + total, std::memory_order_relaxed);
+        break;
+      }
+    }
+
+    // Pad the end of the ring if the record does not fit before it
+    qtok_id rec = pos + total - need;
+    if (rec != pos) {
+      byte_ring_header *pad = GetHeader(pos);
+      pad->size_ = (size_t)(rec - pos - kAlign);
+      pad->flags_ = kPad;
+    }
+    byte_ring_header *hdr = GetHeader(rec);
+    hdr->size_ = size;
+    hdr->flags_ = 0;
+    span.ptr_ = reinterpret_cast<char *>(hdr + 1);
+    span.size_ = size;
+    span.pos_ = pos;
+    span.next_ = pos + total;
+    return span;
+  }
+
+  /**
+   * Publish a reserved region to the consumer. With kPushAtomic, this
+   * waits for all earlier reservations to be committed.
+   * */
+  HSHM_CROSS_FUN
+  void commit(const byte_ring_span &span) {
+    if constexpr (IsPushAtomic) {
+      // Records are published in reservation order
+      while (commit_.load(std::memory_order_acquire) != span.pos_) {
+        HSHM_THREAD_MODEL->Yield();
+      }
+    }
+    commit_.store(span.next_, std::memory_order_release);
+  }
+
+  /** Copy \a size bytes of \a data into a new record */
+  HSHM_CROSS_FUN
+  qtok_t emplace(const void *data, size_t size) {
+    byte_ring_span span = reserve(size);
+    if (span.IsNull()) {
+      return qtok_t::GetNull();
+    }
+    memcpy(span.ptr_, data, size);
+    commit(span);
+    return qtok_t(span.pos_);
+  }
+
+  /**====================================
+   * Consumer Methods
+   * ===================================*/
+
+  /** View the oldest committed record in place. Null if empty. */
+  HSHM_CROSS_FUN
+  byte_ring_span peek() {
+    byte_ring_span span;
+    qtok_id head = head_.load(std::memory_order_relaxed);
+    if (head == commit_.load(std::memory_order_acquire)) {
+      return span;
+    }
+    qtok_id rec = head;
+    byte_ring_header *hdr = GetHeader(rec);
+    if (hdr->flags_ & kPad) {
+      rec += kAlign + hdr->size_;
+      hdr = GetHeader(rec);
+    }
+    span.ptr_ = reinterpret_cast<char *>(hdr + 1);
+    span.size_ = hdr->size_;
+    span.pos_ = head;
+    span.next_ = rec + RecordSize(hdr->size_);
+    return span;
+  }
+
+  /** Release the record returned by peek, handing its space back */
+  HSHM_CROSS_FUN
+  void release(const byte_ring_span &span) {
+    head_.store(span.next_, std::memory_order_release);
+  }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** Get the number of bytes in the ring */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetCapacity() { return (*buf_).size(); }
+
+  /**
+   * Get the largest payload a single record can hold. Records use at most
+   * half of the ring, so that a record and the padding before it always
+   * fit in an empty ring.
+   * */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetMaxRecordSize() { return GetCapacity() / 2 - kAlign; }
+
+  /** Get the number of bytes reserved at this moment, including headers */
+  HSHM_CROSS_FUN
+  size_t GetSize() {
+    qtok_id tail = tail_.load();
+    qtok_id head = head_.load();
+    return tail > head ? (size_t)(tail - head) : 0;
+  }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t size() { return GetSize(); }
+
+ private:
+  /** Bytes used by a record with \a size bytes of payload */
+  HSHM_INLINE_CROSS_FUN
+  static size_t RecordSize(size_t size) {
+    return kAlign + ((size + kAlign - 1) & ~(kAlign - 1));
+  }
+
+  /** Get the header at ring position \a pos */
+  HSHM_INLINE_CROSS_FUN
+  byte_ring_header *GetHeader(qtok_id pos) {
+    char *base = reinterpret_cast<char *>((*buf_).data());
+    return reinterpret_cast<byte_ring_header *>(
+        base + (size_t)(pos & (GetCapacity() - 1)));
+  }
+};
+
+template <HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using spsc_byte_ring =
+    byte_ring_base<RING_BUFFER_FIXED_SPSC_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
+
+template <HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using mpsc_byte_ring =
+    byte_ring_base<RqFlag::kPushAtomic | RqFlag::kErrorOnNoSpace,
+                   HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <RingQueueFlag RQ_FLAGS, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using byte_ring_base = hipc::byte_ring_base<RQ_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
+
+template <HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using spsc_byte_ring =
+    hipc::byte_ring_base<RING_BUFFER_FIXED_SPSC_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
+
+template <HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using mpsc_byte_ring =
+    hipc::byte_ring_base<RqFlag::kPushAtomic | RqFlag::kErrorOnNoSpace,
+                         HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_BYTE_RING_H_
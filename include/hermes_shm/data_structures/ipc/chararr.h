@@ -184,6 +184,10 @@ class chararr_templ {
   bool operator op(const std::string &other) const {                       \
     return hshm::strncmp(data(), size(), other.data(), other.size()) op 0; \
   }                                                                        \
+  HSHM_HOST_FUN                                                            \
+  bool operator op(std::string_view other) const {                         \
+    return hshm::strncmp(data(), size(), other.data(), other.size()) op 0; \
+  }                                                                        \
   HSHM_CROSS_FUN                                                           \
   bool operator op(const chararr_templ &other) const {                     \
     return hshm::strncmp(data(), size(), other.data(), other.size()) op 0; \
@@ -222,15 +226,11 @@ struct hash<hshm::chararr_templ<LENGTH, WithNull>> {
 };
 }  // namespace std
 
-/** hshm::hash function for string */
+/** hshm::hash function for chararr. Transparent, like the string hash. */
 namespace hshm {
 template <int LENGTH, bool WithNull>
-struct hash<hshm::chararr_templ<LENGTH, WithNull>> {
-  HSHM_CROSS_FUN size_t
-  operator()(const hshm::chararr_templ<LENGTH, WithNull> &text) const {
-    return text.Hash();
-  }
-};
+struct hash<hshm::chararr_templ<LENGTH, WithNull>>
+    : public transparent_string_hash {};
 }  // namespace hshm
 
 #endif  // HSHM_SHM_INCLUDE_HSHM_SHM_DATA_STRUCTURES_CONTAINERS_chararr_templ_H_
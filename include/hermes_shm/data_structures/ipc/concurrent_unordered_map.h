@@ -0,0 +1,563 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_CONCURRENT_UNORDERED_MAP_H_
+#define HSHM_DATA_STRUCTURES_IPC_CONCURRENT_UNORDERED_MAP_H_
+
+#include <type_traits>
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/introspect/system_info.h"
+#include "hermes_shm/thread/lock/rwlock.h"
+#include "hermes_shm/types/numbers.h"
+#include "hash.h"
+#include "ring_queue.h"
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/** An entry of a concurrent_unordered_map bucket chain */
+template <typename Key, typename T>
+struct concurrent_map_node {
+  AtomicOffsetPointer next_; /**< The next node of the chain or free list */
+  hshm::size_t hash_;        /**< The full hash of the key */
+  delay_ar<Key> key_;
+  delay_ar<T> val_;
+};
+
+/** The head of a concurrent_unordered_map bucket chain */
+struct concurrent_map_bucket {
+  AtomicOffsetPointer head_;
+
+  /** Default constructor */
+  HSHM_INLINE_CROSS_FUN
+  concurrent_map_bucket() : head_(OffsetPointer::GetNull()) {}
+
+  /** Copy constructor */
+  HSHM_INLINE_CROSS_FUN
+  concurrent_map_bucket(const concurrent_map_bucket &other)
+      : head_(other.head_) {}
+};
+
+/** The locks guarding one stripe of concurrent_unordered_map buckets */
+struct concurrent_map_stripe {
+  RwLock lock_;
+  hipc::atomic<hshm::u64> seq_;      /**< Odd while a writer holds the lock */
+  hipc::atomic<hshm::size_t> size_;  /**< Entries in the stripe */
+  hipc::atomic<hshm::size_t> nodes_; /**< Nodes ever allocated */
+  OffsetPointer free_;               /**< Erased nodes kept for reuse */
+  ring_queue_pad<true> pad_;
+
+  /** Default constructor */
+  HSHM_INLINE_CROSS_FUN
+  concurrent_map_stripe()
+      : seq_(0), size_(0), nodes_(0), free_(OffsetPointer::GetNull()) {}
+
+  /** Copy constructor. Stripes are only copied when filling the vector. */
+  HSHM_INLINE_CROSS_FUN
+  concurrent_map_stripe(const concurrent_map_stripe &)
+      : seq_(0), size_(0), nodes_(0), free_(OffsetPointer::GetNull()) {}
+};
+
+/** Forward declaration of concurrent_unordered_map */
+template <typename Key, typename T, class Hash = hshm::hash<Key>,
+          HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class concurrent_unordered_map;
+
+/**
+ * MACROS used to simplify the concurrent_unordered_map namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME concurrent_unordered_map
+#define CLASS_NEW_ARGS Key, T, Hash
+
+/**
+ * A hash map which may be shared by many threads and processes. The
+ * buckets are chains of nodes and are grouped into stripes, each guarded
+ * by a RwLock and a sequence counter (seqlock). Writers lock the stripe
+ * of their key. When Key and T are trivially copyable, find() takes no
+ * lock: it walks the chain, copies the value out, and retries if a writer
+ * changed the stripe meanwhile. Readers of other types take the stripe's
+ * read lock instead.
+ *
+ * Erased nodes are kept on a per-stripe free list and reused by later
+ * inserts rather than freed, so a lock-free reader never touches freed
+ * memory. They are only freed when the map is destroyed. The number of
+ * buckets is fixed at construction (rounded up to a power of two).
+ * */
+template <typename Key, typename T, class Hash, HSHM_CLASS_TEMPL>
+class concurrent_unordered_map : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+
+ public:
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef concurrent_map_node<Key, T> node_t;
+  typedef vector<concurrent_map_bucket, HSHM_CLASS_TEMPL_ARGS> bucket_vector_t;
+  typedef vector<concurrent_map_stripe, HSHM_CLASS_TEMPL_ARGS> stripe_vector_t;
+  /** Whether find() may read entries without locking */
+  static constexpr bool kOptimistic =
+      std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>;
+  /** Lock-free find attempts before falling back to the read lock */
+  static constexpr int kOptimisticRetries = 16;
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<bucket_vector_t> buckets_;
+  delay_ar<stripe_vector_t> stripes_;
+  hshm::size_t bucket_mask_;
+  hshm::size_t stripe_mask_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit concurrent_unordered_map(size_t num_buckets = 1024,
+                                    size_t num_stripes = 0) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), num_buckets,
+             num_stripes);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit concurrent_unordered_map(const hipc::CtxAllocator<AllocT> &alloc,
+                                    size_t num_buckets = 1024,
+                                    size_t num_stripes = 0) {
+    shm_init(alloc, num_buckets, num_stripes);
+  }
+
+  /**
+   * SHM constructor.
+   *
+   * @param num_buckets the number of buckets, rounded up to a power of two
+   * @param num_stripes the number of locks, rounded up to a power of two
+   * and at most num_buckets. Defaults to four per CPU.
+   * */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc,
+                size_t num_buckets = 1024, size_t num_stripes = 0) {
+    init_shm_container(alloc);
+    num_buckets = hshm::RoundUpPow2(num_buckets ? num_buckets : 1);
+    if (num_stripes == 0) {
+      num_stripes = 4 * HSHM_SYSTEM_INFO->ncpu_;
+    }
+    num_stripes = hshm::RoundUpPow2(num_stripes);
+    if (num_stripes > num_buckets) {
+      num_stripes = num_buckets;
+    }
+    HSHM_MAKE_AR(buckets_, GetCtxAllocator(), num_buckets);
+    HSHM_MAKE_AR(stripes_, GetCtxAllocator(), num_stripes);
+    bucket_mask_ = num_buckets - 1;
+    stripe_mask_ = num_stripes - 1;
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Stripes are shared with concurrent workers; copying is disabled */
+  concurrent_unordered_map(const concurrent_unordered_map &other) = delete;
+
+  /** Stripes are shared with concurrent workers; copying is disabled */
+  concurrent_unordered_map &operator=(const concurrent_unordered_map &other) =
+      delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor. Frees every node, including recycled ones. */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    bucket_vector_t &buckets = *buckets_;
+    stripe_vector_t &stripes = *stripes_;
+    for (concurrent_map_bucket &bkt : buckets) {
+      OffsetPointer off = bkt.head_.ToOffsetPointer();
+      while (!off.IsNull()) {
+        node_t *node = GetNode(off);
+        OffsetPointer next = node->next_.ToOffsetPointer();
+        DestroyEntry(node);
+        GetAllocator()->Free(GetMemCtx(), off);
+        off = next;
+      }
+    }
+    for (concurrent_map_stripe &stripe : stripes) {
+      FreeNodes(stripe.free_);
+    }
+    buckets.shm_destroy();
+    stripes.shm_destroy();
+  }
+
+  /** Check if the map is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*buckets_).IsNull(); }
+
+  /** Sets this map as null */
+  HSHM_CROSS_FUN
+  void SetNull() {}
+
+  /**====================================
+   * Emplace Methods
+   * ===================================*/
+
+  /**
+   * Construct an entry in the map. Replaces the value if \a key already
+   * exists. Returns true if the key was new.
+   * */
+  template <typename... Args>
+  HSHM_CROSS_FUN bool emplace(const Key &key, Args &&...args) {
+    return emplace_templ<true>(key, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Construct an entry in the map. Does nothing and returns false if
+   * \a key already exists.
+   * */
+  template <typename... Args>
+  HSHM_CROSS_FUN bool try_emplace(const Key &key, Args &&...args) {
+    return emplace_templ<false>(key, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Apply \a fn to the value of \a key while holding the write lock of its
+   * stripe. Returns false if the key does not exist.
+   * */
+  template <typename F>
+  HSHM_CROSS_FUN bool update(const Key &key, F &&fn) {
+    size_t hash = Hash{}(key);
+    concurrent_map_stripe &stripe = GetStripe(hash);
+    WriteBegin(stripe);
+    node_t *node = FindNode(GetBucket(hash), hash, key);
+    if (node) {
+      fn(node->val_.get_ref());
+    }
+    WriteEnd(stripe);
+    return node != nullptr;
+  }
+
+  /**====================================
+   * Erase Methods
+   * ===================================*/
+
+  /** Erase \a key. Returns false if it did not exist. */
+  HSHM_CROSS_FUN
+  bool erase(const Key &key) {
+    size_t hash = Hash{}(key);
+    concurrent_map_stripe &stripe = GetStripe(hash);
+    concurrent_map_bucket &bkt = GetBucket(hash);
+    WriteBegin(stripe);
+    AtomicOffsetPointer *prev = &bkt.head_;
+    OffsetPointer off = prev->ToOffsetPointer();
+    while (!off.IsNull()) {
+      node_t *node = GetNode(off);
+      if (node->hash_ == hash && node->key_.get_ref() == key) {
+        prev->store(node->next_.load(), std::memory_order_release);
+        DestroyEntry(node);
+        // Recycled: a lock-free reader on this node may still follow it
+        node->next_.store(stripe.free_.load(), std::memory_order_release);
+        stripe.free_ = off;
+        stripe.size_.fetch_sub(1, std::memory_order_relaxed);
+        WriteEnd(stripe);
+        return true;
+      }
+      prev = &node->next_;
+      off = prev->ToOffsetPointer();
+    }
+    WriteEnd(stripe);
+    return false;
+  }
+
+  /** Erase every entry. Nodes are kept for reuse. */
+  HSHM_CROSS_FUN
+  void clear() {
+    bucket_vector_t &buckets = *buckets_;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      concurrent_map_stripe &stripe = (*stripes_)[i & stripe_mask_];
+      concurrent_map_bucket &bkt = buckets[i];
+      WriteBegin(stripe);
+      OffsetPointer off = bkt.head_.ToOffsetPointer();
+      bkt.head_.store(OffsetPointer::GetNull().load(),
+                      std::memory_order_release);
+      while (!off.IsNull()) {
+        node_t *node = GetNode(off);
+        OffsetPointer next = node->next_.ToOffsetPointer();
+        DestroyEntry(node);
+        node->next_.store(stripe.free_.load(), std::memory_order_release);
+        stripe.free_ = off;
+        stripe.size_.fetch_sub(1, std::memory_order_relaxed);
+        off = next;
+      }
+      WriteEnd(stripe);
+    }
+  }
+
+  /**====================================
+   * Index Methods
+   * ===================================*/
+
+  /**
+   * Copy the value of \a key into \a val. Returns false if the key does
+   * not exist.
+   * */
+  HSHM_CROSS_FUN
+  bool find(const Key &key, T &val) {
+    size_t hash = Hash{}(key);
+    concurrent_map_stripe &stripe = GetStripe(hash);
+    concurrent_map_bucket &bkt = GetBucket(hash);
+    if constexpr (kOptimistic) {
+      bool found;
+      if (OptimisticFind(stripe, bkt, hash, key, &val, found)) {
+        return found;
+      }
+    }
+    ScopedRwReadLock lock(stripe.lock_, 0);
+    node_t *node = FindNode(bkt, hash, key);
+    if (node) {
+      val = node->val_.get_ref();
+    }
+    return node != nullptr;
+  }
+
+  /** Check whether \a key exists */
+  HSHM_CROSS_FUN
+  bool contains(const Key &key) {
+    size_t hash = Hash{}(key);
+    concurrent_map_stripe &stripe = GetStripe(hash);
+    concurrent_map_bucket &bkt = GetBucket(hash);
+    if constexpr (kOptimistic) {
+      bool found;
+      if (OptimisticFind(stripe, bkt, hash, key, nullptr, found)) {
+        return found;
+      }
+    }
+    ScopedRwReadLock lock(stripe.lock_, 0);
+    return FindNode(bkt, hash, key) != nullptr;
+  }
+
+  /**
+   * Call \a fn(key, val) on every entry. Each stripe is read-locked while
+   * its entries are visited, so the walk is not an atomic snapshot.
+   * */
+  template <typename F>
+  HSHM_CROSS_FUN void for_each(F &&fn) {
+    bucket_vector_t &buckets = *buckets_;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      concurrent_map_stripe &stripe = (*stripes_)[i & stripe_mask_];
+      ScopedRwReadLock lock(stripe.lock_, 0);
+      OffsetPointer off = buckets[i].head_.ToOffsetPointer();
+      while (!off.IsNull()) {
+        node_t *node = GetNode(off);
+        fn(node->key_.get_ref(), node->val_.get_ref());
+        off = node->next_.ToOffsetPointer();
+      }
+    }
+  }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** The number of entries at this moment */
+  HSHM_CROSS_FUN
+  size_t size() const {
+    stripe_vector_t &stripes = const_cast<stripe_vector_t &>(*stripes_);
+    size_t size = 0;
+    for (concurrent_map_stripe &stripe : stripes) {
+      size += stripe.size_.load(std::memory_order_relaxed);
+    }
+    return size;
+  }
+
+  /** The number of buckets */
+  HSHM_INLINE_CROSS_FUN
+  size_t get_num_buckets() const { return bucket_mask_ + 1; }
+
+  /** The number of stripe locks */
+  HSHM_INLINE_CROSS_FUN
+  size_t get_num_stripes() const { return stripe_mask_ + 1; }
+
+ private:
+  /**====================================
+   * Internal Methods
+   * ===================================*/
+
+  /** Insert or replace the value of \a key */
+  template <bool modify_existing, typename... Args>
+  HSHM_CROSS_FUN bool emplace_templ(const Key &key, Args &&...args) {
+    size_t hash = Hash{}(key);
+    concurrent_map_stripe &stripe = GetStripe(hash);
+    concurrent_map_bucket &bkt = GetBucket(hash);
+    WriteBegin(stripe);
+    node_t *node = FindNode(bkt, hash, key);
+    if (node) {
+      if constexpr (modify_existing) {
+        HSHM_DESTROY_AR(node->val_)
+        HSHM_MAKE_AR(node->val_, GetCtxAllocator(),
+                     std::forward<Args>(args)...)
+      }
+      WriteEnd(stripe);
+      return false;
+    }
+    OffsetPointer off;
+    node = AllocateNode(stripe, off);
+    node->hash_ = hash;
+    HSHM_MAKE_AR(node->key_, GetCtxAllocator(), key)
+    HSHM_MAKE_AR(node->val_, GetCtxAllocator(), std::forward<Args>(args)...)
+    node->next_.store(bkt.head_.load(), std::memory_order_relaxed);
+    bkt.head_.store(off.load(), std::memory_order_release);
+    stripe.size_.fetch_add(1, std::memory_order_relaxed);
+    WriteEnd(stripe);
+    return true;
+  }
+
+  /**
+   * Search a bucket without locking. Returns false if writers kept
+   * changing the stripe, in which case the caller must lock it.
+   * */
+  HSHM_CROSS_FUN
+  bool OptimisticFind(concurrent_map_stripe &stripe,
+                      concurrent_map_bucket &bkt, size_t hash, const Key &key,
+                      T *val, bool &found) {
+    for (int attempt = 0; attempt < kOptimisticRetries; ++attempt) {
+      hshm::u64 seq = stripe.seq_.load(std::memory_order_acquire);
+      if (seq & 1) {
+        continue;
+      }
+      // Nodes are never freed, so any offset read here is a valid node.
+      // Bounding the walk stops a reader caught in a relinked chain.
+      size_t max_steps = stripe.nodes_.load(std::memory_order_acquire);
+      OffsetPointer off = bkt.head_.ToOffsetPointer();
+      found = false;
+      for (size_t step = 0; step <= max_steps && !off.IsNull(); ++step) {
+        node_t *node = GetNode(off);
+        if (node->hash_ == hash && node->key_.get_ref() == key) {
+          if (val) {
+            *val = node->val_.get_ref();
+          }
+          found = true;
+          break;
+        }
+        off = OffsetPointer(node->next_.load(std::memory_order_acquire));
+      }
+#ifdef HSHM_IS_HOST
+      std::atomic_thread_fence(std::memory_order_acquire);
+#endif
+      if (stripe.seq_.load(std::memory_order_relaxed) == seq) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Find the node of \a key in a locked bucket */
+  HSHM_INLINE_CROSS_FUN
+  node_t *FindNode(concurrent_map_bucket &bkt, size_t hash, const Key &key) {
+    OffsetPointer off = bkt.head_.ToOffsetPointer();
+    while (!off.IsNull()) {
+      node_t *node = GetNode(off);
+      if (node->hash_ == hash && node->key_.get_ref() == key) {
+        return node;
+      }
+      off = node->next_.ToOffsetPointer();
+    }
+    return nullptr;
+  }
+
+  /** Take a node from the stripe's free list, or allocate one */
+  HSHM_INLINE_CROSS_FUN
+  node_t *AllocateNode(concurrent_map_stripe &stripe, OffsetPointer &off) {
+    if (!stripe.free_.IsNull()) {
+      off = stripe.free_;
+      node_t *node = GetNode(off);
+      stripe.free_ = node->next_.ToOffsetPointer();
+      return node;
+    }
+    node_t *node =
+        GetAllocator()->template AllocateObjs<node_t>(GetMemCtx(), 1, off);
+    // Published before the node is linked, so readers' walk bound holds
+    stripe.nodes_.fetch_add(1, std::memory_order_release);
+    return node;
+  }
+
+  /** Destroy the key and value of a node */
+  HSHM_INLINE_CROSS_FUN
+  void DestroyEntry(node_t *node) {
+    HSHM_DESTROY_AR(node->key_)
+    HSHM_DESTROY_AR(node->val_)
+  }
+
+  /** Free a list of recycled nodes */
+  HSHM_CROSS_FUN
+  void FreeNodes(OffsetPointer off) {
+    while (!off.IsNull()) {
+      node_t *node = GetNode(off);
+      OffsetPointer next = node->next_.ToOffsetPointer();
+      GetAllocator()->Free(GetMemCtx(), off);
+      off = next;
+    }
+  }
+
+  /** Lock a stripe for writing and mark it as changing */
+  HSHM_INLINE_CROSS_FUN
+  void WriteBegin(concurrent_map_stripe &stripe) {
+    stripe.lock_.WriteLock(0);
+    stripe.seq_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  /** Mark a stripe as stable and unlock it */
+  HSHM_INLINE_CROSS_FUN
+  void WriteEnd(concurrent_map_stripe &stripe) {
+    stripe.seq_.fetch_add(1, std::memory_order_release);
+    stripe.lock_.WriteUnlock();
+  }
+
+  /** Get the bucket of \a hash */
+  HSHM_INLINE_CROSS_FUN
+  concurrent_map_bucket &GetBucket(size_t hash) {
+    return (*buckets_)[hash & bucket_mask_];
+  }
+
+  /** Get the stripe guarding the bucket of \a hash */
+  HSHM_INLINE_CROSS_FUN
+  concurrent_map_stripe &GetStripe(size_t hash) {
+    return (*stripes_)[hash & stripe_mask_];
+  }
+
+  /** Convert a node offset to a pointer */
+  HSHM_INLINE_CROSS_FUN
+  node_t *GetNode(const OffsetPointer &off) {
+    return GetAllocator()->template Convert<node_t>(off);
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename Key, typename T, class Hash = hshm::hash<Key>,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using concurrent_unordered_map =
+    hipc::concurrent_unordered_map<Key, T, Hash, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_CONCURRENT_UNORDERED_MAP_H_
@@ -0,0 +1,513 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_EPOCH_MANAGER_H_
+#define HSHM_DATA_STRUCTURES_IPC_EPOCH_MANAGER_H_
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/introspect/system_info.h"
+#include "hermes_shm/thread/lock.h"
+#include "lifo_list_queue.h"
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/** A retired allocation awaiting reclamation */
+struct epoch_retired_entry : public list_queue_entry {
+  OffsetPointer ptr_;   /**< The retired allocation */
+  hshm::min_u64 epoch_; /**< The global epoch when it was retired */
+};
+
+/** The default reclamation hook: retired memory needs no destruction */
+struct epoch_no_destroy {
+  template <typename AllocT>
+  HSHM_INLINE_CROSS_FUN void operator()(AllocT *,
+                                        const OffsetPointer &) const {}
+};
+
+/** A per-thread epoch slot */
+struct epoch_slot {
+  CLS_CONST hshm::min_u64 kQuiescent = (hshm::min_u64)-1;
+  CLS_CONST hshm::min_u64 kFree = 0;
+  CLS_CONST hshm::min_u64 kReaping = (hshm::min_u64)-1;
+
+  hipc::atomic<hshm::min_u64> epoch_; /**< Observed epoch, or kQuiescent */
+  hipc::atomic<hshm::min_u64> owner_; /**< Owning pid, or kFree */
+  OffsetPointer limbo_;               /**< Newest-first retired entries */
+  hshm::size_t limbo_count_;          /**< Number of retired entries */
+  hshm::size_t depth_;                /**< Critical section nesting */
+
+  /** Default constructor */
+  HSHM_CROSS_FUN
+  epoch_slot()
+      : epoch_(kQuiescent),
+        owner_(kFree),
+        limbo_(OffsetPointer::GetNull()),
+        limbo_count_(0),
+        depth_(0) {}
+};
+
+/** Forward declaration of epoch_manager */
+template <typename DestroyF = epoch_no_destroy, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class epoch_manager;
+
+/**
+ * MACROS used to simplify the epoch_manager namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME epoch_manager
+
+/**
+ * Epoch-based reclamation for lock-free shared-memory containers.
+ *
+ * Threads of any process claim a slot with Register, which is stored
+ * in their MemContext along with the manager it belongs to. A MemContext
+ * holds a slot of one manager at a time. Readers wrap accesses to shared
+ * nodes in Enter/Exit (or epoch_guard). Writers Retire unlinked nodes
+ * instead of freeing them; a node retired in epoch E is freed once the
+ * global epoch reaches E + 2, at which point no reader can still hold it.
+ *
+ * Retired memory must belong to this manager's allocator. Memory which
+ * needs destruction is destroyed by DestroyF, a stateless hook called
+ * with the allocator and each retired pointer right before it is freed.
+ *
+ * Slots owned by processes which died are recovered by ReapDeadSlots;
+ * their pending entries are moved to a shared orphan list and reclaimed
+ * by any thread.
+ * */
+template <typename DestroyF, HSHM_CLASS_TEMPL>
+class epoch_manager : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE0((CLASS_NAME))
+  typedef hipc::vector<epoch_slot, HSHM_CLASS_TEMPL_ARGS> SLOT_VEC_T;
+
+ public:
+  delay_ar<SLOT_VEC_T> slots_;
+  hipc::atomic<hshm::min_u64> epoch_;
+  hshm::size_t retire_threshold_;
+  OffsetPointer orphans_;
+  hipc::atomic<hshm::size_t> orphan_count_;
+  hshm::Mutex orphan_lock_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit epoch_manager(size_t max_slots = 1024,
+                         size_t retire_threshold = 64) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), max_slots,
+             retire_threshold);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit epoch_manager(const hipc::CtxAllocator<AllocT> &alloc,
+                         size_t max_slots = 1024,
+                         size_t retire_threshold = 64) {
+    shm_init(alloc, max_slots, retire_threshold);
+  }
+
+  /** SHM constructor. */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc,
+                size_t max_slots = 1024, size_t retire_threshold = 64) {
+    init_shm_container(alloc);
+    HSHM_MAKE_AR(slots_, GetCtxAllocator(), max_slots);
+    epoch_ = 0;
+    retire_threshold_ = retire_threshold;
+    orphans_.SetNull();
+    orphan_count_ = 0;
+    orphan_lock_.Init();
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Slots and retired entries are owned by threads; copying is disabled */
+  epoch_manager(const epoch_manager &other) = delete;
+
+  /** Slots and retired entries are owned by threads; copying is disabled */
+  epoch_manager &operator=(const epoch_manager &other) = delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor. Frees all pending retired entries. */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    FreeRetired();
+    (*slots_).shm_destroy();
+  }
+
+  /** Check if the manager is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*slots_).IsNull(); }
+
+  /** Sets this manager as null */
+  HSHM_CROSS_FUN
+  void SetNull() {}
+
+  /**====================================
+   * Slot Registration
+   * ===================================*/
+
+  /**
+   * Claim a slot for the calling thread and store it in \a ctx.
+   * Returns false if all slots are owned by live processes, or if \a ctx
+   * is registered with another manager.
+   * */
+  HSHM_CROSS_FUN
+  bool Register(hipc::MemContext &ctx) {
+    if (IsRegistered(ctx)) {
+      return true;
+    }
+    if (ctx.epoch_mgr_ != nullptr) {
+      return false;
+    }
+    if (TryRegister(ctx)) {
+      return true;
+    }
+#ifdef HSHM_IS_HOST
+    if (ReapDeadSlots() > 0) {
+      return TryRegister(ctx);
+    }
+#endif
+    return false;
+  }
+
+  /**
+   * Release the slot of \a ctx. Entries which cannot be freed yet are
+   * handed to the orphan list.
+   * */
+  HSHM_CROSS_FUN
+  void Unregister(hipc::MemContext &ctx) {
+    if (!IsRegistered(ctx)) {
+      return;
+    }
+    epoch_slot &slot = (*slots_)[ctx.epoch_slot_];
+    slot.epoch_.store(epoch_slot::kQuiescent);
+    slot.depth_ = 0;
+    TryAdvance();
+    Reclaim(ctx);
+    Orphan(slot);
+    slot.owner_.store(epoch_slot::kFree);
+    ctx.epoch_slot_ = (hshm::size_t)-1;
+    ctx.epoch_mgr_ = nullptr;
+  }
+
+  /** Whether \a ctx owns a slot of this manager */
+  HSHM_INLINE_CROSS_FUN
+  bool IsRegistered(const hipc::MemContext &ctx) const {
+    return ctx.epoch_mgr_ == this;
+  }
+
+  /**
+   * Release the slots of processes which are no longer alive.
+   * Returns the number of slots released.
+   * */
+  HSHM_HOST_FUN
+  size_t ReapDeadSlots() {
+    size_t count = 0;
+    for (epoch_slot &slot : *slots_) {
+      hshm::min_u64 owner = slot.owner_.load();
+      if (owner == epoch_slot::kFree || owner == epoch_slot::kReaping) {
+        continue;
+      }
+      if (SystemInfo::IsProcessAlive((int)owner)) {
+        continue;
+      }
+      if (!slot.owner_.compare_exchange_strong(owner, epoch_slot::kReaping)) {
+        continue;
+      }
+      slot.epoch_.store(epoch_slot::kQuiescent);
+      slot.depth_ = 0;
+      Orphan(slot);
+      slot.owner_.store(epoch_slot::kFree);
+      ++count;
+    }
+    return count;
+  }
+
+  /**====================================
+   * Critical Sections
+   * ===================================*/
+
+  /** Begin a read-side critical section. \a ctx must be registered. */
+  HSHM_INLINE_CROSS_FUN
+  void Enter(const hipc::MemContext &ctx) {
+    if (!IsRegistered(ctx)) {
+      HELOG(kFatal, "{} requires a registered MemContext", __func__);
+    }
+    epoch_slot &slot = (*slots_)[ctx.epoch_slot_];
+    if (slot.depth_++ > 0) {
+      return;
+    }
+    hshm::min_u64 epoch;
+    do {
+      epoch = epoch_.load();
+      slot.epoch_.store(epoch);
+    } while (epoch != epoch_.load());
+  }
+
+  /** End a read-side critical section. \a ctx must be registered. */
+  HSHM_INLINE_CROSS_FUN
+  void Exit(const hipc::MemContext &ctx) {
+    if (!IsRegistered(ctx)) {
+      HELOG(kFatal, "{} requires a registered MemContext", __func__);
+    }
+    epoch_slot &slot = (*slots_)[ctx.epoch_slot_];
+    if (--slot.depth_ > 0) {
+      return;
+    }
+    slot.epoch_.store(epoch_slot::kQuiescent);
+  }
+
+  /**====================================
+   * Reclamation
+   * ===================================*/
+
+  /**
+   * Defer the free of \a p until no reader can reference it.
+   * \a ctx must be registered.
+   * */
+  HSHM_CROSS_FUN
+  void Retire(const hipc::MemContext &ctx, const OffsetPointer &p) {
+    if (!IsRegistered(ctx)) {
+      HELOG(kFatal, "{} requires a registered MemContext", __func__);
+    }
+    epoch_slot &slot = (*slots_)[ctx.epoch_slot_];
+    auto *alloc = GetAllocator();
+    FullPtr<epoch_retired_entry, OffsetPointer> entry =
+        alloc->template AllocateLocalPtr<epoch_retired_entry, OffsetPointer>(
+            ctx, sizeof(epoch_retired_entry));
+    entry->ptr_ = p;
+    entry->epoch_ = epoch_.load();
+    entry->next_shm_ = slot.limbo_;
+    slot.limbo_ = entry.shm_;
+    if (++slot.limbo_count_ >= retire_threshold_) {
+      bool advanced = TryAdvance();
+#ifdef HSHM_IS_HOST
+      // A reader may have died within a critical section
+      if (!advanced && slot.limbo_count_ % (16 * retire_threshold_) == 0) {
+        ReapDeadSlots();
+      }
+#endif
+      Reclaim(ctx);
+    }
+  }
+
+  /** Defer the free of \a p until no reader can reference it */
+  template <typename T, typename PointerT>
+  HSHM_INLINE_CROSS_FUN void Retire(const hipc::MemContext &ctx,
+                                    const FullPtr<T, PointerT> &p) {
+    Retire(ctx, p.shm_.ToOffsetPointer());
+  }
+
+  /**
+   * Advance the global epoch if every active slot has observed it.
+   * Returns whether the epoch was advanced.
+   * */
+  HSHM_CROSS_FUN
+  bool TryAdvance() {
+    hshm::min_u64 epoch = epoch_.load();
+    for (epoch_slot &slot : *slots_) {
+      if (slot.owner_.load() == epoch_slot::kFree) {
+        continue;
+      }
+      hshm::min_u64 slot_epoch = slot.epoch_.load();
+      if (slot_epoch != epoch_slot::kQuiescent && slot_epoch != epoch) {
+        return false;
+      }
+    }
+    return epoch_.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  /**
+   * Free the retired entries of \a ctx (and any orphans) which are at
+   * least two epochs old. Returns the number of allocations freed.
+   * */
+  HSHM_CROSS_FUN
+  size_t Reclaim(const hipc::MemContext &ctx) {
+    size_t count = 0;
+    if (IsRegistered(ctx)) {
+      epoch_slot &slot = (*slots_)[ctx.epoch_slot_];
+      count = ReclaimLimbo(ctx, slot.limbo_);
+      slot.limbo_count_ -= count;
+    }
+    if (orphan_count_.load() > 0) {
+      hshm::ScopedMutex lock(orphan_lock_, 0);
+      size_t orphan_count = ReclaimLimbo(ctx, orphans_);
+      orphan_count_.fetch_sub(orphan_count);
+      count += orphan_count;
+    }
+    return count;
+  }
+
+  /**
+   * Free every pending retired entry, whatever its epoch. Only safe once
+   * no thread uses the memory protected by this manager.
+   * */
+  HSHM_CROSS_FUN
+  void FreeRetired() {
+    hipc::MemContext ctx = GetMemCtx();
+    for (epoch_slot &slot : *slots_) {
+      FreeLimbo(ctx, slot.limbo_);
+      slot.limbo_.SetNull();
+      slot.limbo_count_ = 0;
+    }
+    FreeLimbo(ctx, orphans_);
+    orphans_.SetNull();
+    orphan_count_ = 0;
+  }
+
+  /** Get the current global epoch */
+  HSHM_INLINE_CROSS_FUN
+  hshm::min_u64 GetEpoch() const { return epoch_.load(); }
+
+  /** Get the number of entries retired by \a ctx, but not yet freed */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetPendingCount(const hipc::MemContext &ctx) {
+    if (!IsRegistered(ctx)) {
+      return 0;
+    }
+    return (*slots_)[ctx.epoch_slot_].limbo_count_;
+  }
+
+  /** Get the number of slots */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetMaxSlots() const { return (*slots_).size(); }
+
+ private:
+  /** Claim the first free slot */
+  HSHM_CROSS_FUN
+  bool TryRegister(hipc::MemContext &ctx) {
+    hshm::min_u64 pid = (hshm::min_u64)HSHM_SYSTEM_INFO->pid_;
+    for (size_t i = 0; i < (*slots_).size(); ++i) {
+      epoch_slot &slot = (*slots_)[i];
+      hshm::min_u64 owner = epoch_slot::kFree;
+      if (slot.owner_.load() != owner ||
+          !slot.owner_.compare_exchange_strong(owner, pid)) {
+        continue;
+      }
+      slot.epoch_.store(epoch_slot::kQuiescent);
+      slot.depth_ = 0;
+      ctx.epoch_slot_ = i;
+      ctx.epoch_mgr_ = this;
+      return true;
+    }
+    return false;
+  }
+
+  /** Move the pending entries of \a slot to the orphan list */
+  HSHM_CROSS_FUN
+  void Orphan(epoch_slot &slot) {
+    if (slot.limbo_.IsNull()) {
+      return;
+    }
+    auto *alloc = GetAllocator();
+    OffsetPointer tail_shm = slot.limbo_;
+    epoch_retired_entry *tail =
+        alloc->template Convert<epoch_retired_entry>(tail_shm);
+    while (!tail->next_shm_.IsNull()) {
+      tail = alloc->template Convert<epoch_retired_entry>(tail->next_shm_);
+    }
+    // Orphans are only appended in bulk and scanned in full, so they
+    // need not be ordered by epoch.
+    hshm::ScopedMutex lock(orphan_lock_, 0);
+    tail->next_shm_ = orphans_;
+    orphans_ = slot.limbo_;
+    orphan_count_.fetch_add(slot.limbo_count_);
+    slot.limbo_.SetNull();
+    slot.limbo_count_ = 0;
+  }
+
+  /** Free entries of the list at \a head which are at least two epochs old */
+  HSHM_CROSS_FUN
+  size_t ReclaimLimbo(const hipc::MemContext &ctx, OffsetPointer &head) {
+    auto *alloc = GetAllocator();
+    hshm::min_u64 epoch = epoch_.load();
+    size_t count = 0;
+    OffsetPointer *prev_next = &head;
+    OffsetPointer cur_shm = head;
+    while (!cur_shm.IsNull()) {
+      epoch_retired_entry *cur =
+          alloc->template Convert<epoch_retired_entry>(cur_shm);
+      OffsetPointer next_shm = cur->next_shm_;
+      if (cur->epoch_ + 2 <= epoch) {
+        *prev_next = next_shm;
+        DestroyF()(alloc, cur->ptr_);
+        alloc->template Free<OffsetPointer>(ctx, cur->ptr_);
+        alloc->template Free<OffsetPointer>(ctx, cur_shm);
+        ++count;
+      } else {
+        prev_next = &cur->next_shm_;
+      }
+      cur_shm = next_shm;
+    }
+    return count;
+  }
+
+  /** Free every entry of the list at \a head */
+  HSHM_CROSS_FUN
+  void FreeLimbo(const hipc::MemContext &ctx, OffsetPointer head) {
+    auto *alloc = GetAllocator();
+    while (!head.IsNull()) {
+      epoch_retired_entry *cur =
+          alloc->template Convert<epoch_retired_entry>(head);
+      OffsetPointer next_shm = cur->next_shm_;
+      DestroyF()(alloc, cur->ptr_);
+      alloc->template Free<OffsetPointer>(ctx, cur->ptr_);
+      alloc->template Free<OffsetPointer>(ctx, head);
+      head = next_shm;
+    }
+  }
+};
+
+/** Scoped read-side critical section of an epoch_manager */
+template <typename EpochManagerT>
+struct epoch_guard {
+  EpochManagerT &mgr_;
+  const hipc::MemContext &ctx_;
+
+  /** Enter the critical section */
+  HSHM_INLINE_CROSS_FUN
+  epoch_guard(EpochManagerT &mgr, const hipc::MemContext &ctx)
+      : mgr_(mgr), ctx_(ctx) {
+    mgr_.Enter(ctx_);
+  }
+
+  /** Exit the critical section */
+  HSHM_INLINE_CROSS_FUN
+  ~epoch_guard() { mgr_.Exit(ctx_); }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename DestroyF = hipc::epoch_no_destroy,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using epoch_manager = hipc::epoch_manager<DestroyF, HSHM_CLASS_TEMPL_ARGS>;
+
+using hipc::epoch_guard;
+using hipc::epoch_no_destroy;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_EPOCH_MANAGER_H_
@@ -0,0 +1,677 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_FLAT_MAP_H_
+#define HSHM_DATA_STRUCTURES_IPC_FLAT_MAP_H_
+
+#include <cstring>
+#include <type_traits>
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/memory/memory.h"
+#include "hermes_shm/types/numbers.h"
+#include "hash.h"
+#include "pair.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(HSHM_COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+namespace hshm::ipc {
+
+/**
+ * A window of flat_map control bytes. Each byte is either kEmpty or the
+ * low 7 bits of the hash of a full slot. A window is matched against a
+ * hash in one SSE2 compare on the host, or byte by byte on devices.
+ * The width is fixed so that every build shares the same table layout.
+ * */
+struct flat_map_group {
+  static constexpr size_t kWidth = 16;
+  static constexpr hshm::i8 kEmpty = -128;
+  const hshm::i8 *ctrl_;
+
+  /** Wrap the kWidth control bytes at \a ctrl */
+  HSHM_INLINE_CROSS_FUN
+  explicit flat_map_group(const hshm::i8 *ctrl) : ctrl_(ctrl) {}
+
+  /** Bitmask of the bytes equal to \a h2 */
+  HSHM_INLINE_CROSS_FUN
+  hshm::u32 Match(hshm::i8 h2) const {
+#if defined(HSHM_IS_HOST) && defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl_));
+    __m128i eq = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2));
+    return (hshm::u32)_mm_movemask_epi8(eq);
+#else
+    hshm::u32 mask = 0;
+    for (size_t i = 0; i < kWidth; ++i) {
+      mask |= (hshm::u32)(ctrl_[i] == h2) << i;
+    }
+    return mask;
+#endif
+  }
+
+  /** Bitmask of the empty bytes */
+  HSHM_INLINE_CROSS_FUN
+  hshm::u32 MatchEmpty() const { return Match(kEmpty); }
+
+  /** Index of the lowest set bit of a non-zero \a mask */
+  HSHM_INLINE_CROSS_FUN
+  static size_t LowestBit(hshm::u32 mask) {
+#if defined(HSHM_IS_GPU)
+    return (size_t)(__ffs(mask) - 1);
+#elif defined(HSHM_COMPILER_MSVC)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (size_t)idx;
+#else
+    return (size_t)__builtin_ctz(mask);
+#endif
+  }
+};
+
+/** forward pointer for flat_map */
+template <typename Key, typename T, class Hash = hshm::hash<Key>,
+          HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class flat_map;
+
+/**
+ * The flat map iterator (slot index)
+ * */
+template <typename Key, typename T, class Hash, HSHM_CLASS_TEMPL>
+struct flat_map_iterator {
+ public:
+  using PAIR_T = hipc::pair<Key, T, HSHM_CLASS_TEMPL_ARGS>;
+
+ public:
+  flat_map<Key, T, Hash, HSHM_CLASS_TEMPL_ARGS> *map_;
+  size_t i_;
+
+  /** Default constructor */
+  HSHM_CROSS_FUN flat_map_iterator() = default;
+
+  /** Construct the iterator at slot \a i */
+  HSHM_INLINE_CROSS_FUN explicit flat_map_iterator(
+      flat_map<Key, T, Hash, HSHM_CLASS_TEMPL_ARGS> &map, size_t i)
+      : map_(&map), i_(i) {}
+
+  /** Get the pointed object */
+  HSHM_INLINE_CROSS_FUN PAIR_T &operator*() { return map_->GetSlot(i_); }
+
+  /** Get the pointed object */
+  HSHM_INLINE_CROSS_FUN const PAIR_T &operator*() const {
+    return map_->GetSlot(i_);
+  }
+
+  /** Go to the next object */
+  HSHM_INLINE_CROSS_FUN flat_map_iterator &operator++() {
+    ++i_;
+    make_correct();
+    return *this;
+  }
+
+  /** Return the next iterator */
+  HSHM_INLINE_CROSS_FUN flat_map_iterator operator++(int) const {
+    flat_map_iterator next(*this);
+    ++next;
+    return next;
+  }
+
+  /** Skip empty slots until a full one or the end */
+  HSHM_INLINE_CROSS_FUN void make_correct() {
+    size_t capacity = map_->capacity();
+    while (i_ < capacity && !map_->IsFull(i_)) {
+      ++i_;
+    }
+  }
+
+  /** Check if two iterators are equal */
+  HSHM_INLINE_CROSS_FUN friend bool operator==(const flat_map_iterator &a,
+                                               const flat_map_iterator &b) {
+    return a.i_ == b.i_;
+  }
+
+  /** Check if two iterators are inequal */
+  HSHM_INLINE_CROSS_FUN friend bool operator!=(const flat_map_iterator &a,
+                                               const flat_map_iterator &b) {
+    return a.i_ != b.i_;
+  }
+
+  /** Determine whether this iterator is the end iterator */
+  HSHM_INLINE_CROSS_FUN bool is_end() const {
+    return i_ >= map_->capacity();
+  }
+
+  /** Set this iterator to the end iterator */
+  HSHM_INLINE_CROSS_FUN void set_end() { i_ = map_->capacity(); }
+};
+
+/**
+ * MACROS to simplify the flat_map namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+
+#define CLASS_NAME flat_map
+#define CLASS_NEW_ARGS Key, T, Hash
+
+/**
+ * An open-addressing hash map (Swiss table). Keys and values are stored
+ * inline in one shared-memory table next to an array of control bytes,
+ * so inserts do not allocate and a lookup compares 16 slots per step
+ * before touching any key. Probing is linear from the home slot and
+ * erasing shifts the following entries back, so no tombstones are left
+ * behind. The table doubles once it is 7/8 full.
+ *
+ * Erasing or inserting invalidates iterators.
+ * */
+template <typename Key, typename T, class Hash, HSHM_CLASS_TEMPL>
+class flat_map : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  HSHM_TRIVIALLY_RELOCATABLE
+
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef flat_map_iterator<Key, T, Hash, HSHM_CLASS_TEMPL_ARGS> iterator_t;
+  friend iterator_t;
+  using PAIR_T = hipc::pair<Key, T, HSHM_CLASS_TEMPL_ARGS>;
+  static constexpr size_t kWidth = flat_map_group::kWidth;
+  static constexpr hshm::i8 kEmpty = flat_map_group::kEmpty;
+
+  /**====================================
+   * Variables
+   * ===================================*/
+  OffsetPointer table_; /**< Control bytes, then slots */
+  hshm::size_t capacity_;
+  hshm::size_t length_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** SHM constructor. Reserves space for \a count entries. */
+  HSHM_CROSS_FUN
+  explicit flat_map(size_t count = 0) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), count);
+  }
+
+  /** SHM constructor. Reserves space for \a count entries. */
+  HSHM_CROSS_FUN
+  explicit flat_map(const hipc::CtxAllocator<AllocT> &alloc,
+                    size_t count = 0) {
+    shm_init(alloc, count);
+  }
+
+  /** SHM constructor. */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc, size_t count = 0) {
+    init_shm_container(alloc);
+    SetNull();
+    reserve(count);
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Copy constructor */
+  HSHM_CROSS_FUN
+  explicit flat_map(const flat_map &other) {
+    init_shm_container(other.GetCtxAllocator());
+    SetNull();
+    shm_strong_copy_op(other);
+  }
+
+  /** SHM copy constructor */
+  HSHM_CROSS_FUN
+  explicit flat_map(const hipc::CtxAllocator<AllocT> &alloc,
+                    const flat_map &other) {
+    init_shm_container(alloc);
+    SetNull();
+    shm_strong_copy_op(other);
+  }
+
+  /** SHM copy assignment operator */
+  HSHM_CROSS_FUN
+  flat_map &operator=(const flat_map &other) {
+    if (this != &other) {
+      shm_destroy();
+      shm_strong_copy_op(other);
+    }
+    return *this;
+  }
+
+  /** Internal copy operation */
+  HSHM_CROSS_FUN
+  void shm_strong_copy_op(const flat_map &other) {
+    reserve(other.size());
+    for (PAIR_T &entry : other) {
+      emplace_templ<false>(entry.GetKey(), entry.GetVal());
+    }
+  }
+
+  /**====================================
+   * Move Constructors
+   * ===================================*/
+
+  /** Move constructor. */
+  HSHM_INLINE_CROSS_FUN flat_map(flat_map &&other) noexcept {
+    shm_move_op<false>(other.GetCtxAllocator(), std::move(other));
+  }
+
+  /** SHM move constructor. */
+  HSHM_INLINE_CROSS_FUN flat_map(const hipc::CtxAllocator<AllocT> &alloc,
+                                 flat_map &&other) noexcept {
+    shm_move_op<false>(alloc, std::move(other));
+  }
+
+  /** SHM move assignment operator. */
+  HSHM_CROSS_FUN
+  flat_map &operator=(flat_map &&other) noexcept {
+    if (this != &other) {
+      shm_move_op<true>(GetCtxAllocator(), std::move(other));
+    }
+    return *this;
+  }
+
+  /** SHM move operator. */
+  template <bool IS_ASSIGN>
+  HSHM_CROSS_FUN void shm_move_op(const hipc::CtxAllocator<AllocT> &alloc,
+                                  flat_map &&other) noexcept {
+    if constexpr (!IS_ASSIGN) {
+      init_shm_container(alloc);
+      SetNull();
+    } else {
+      shm_destroy();
+    }
+    if (GetAllocator() == other.GetAllocator()) {
+      table_ = other.table_;
+      capacity_ = other.capacity_;
+      length_ = other.length_;
+      other.SetNull();
+    } else {
+      shm_strong_copy_op(other);
+      other.shm_destroy();
+    }
+  }
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** Check if the map has no table */
+  HSHM_INLINE_CROSS_FUN bool IsNull() const { return table_.IsNull(); }
+
+  /** Sets this map as empty */
+  HSHM_INLINE_CROSS_FUN void SetNull() {
+    table_.SetNull();
+    capacity_ = 0;
+    length_ = 0;
+  }
+
+  /** Destroy the entries and free the table */
+  HSHM_CROSS_FUN void shm_destroy_main() {
+    DestroyEntries();
+    GetAllocator()->template Free<OffsetPointer>(GetMemCtx(), table_);
+  }
+
+  /**====================================
+   * Emplace Methods
+   * ===================================*/
+
+  /**
+   * Construct an object directly in the map. Overrides the object if
+   * key already exists.
+   *
+   * @param key the key to future index the map
+   * @param args the arguments to construct the object
+   * @return true
+   * */
+  template <typename... Args>
+  HSHM_CROSS_FUN bool emplace(const Key &key, Args &&...args) {
+    return emplace_templ<true>(key, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Construct an object directly in the map. Does not modify the key
+   * if it already exists.
+   *
+   * @param key the key to future index the map
+   * @param args the arguments to construct the object
+   * @return whether the object was inserted
+   * */
+  template <typename... Args>
+  HSHM_CROSS_FUN bool try_emplace(const Key &key, Args &&...args) {
+    return emplace_templ<false>(key, std::forward<Args>(args)...);
+  }
+
+ private:
+  /** Insert (key, value), optionally replacing an existing entry */
+  template <bool modify_existing, typename... Args>
+  HSHM_CROSS_FUN bool emplace_templ(const Key &key, Args &&...args) {
+    size_t hash = Mix(Hash{}(key));
+    size_t i = FindSlot(key, hash);
+    if (i < capacity_) {
+      if constexpr (!modify_existing) {
+        return false;
+      } else {
+        hipc::Allocator::DestructObj(GetSlot(i));
+        ConstructSlot(i, key, std::forward<Args>(args)...);
+        return true;
+      }
+    }
+    if ((length_ + 1) * 8 > capacity_ * 7) {
+      Rehash(capacity_ ? 2 * capacity_ : kWidth);
+    }
+    i = FindEmpty(hash);
+    ConstructSlot(i, key, std::forward<Args>(args)...);
+    SetCtrl(i, H2(hash));
+    ++length_;
+    return true;
+  }
+
+ public:
+  /**====================================
+   * Erase Methods
+   * ===================================*/
+
+  /** Erase the object indexable by \a key */
+  HSHM_CROSS_FUN
+  void erase(const Key &key) {
+    size_t i = FindSlot(key, Mix(Hash{}(key)));
+    if (i < capacity_) {
+      EraseSlot(i);
+    }
+  }
+
+  /** Erase the object at the iterator */
+  HSHM_CROSS_FUN
+  void erase(iterator_t &iter) {
+    if (iter.is_end()) return;
+    EraseSlot(iter.i_);
+  }
+
+  /** Erase the entire map, keeping its capacity */
+  HSHM_CROSS_FUN void clear() {
+    if (IsNull()) {
+      return;
+    }
+    DestroyEntries();
+    memset(GetCtrl(), kEmpty, capacity_ + kWidth);
+    length_ = 0;
+  }
+
+  /** Grow the table so \a count entries fit without a rehash */
+  HSHM_CROSS_FUN void reserve(size_t count) {
+    if (count * 8 <= capacity_ * 7) {
+      return;
+    }
+    size_t new_capacity = hshm::RoundUpPow2(count * 8 / 7 + 1);
+    Rehash(new_capacity < kWidth ? kWidth : new_capacity);
+  }
+
+  /**====================================
+   * Index Methods
+   * ===================================*/
+
+  /**
+   * Locate an entry in the flat_map
+   *
+   * @return the object pointed by key
+   * @exception UNORDERED_MAP_CANT_FIND the key was not in the map
+   * */
+  HSHM_INLINE_CROSS_FUN T &operator[](const Key &key) {
+    auto iter = find(key);
+    if (!iter.is_end()) {
+      return (*iter).GetVal();
+    }
+    HSHM_THROW_ERROR(UNORDERED_MAP_CANT_FIND);
+  }
+
+  /** Find an object in the flat_map */
+  HSHM_CROSS_FUN
+  iterator_t find(const Key &key) {
+    return iterator_t(*this, FindSlot(key, Mix(Hash{}(key))));
+  }
+
+  /** Check whether \a key is in the map */
+  HSHM_INLINE_CROSS_FUN
+  bool contains(const Key &key) { return !find(key).is_end(); }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** The number of entries in the map */
+  HSHM_INLINE_CROSS_FUN size_t size() const { return length_; }
+
+  /** The number of slots in the table */
+  HSHM_INLINE_CROSS_FUN size_t capacity() const { return capacity_; }
+
+  /**====================================
+   * Iterators
+   * ===================================*/
+
+  /** Forward iterator begin */
+  HSHM_INLINE_CROSS_FUN iterator_t begin() const {
+    iterator_t iter(const_cast<flat_map &>(*this), 0);
+    iter.make_correct();
+    return iter;
+  }
+
+  /** Forward iterator end */
+  HSHM_INLINE_CROSS_FUN iterator_t end() const {
+    return iterator_t(const_cast<flat_map &>(*this), capacity_);
+  }
+
+ private:
+  /**====================================
+   * Table Helpers
+   * ===================================*/
+
+  /**
+   * Spread the bits of a hash over H1 and H2. hshm::hash is already mixed,
+   * but a user-supplied Hash may leave the high or low bits constant.
+   * */
+  HSHM_INLINE_CROSS_FUN
+  static size_t Mix(size_t hash) {
+    hshm::u64 x = (hshm::u64)hash * 0x9e3779b97f4a7c15ULL;
+    return (size_t)(x ^ (x >> 32));
+  }
+
+  /** The home slot bits of a mixed hash */
+  HSHM_INLINE_CROSS_FUN
+  static size_t H1(size_t hash) { return hash >> 7; }
+
+  /** The control byte of a mixed hash */
+  HSHM_INLINE_CROSS_FUN
+  static hshm::i8 H2(size_t hash) { return (hshm::i8)(hash & 0x7f); }
+
+  /** Offset of the slots in the table, after the mirrored control bytes */
+  HSHM_INLINE_CROSS_FUN
+  static size_t GetSlotsOffset(size_t capacity) {
+    size_t align = alignof(delay_ar<PAIR_T>);
+    return (capacity + kWidth + align - 1) / align * align;
+  }
+
+  /** Get the control bytes */
+  HSHM_INLINE_CROSS_FUN
+  hshm::i8 *GetCtrl() const {
+    return GetAllocator()->template Convert<hshm::i8>(table_);
+  }
+
+  /** Get the slots */
+  HSHM_INLINE_CROSS_FUN
+  delay_ar<PAIR_T> *GetSlots() const {
+    return reinterpret_cast<delay_ar<PAIR_T> *>(
+        reinterpret_cast<char *>(GetCtrl()) + GetSlotsOffset(capacity_));
+  }
+
+  /** Get the entry in slot \a i */
+  HSHM_INLINE_CROSS_FUN
+  PAIR_T &GetSlot(size_t i) const { return GetSlots()[i].get_ref(); }
+
+  /** Whether slot \a i holds an entry */
+  HSHM_INLINE_CROSS_FUN
+  bool IsFull(size_t i) const { return GetCtrl()[i] != kEmpty; }
+
+  /** Set control byte \a i, mirroring the first kWidth bytes at the end */
+  HSHM_INLINE_CROSS_FUN
+  void SetCtrl(size_t i, hshm::i8 h2) {
+    hshm::i8 *ctrl = GetCtrl();
+    ctrl[i] = h2;
+    if (i < kWidth) {
+      ctrl[capacity_ + i] = h2;
+    }
+  }
+
+  /** Construct the entry of slot \a i */
+  template <typename... Args>
+  HSHM_INLINE_CROSS_FUN void ConstructSlot(size_t i, const Key &key,
+                                           Args &&...args) {
+    HSHM_MAKE_AR(GetSlots()[i], GetCtxAllocator(), PiecewiseConstruct(),
+                 make_argpack(key),
+                 make_argpack(std::forward<Args>(args)...))
+  }
+
+  /** Move the entry in \a src to the unconstructed slot \a dst */
+  HSHM_INLINE_CROSS_FUN
+  void RelocateSlot(delay_ar<PAIR_T> *dst, delay_ar<PAIR_T> *src) {
+    if constexpr (std::is_trivially_copyable_v<Key> &&
+                  std::is_trivially_copyable_v<T>) {
+      memcpy((void *)dst, (void *)src, sizeof(delay_ar<PAIR_T>));
+    } else {
+      HSHM_MAKE_AR((*dst), GetCtxAllocator(), std::move(src->get_ref()))
+      hipc::Allocator::DestructObj(src->get_ref());
+    }
+  }
+
+  /** The slot holding \a key, or capacity_ if it is absent */
+  HSHM_CROSS_FUN
+  size_t FindSlot(const Key &key, size_t hash) const {
+    if (capacity_ == 0) {
+      return 0;
+    }
+    hshm::i8 *ctrl = GetCtrl();
+    size_t mask = capacity_ - 1;
+    hshm::i8 h2 = H2(hash);
+    for (size_t pos = H1(hash) & mask;; pos = (pos + kWidth) & mask) {
+      flat_map_group group(ctrl + pos);
+      for (hshm::u32 m = group.Match(h2); m; m &= m - 1) {
+        size_t i = (pos + flat_map_group::LowestBit(m)) & mask;
+        if (GetSlot(i).GetKey() == key) {
+          return i;
+        }
+      }
+      if (group.MatchEmpty()) {
+        return capacity_;
+      }
+    }
+  }
+
+  /** The first empty slot at or after the home slot of \a hash */
+  HSHM_CROSS_FUN
+  size_t FindEmpty(size_t hash) const {
+    hshm::i8 *ctrl = GetCtrl();
+    size_t mask = capacity_ - 1;
+    for (size_t pos = H1(hash) & mask;; pos = (pos + kWidth) & mask) {
+      hshm::u32 m = flat_map_group(ctrl + pos).MatchEmpty();
+      if (m) {
+        return (pos + flat_map_group::LowestBit(m)) & mask;
+      }
+    }
+  }
+
+  /**
+   * Destroy the entry in slot \a i, then shift back each following entry
+   * whose home slot lies at or before the hole.
+   * */
+  HSHM_CROSS_FUN
+  void EraseSlot(size_t i) {
+    delay_ar<PAIR_T> *slots = GetSlots();
+    hshm::i8 *ctrl = GetCtrl();
+    size_t mask = capacity_ - 1;
+    hipc::Allocator::DestructObj(slots[i].get_ref());
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; ctrl[j] != kEmpty; j = (j + 1) & mask) {
+      size_t home = H1(Mix(Hash{}(slots[j]->GetKey()))) & mask;
+      if (((j - home) & mask) >= ((j - hole) & mask)) {
+        RelocateSlot(slots + hole, slots + j);
+        SetCtrl(hole, ctrl[j]);
+        hole = j;
+      }
+    }
+    SetCtrl(hole, kEmpty);
+    --length_;
+  }
+
+  /** Destroy every entry, leaving the control bytes stale */
+  HSHM_CROSS_FUN
+  void DestroyEntries() {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (IsFull(i)) {
+        hipc::Allocator::DestructObj(GetSlot(i));
+      }
+    }
+  }
+
+  /** Move every entry into a new table of \a new_capacity slots */
+  HSHM_CROSS_FUN
+  void Rehash(size_t new_capacity) {
+    size_t size =
+        GetSlotsOffset(new_capacity) + new_capacity * sizeof(delay_ar<PAIR_T>);
+    FullPtr<char, OffsetPointer> p =
+        GetAllocator()->template AllocateLocalPtr<char, OffsetPointer>(
+            GetMemCtx(), size);
+    memset(p.ptr_, kEmpty, new_capacity + kWidth);
+
+    OffsetPointer old_table = table_;
+    size_t old_capacity = capacity_;
+    hshm::i8 *old_ctrl = IsNull() ? nullptr : GetCtrl();
+    delay_ar<PAIR_T> *old_slots = IsNull() ? nullptr : GetSlots();
+    table_ = p.shm_;
+    capacity_ = new_capacity;
+
+    delay_ar<PAIR_T> *slots = GetSlots();
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] == kEmpty) {
+        continue;
+      }
+      size_t hash = Mix(Hash{}(old_slots[i]->GetKey()));
+      size_t j = FindEmpty(hash);
+      RelocateSlot(slots + j, old_slots + i);
+      SetCtrl(j, H2(hash));
+    }
+    if (!old_table.IsNull()) {
+      GetAllocator()->template Free<OffsetPointer>(GetMemCtx(), old_table);
+    }
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename Key, typename T, class Hash = hshm::hash<Key>,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using flat_map = hipc::flat_map<Key, T, Hash, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_FLAT_MAP_H_
@@ -6,8 +6,15 @@
 #define HSHM_SHM_INCLUDE_HSHM_SHM_DATA_STRUCTURES_CONTAINERS_HASH_H_
 
 #include <cstddef>
+#include <cstring>
+#include <type_traits>
 
 #include "hermes_shm/constants/macros.h"
+#include "hermes_shm/types/numbers.h"
+
+#if defined(HSHM_COMPILER_MSVC)
+#include <intrin.h>
+#endif
 
 namespace hshm {
 
@@ -15,18 +22,149 @@ namespace hshm {
 template <typename T>
 class hash;
 
+/** Secrets of the hash functions (from wyhash) */
+constexpr hshm::u64 kHashSecret0 = 0x2d358dccaa6c78a5ull;
+constexpr hshm::u64 kHashSecret1 = 0x8bb84b93962eacc9ull;
+constexpr hshm::u64 kHashSecret2 = 0x4b33a62ed433d4a3ull;
+constexpr hshm::u64 kHashSecret3 = 0x4d5a2da51de1aa47ull;
+
+/** Multiply \a a and \a b into a 128-bit product: \a a = low, \a b = high */
+HSHM_INLINE_CROSS_FUN static void hash_mum(hshm::u64 &a, hshm::u64 &b) {
+#if defined(HSHM_IS_GPU)
+  hshm::u64 hi = __umul64hi(a, b);
+  a = a * b;
+  b = hi;
+#elif defined(__SIZEOF_INT128__)
+  __uint128_t r = (__uint128_t)a * b;
+  a = (hshm::u64)r;
+  b = (hshm::u64)(r >> 64);
+#elif defined(HSHM_COMPILER_MSVC) && defined(_M_X64)
+  a = _umul128(a, b, &b);
+#else
+  hshm::u64 ha = a >> 32, hb = b >> 32, la = (hshm::u32)a, lb = (hshm::u32)b;
+  hshm::u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  hshm::u64 t = rl + (rm0 << 32), c = t < rl;
+  hshm::u64 lo = t + (rm1 << 32);
+  c += lo < t;
+  a = lo;
+  b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/** Multiply \a a and \a b and fold the 128-bit product to 64 bits */
+HSHM_INLINE_CROSS_FUN static hshm::u64 hash_mix(hshm::u64 a, hshm::u64 b) {
+  hash_mum(a, b);
+  return a ^ b;
+}
+
+/** Load 8 unaligned bytes */
+HSHM_INLINE_CROSS_FUN static hshm::u64 hash_read8(const unsigned char *p) {
+  hshm::u64 v;
+  memcpy(&v, p, 8);
+  return v;
+}
+
+/** Load 4 unaligned bytes */
+HSHM_INLINE_CROSS_FUN static hshm::u64 hash_read4(const unsigned char *p) {
+  hshm::u32 v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+/** Load 1 to 3 bytes */
+HSHM_INLINE_CROSS_FUN static hshm::u64 hash_read3(const unsigned char *p,
+                                                 size_t len) {
+  return (((hshm::u64)p[0]) << 16) | (((hshm::u64)p[len >> 1]) << 8) |
+         p[len - 1];
+}
+
+/**
+ * Hash \a len bytes (wyhash). Inputs of up to 16 bytes are read with
+ * two overlapping loads. Longer inputs are consumed 48 bytes per step in
+ * three independent lanes, then 16 bytes per step.
+ * */
+HSHM_INLINE_CROSS_FUN static hshm::u64 hash_bytes(const void *data, size_t len,
+                                                  hshm::u64 seed = 0) {
+  const unsigned char *p = (const unsigned char *)data;
+  seed ^= hash_mix(seed ^ kHashSecret0, kHashSecret1);
+  hshm::u64 a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t off = (len >> 3) << 2;
+      a = (hash_read4(p) << 32) | hash_read4(p + off);
+      b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - off);
+    } else if (len > 0) {
+      a = hash_read3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i >= 48) {
+      hshm::u64 see1 = seed, see2 = seed;
+      do {
+        seed = hash_mix(hash_read8(p) ^ kHashSecret1, hash_read8(p + 8) ^ seed);
+        see1 = hash_mix(hash_read8(p + 16) ^ kHashSecret2,
+                        hash_read8(p + 24) ^ see1);
+        see2 = hash_mix(hash_read8(p + 32) ^ kHashSecret3,
+                        hash_read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i >= 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = hash_mix(hash_read8(p) ^ kHashSecret1, hash_read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = hash_read8(p + i - 16);
+    b = hash_read8(p + i - 8);
+  }
+  a ^= kHashSecret1;
+  b ^= seed;
+  hash_mum(a, b);
+  return hash_mix(a ^ kHashSecret0 ^ len, b ^ kHashSecret1);
+}
+
 /** String hash function */
 template <typename StringT>
 HSHM_CROSS_FUN size_t string_hash(const StringT &text) {
-  size_t sum = 0;
-  for (size_t i = 0; i < text.size(); ++i) {
-    auto shift = static_cast<size_t>(i % sizeof(size_t));
-    auto c = static_cast<size_t>((unsigned char)text[i]);
-    sum = 31 * sum + (c << shift);
-  }
-  return sum;
+  return (size_t)hash_bytes(text.data(), text.size());
 }
 
+/**
+ * Transparent string hash. Hashes any type with data() and size() (e.g.,
+ * std::string_view) and C strings the same way, so a map keyed by one
+ * string type can be searched with another without copying the key.
+ * */
+struct transparent_string_hash {
+  using is_transparent = void;
+
+  /** Hash a C string */
+  HSHM_CROSS_FUN size_t operator()(const char *text) const {
+    size_t len = 0;
+    while (text[len]) {
+      ++len;
+    }
+    return (size_t)hash_bytes(text, len);
+  }
+
+  /** Hash a string with data() and size() */
+  template <typename StringT>
+  HSHM_CROSS_FUN size_t operator()(const StringT &text) const {
+    return string_hash(text);
+  }
+};
+
+/** Whether \a Hash accepts keys other than the map's key type */
+template <typename Hash, typename = void>
+struct hash_is_transparent : std::false_type {};
+template <typename Hash>
+struct hash_is_transparent<Hash, std::void_t<typename Hash::is_transparent>>
+    : std::true_type {};
+
 /** Pointer hash function */
 template <typename T>
 struct hash<T *> {
@@ -35,20 +173,31 @@ struct hash<T *> {
   }
 };
 
-/** Integer hash function */
+/**
+ * Integer hash function. The value is mixed by one folded 64x64-bit
+ * multiply, so keys with a common stride (e.g., page-aligned offsets)
+ * still spread over every bucket under a modulo.
+ * */
 template <typename T>
 HSHM_INLINE_CROSS_FUN static size_t number_hash(const T &val) {
-  if constexpr (sizeof(T) == 1) {
-    return static_cast<size_t>(val);
-  } else if constexpr (sizeof(T) == 2) {
-    return static_cast<size_t>(val);
-  } else if constexpr (sizeof(T) == 4) {
-    return static_cast<size_t>(val);
-  } else if constexpr (sizeof(T) == 8) {
-    return static_cast<size_t>(val);
+  hshm::u64 x;
+  if constexpr (std::is_floating_point_v<T>) {
+    // Hash the bits, but keep 0.0 == -0.0
+    if (val == 0) {
+      x = 0;
+    } else if constexpr (sizeof(T) == 4) {
+      hshm::u32 bits;
+      memcpy(&bits, &val, sizeof(bits));
+      x = bits;
+    } else {
+      memcpy(&x, &val, sizeof(x));
+    }
+  } else if constexpr (sizeof(T) <= 8) {
+    x = static_cast<hshm::u64>(val);
   } else {
     return 0;
   }
+  return (size_t)hash_mix(x ^ kHashSecret0, kHashSecret1);
 }
 
 /** HSHM integer hash */
@@ -27,6 +27,14 @@ struct list_queue_entry {
   OffsetPointer next_shm_;
 };
 
+/**
+ * represents an object within a lifo_list_queue or spsc_fifo_list_queue,
+ * linked by a CompactOffsetPointer
+ * */
+struct compact_list_queue_entry {
+  CompactOffsetPointer next_shm_;
+};
+
 /** represents an object within a lifo_list_queue */
 struct atomic_list_queue_entry {
   AtomicOffsetPointer next_shm_;
@@ -94,9 +102,10 @@ struct lifo_list_queue_iterator_templ {
       return *this;
     }
     prior_entry_ = entry_;
+    OffsetPointer next_shm = reinterpret_cast<T *>(entry_)->next_shm_;
     entry_ =
         lifo_list_queue_->GetAllocator()->template Convert<list_queue_entry>(
-            entry_->next_shm_);
+            next_shm);
     return *this;
   }
 
@@ -16,6 +16,7 @@
 #include <list>
 
 #include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/data_structures/internal/shm_node_pool.h"
 #include "hermes_shm/data_structures/ipc/functional.h"
 #include "hermes_shm/data_structures/serialization/serialize_common.h"
 
@@ -26,11 +27,12 @@ template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
 class list;
 
 /** represents an object within a list */
-template <typename T>
+template <typename T, HSHM_CLASS_TEMPL>
 struct list_entry {
  public:
-  OffsetPointer next_ptr_, prior_ptr_;
-  delay_ar<T> data_;
+  HSHM_LINK_POINTER next_ptr_, prior_ptr_;
+  /** Aligned for T even after compact links, up to the node pool limit */
+  alignas(std::min(alignof(T), alignof(OffsetPointer))) delay_ar<T> data_;
 };
 
 /**
@@ -42,7 +44,7 @@ struct list_iterator_templ {
   /**< A shm reference to the containing list object. */
   list<T, HSHM_CLASS_TEMPL_ARGS> *list_;
   /**< A pointer to the entry in shared memory */
-  list_entry<T> *entry_;
+  list_entry<T, HSHM_CLASS_TEMPL_ARGS> *entry_;
   /**< The offset of the entry in the shared-memory allocator */
   OffsetPointer entry_ptr_;
 
@@ -53,7 +55,8 @@ struct list_iterator_templ {
   /** Construct an iterator  */
   HSHM_CROSS_FUN
   explicit list_iterator_templ(list<T, HSHM_CLASS_TEMPL_ARGS> &list,
-                               list_entry<T> *entry, OffsetPointer entry_ptr)
+                               list_entry<T, HSHM_CLASS_TEMPL_ARGS> *entry,
+                               OffsetPointer entry_ptr)
       : list_(&list), entry_(entry), entry_ptr_(entry_ptr) {}
 
   /** Copy constructor */
@@ -90,8 +93,9 @@ struct list_iterator_templ {
       return *this;
     }
     entry_ptr_ = entry_->next_ptr_;
-    entry_ = list_->GetAllocator()->template Convert<list_entry<T>>(
-        entry_->next_ptr_);
+    entry_ = list_->GetAllocator()
+                 ->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+                     entry_ptr_);
     return *this;
   }
 
@@ -102,8 +106,9 @@ struct list_iterator_templ {
       return *this;
     }
     entry_ptr_ = entry_->prior_ptr_;
-    entry_ = list_->GetAllocator()->template Convert<list_entry<T>>(
-        entry_->prior_ptr_);
+    entry_ = list_->GetAllocator()
+                 ->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+                     entry_ptr_);
     return *this;
   }
 
@@ -202,8 +207,10 @@ template <typename T, HSHM_CLASS_TEMPL>
 class list : public ShmContainer {
  public:
   HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  HSHM_TRIVIALLY_RELOCATABLE
   OffsetPointer head_ptr_, tail_ptr_;
   size_t length_;
+  node_pool<list_entry<T, HSHM_CLASS_TEMPL_ARGS>> pool_;
 
  public:
   /**====================================
@@ -285,6 +292,9 @@ class list : public ShmContainer {
   /** SHM copy constructor + operator main */
   template <typename ListT>
   HSHM_CROSS_FUN void shm_strong_copy_op(const ListT &other) {
+    if constexpr (std::is_same_v<ListT, list>) {
+      pool_.chunk_nodes_ = other.pool_.chunk_nodes_;
+    }
     for (auto iter = other.cbegin(); iter != other.cend(); ++iter) {
       emplace_back(*iter);
     }
@@ -341,9 +351,9 @@ class list : public ShmContainer {
   HSHM_CROSS_FUN
   void shm_destroy_main() { clear(); }
 
-  /** Check if the list is empty */
+  /** Check if the list is empty and owns no pooled entries */
   HSHM_CROSS_FUN
-  bool IsNull() const { return length_ == 0; }
+  bool IsNull() const { return length_ == 0 && pool_.IsNull(); }
 
   /** Sets this list as empty */
   HSHM_CROSS_FUN
@@ -351,6 +361,7 @@ class list : public ShmContainer {
     length_ = 0;
     head_ptr_.SetNull();
     tail_ptr_.SetNull();
+    pool_.SetNull();
   }
 
   /**====================================
@@ -390,20 +401,29 @@ class list : public ShmContainer {
     } else if (pos.is_begin()) {
       entry->prior_ptr_.SetNull();
       entry->next_ptr_ = head_ptr_;
-      auto head = GetAllocator()->template Convert<list_entry<T>>(tail_ptr_);
+      auto head =
+          GetAllocator()
+              ->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+                  head_ptr_);
       head->prior_ptr_ = entry_ptr;
       head_ptr_ = entry_ptr;
     } else if (pos.is_end()) {
       entry->prior_ptr_ = tail_ptr_;
       entry->next_ptr_.SetNull();
-      auto tail = GetAllocator()->template Convert<list_entry<T>>(tail_ptr_);
+      auto tail =
+          GetAllocator()
+              ->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+                  tail_ptr_);
       tail->next_ptr_ = entry_ptr;
       tail_ptr_ = entry_ptr;
     } else {
-      auto next = GetAllocator()->template Convert<list_entry<T>>(
-          pos.entry_->next_ptr_);
-      auto prior = GetAllocator()->template Convert<list_entry<T>>(
-          pos.entry_->prior_ptr_);
+      auto next = GetAllocator()
+                      ->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>,
+                                         OffsetPointer>(pos.entry_->next_ptr_);
+      auto prior =
+          GetAllocator()
+              ->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>,
+                                 OffsetPointer>(pos.entry_->prior_ptr_);
       entry->next_ptr_ = pos.entry_->next_ptr_;
       entry->prior_ptr_ = pos.entry_->prior_ptr_;
       next->prior_ptr_ = entry_ptr;
@@ -429,12 +449,12 @@ class list : public ShmContainer {
     if (first.is_end()) {
       return;
     }
-    auto first_prior_ptr = first.entry_->prior_ptr_;
+    OffsetPointer first_prior_ptr = first.entry_->prior_ptr_;
     auto pos = first;
     while (pos != last) {
       auto next = pos + 1;
       HSHM_DESTROY_AR(pos.entry_->data_)
-      GetAllocator()->Free(GetMemCtx(), pos.entry_ptr_);
+      pool_.Free(GetAllocator(), GetMemCtx(), pos.entry_ptr_, pos.entry_);
       --length_;
       pos = next;
     }
@@ -443,7 +463,9 @@ class list : public ShmContainer {
       head_ptr_ = last.entry_ptr_;
     } else {
       auto first_prior =
-          GetAllocator()->template Convert<list_entry<T>>(first_prior_ptr);
+          GetAllocator()
+              ->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+                  first_prior_ptr);
       first_prior->next_ptr_ = last.entry_ptr_;
     }
 
@@ -454,9 +476,34 @@ class list : public ShmContainer {
     }
   }
 
-  /** Destroy all elements in the list */
+  /** Destroy all elements in the list and free its pooled entries */
+  HSHM_CROSS_FUN
+  void clear() {
+    erase(begin(), end());
+    pool_.Release(GetAllocator(), GetMemCtx());
+  }
+
+  /**
+   * Allocate entries in chunks of \a count, recycling erased entries
+   * within this list instead of freeing them. 0 allocates every entry
+   * individually (the default). The list must be empty.
+   *
+   * @return false, leaving the chunk size unchanged, if the list is not
+   * empty
+   * */
+  HSHM_CROSS_FUN
+  bool set_node_chunk(u32 count) {
+    if (length_ != 0) {
+      return false;
+    }
+    pool_.Release(GetAllocator(), GetMemCtx());
+    pool_.chunk_nodes_ = count;
+    return true;
+  }
+
+  /** Get the number of entries allocated per chunk */
   HSHM_CROSS_FUN
-  void clear() { erase(begin(), end()); }
+  u32 get_node_chunk() const { return pool_.chunk_nodes_; }
 
   /** Get the object at the front of the list */
   HSHM_CROSS_FUN
@@ -484,7 +531,9 @@ class list : public ShmContainer {
     if (size() == 0) {
       return end();
     }
-    auto head = GetAllocator()->template Convert<list_entry<T>>(head_ptr_);
+    auto head =
+        GetAllocator()->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+            head_ptr_);
     return iterator_t(*this, head, head_ptr_);
   }
 
@@ -494,7 +543,9 @@ class list : public ShmContainer {
     if (size() == 0) {
       return end();
     }
-    auto tail = GetAllocator()->template Convert<list_entry<T>>(tail_ptr_);
+    auto tail =
+        GetAllocator()->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+            tail_ptr_);
     return iterator_t(*this, tail, tail_ptr_);
   }
 
@@ -510,7 +561,9 @@ class list : public ShmContainer {
     if (size() == 0) {
       return cend();
     }
-    auto head = GetAllocator()->template Convert<list_entry<T>>(head_ptr_);
+    auto head =
+        GetAllocator()->template Convert<list_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+            head_ptr_);
     return citerator_t(const_cast<list &>(*this), head, head_ptr_);
   }
 
@@ -539,10 +592,9 @@ class list : public ShmContainer {
 
  private:
   template <typename... Args>
-  HSHM_INLINE_CROSS_FUN list_entry<T> *_create_entry(OffsetPointer &p,
-                                                     Args &&...args) {
-    auto entry =
-        GetAllocator()->template AllocateObjs<list_entry<T>>(GetMemCtx(), 1, p);
+  HSHM_INLINE_CROSS_FUN list_entry<T, HSHM_CLASS_TEMPL_ARGS> *_create_entry(
+      OffsetPointer &p, Args &&...args) {
+    auto entry = pool_.Allocate(GetAllocator(), GetMemCtx(), p);
     HSHM_MAKE_AR(entry->data_, GetCtxAllocator(), std::forward<Args>(args)...)
     return entry;
   }
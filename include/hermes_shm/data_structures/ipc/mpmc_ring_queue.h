@@ -0,0 +1,345 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_MPMC_RING_QUEUE_H_
+#define HSHM_DATA_STRUCTURES_IPC_MPMC_RING_QUEUE_H_
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/types/numbers.h"
+#include "hermes_shm/types/qtok.h"
+#include "ring_queue.h"
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/** Forward declaration of mpmc_ring_queue */
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class mpmc_ring_queue;
+
+/**
+ * MACROS used to simplify the mpmc_ring_queue namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME mpmc_ring_queue
+#define CLASS_NEW_ARGS T
+
+/**
+ * A bounded lock-free queue for multiple producers and multiple consumers.
+ *
+ * Each slot carries a sequence number (Vyukov). A slot at position pos is
+ * free for the producer of pos when its sequence equals pos, and ready for
+ * the consumer of pos when it equals pos + 1. Both ends claim positions
+ * with a CAS only after observing the slot in the expected state, so a
+ * full or empty queue never needs to roll back an index. The depth is
+ * rounded up to a power of two.
+ * */
+template <typename T, HSHM_CLASS_TEMPL>
+class mpmc_ring_queue : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+
+ public:
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef vector<T, HSHM_CLASS_TEMPL_ARGS> vector_t;
+  typedef vector<hipc::atomic<qtok_id>, HSHM_CLASS_TEMPL_ARGS> seq_vector_t;
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<vector_t> queue_;
+  delay_ar<seq_vector_t> seq_;
+  ring_queue_pad<true> pad0_;
+  hipc::atomic<qtok_id> tail_;
+  ring_queue_pad<true> pad1_;
+  hipc::atomic<qtok_id> head_;
+  ring_queue_pad<true> pad2_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  template <typename... Args>
+  HSHM_CROSS_FUN explicit mpmc_ring_queue(size_t depth = 1024,
+                                          Args &&...args) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), depth,
+             std::forward<Args>(args)...);
+  }
+
+  /** SHM constructor. Default. */
+  template <typename... Args>
+  HSHM_CROSS_FUN explicit mpmc_ring_queue(
+      const hipc::CtxAllocator<AllocT> &alloc, size_t depth = 1024,
+      Args &&...args) {
+    shm_init(alloc, depth, std::forward<Args>(args)...);
+  }
+
+  /** SHM Constructor */
+  template <typename... Args>
+  HSHM_CROSS_FUN void shm_init(const hipc::CtxAllocator<AllocT> &alloc,
+                               size_t depth = 1024, Args &&...args) {
+    init_shm_container(alloc);
+    depth = hshm::RoundUpPow2(depth);
+    HSHM_MAKE_AR(queue_, GetCtxAllocator(), depth, std::forward<Args>(args)...);
+    HSHM_MAKE_AR(seq_, GetCtxAllocator(), depth);
+    SetNull();
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** SHM copy constructor */
+  HSHM_CROSS_FUN
+  explicit mpmc_ring_queue(const hipc::CtxAllocator<AllocT> &alloc,
+                           const mpmc_ring_queue &other) {
+    init_shm_container(alloc);
+    HSHM_MAKE_AR(queue_, GetCtxAllocator(), other.queue_->size());
+    HSHM_MAKE_AR(seq_, GetCtxAllocator(), other.seq_->size());
+    shm_strong_copy_op(other);
+  }
+
+  /** SHM copy assignment operator */
+  HSHM_CROSS_FUN
+  mpmc_ring_queue &operator=(const mpmc_ring_queue &other) {
+    if (this != &other) {
+      shm_strong_copy_op(other);
+    }
+    return *this;
+  }
+
+  /** SHM copy constructor + operator main */
+  HSHM_CROSS_FUN
+  void shm_strong_copy_op(const mpmc_ring_queue &other) {
+    head_ = other.head_.load();
+    tail_ = other.tail_.load();
+    (*queue_) = (*other.queue_);
+    (*seq_) = (*other.seq_);
+  }
+
+  /**====================================
+   * Move Constructors
+   * ===================================*/
+
+  /** Move constructor. */
+  HSHM_CROSS_FUN
+  mpmc_ring_queue(mpmc_ring_queue &&other) noexcept {
+    shm_move_op<false>(other.GetCtxAllocator(),
+                       std::forward<mpmc_ring_queue>(other));
+  }
+
+  /** SHM move constructor. */
+  HSHM_CROSS_FUN
+  mpmc_ring_queue(const hipc::CtxAllocator<AllocT> &alloc,
+                  mpmc_ring_queue &&other) noexcept {
+    shm_move_op<false>(alloc, std::forward<mpmc_ring_queue>(other));
+  }
+
+  /** SHM move assignment operator. */
+  HSHM_CROSS_FUN
+  mpmc_ring_queue &operator=(mpmc_ring_queue &&other) noexcept {
+    if (this != &other) {
+      shm_move_op<true>(other.GetCtxAllocator(),
+                        std::forward<mpmc_ring_queue>(other));
+    }
+    return *this;
+  }
+
+  /** SHM move assignment operator. */
+  template <bool IS_ASSIGN>
+  HSHM_CROSS_FUN void shm_move_op(const hipc::CtxAllocator<AllocT> &alloc,
+                                  mpmc_ring_queue &&other) noexcept {
+    if constexpr (!IS_ASSIGN) {
+      init_shm_container(alloc);
+      HSHM_MAKE_AR(queue_, GetCtxAllocator(), 0);
+      HSHM_MAKE_AR(seq_, GetCtxAllocator(), 0);
+    }
+    if (GetAllocator() == other.GetAllocator()) {
+      head_ = other.head_.load();
+      tail_ = other.tail_.load();
+      (*queue_) = std::move(*other.queue_);
+      (*seq_) = std::move(*other.seq_);
+      other.SetNull();
+    } else {
+      shm_strong_copy_op(other);
+      other.shm_destroy();
+    }
+  }
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor.  */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    (*queue_).shm_destroy();
+    (*seq_).shm_destroy();
+  }
+
+  /** Check if the queue is empty */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*queue_).IsNull(); }
+
+  /** Sets this queue as empty */
+  HSHM_CROSS_FUN
+  void SetNull() {
+    head_ = 0;
+    tail_ = 0;
+    seq_vector_t &seq = (*seq_);
+    for (size_t i = 0; i < seq.size(); ++i) {
+      seq[i].store(i);
+    }
+  }
+
+  /**====================================
+   * MPMC Queue Methods
+   * ===================================*/
+
+  /** Construct an element at the tail of the queue. Null if full. */
+  template <typename... Args>
+  HSHM_CROSS_FUN qtok_t emplace(Args &&...args) {
+    seq_vector_t &seq = (*seq_);
+    size_t mask = seq.size() - 1;
+    qtok_id tail = tail_.load(std::memory_order_relaxed);
+    size_t idx;
+    while (true) {
+      idx = (size_t)(tail & mask);
+      qtok_id slot_seq = seq[idx].load(std::memory_order_acquire);
+      hshm::i64 diff = (hshm::i64)slot_seq - (hshm::i64)tail;
+      if (diff == 0) {
+        // The slot is free for this position, claim it
+        if (tail_.compare_exchange_weak(tail, tail + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // The consumer of the previous lap has not freed the slot yet
+        return qtok_t::GetNull();
+      } else {
+        // Another producer claimed this position
+        tail = tail_.load(std::memory_order_relaxed);
+      }
+    }
+
+    // Emplace into queue at our slot and publish it to consumers
+    vector_t &queue = (*queue_);
+    queue.replace(queue.begin() + idx, std::forward<Args>(args)...);
+    seq[idx].store(tail + 1, std::memory_order_release);
+    return qtok_t(tail);
+  }
+
+  /** Push an element in the queue (wrapper) */
+  template <typename... Args>
+  HSHM_INLINE_CROSS_FUN qtok_t push(Args &&...args) {
+    return emplace(std::forward<Args>(args)...);
+  }
+
+  /** Consumer pops the head object. Null if empty. */
+  HSHM_CROSS_FUN
+  qtok_t pop(T &val) {
+    size_t idx;
+    qtok_t tok = ClaimHead(idx);
+    if (tok.IsNull()) {
+      return tok;
+    }
+    val = std::move((*queue_)[idx]);
+    ReleaseSlot(idx, tok.id_);
+    return tok;
+  }
+
+  /** Consumer pops the head object, discarding it */
+  HSHM_CROSS_FUN
+  qtok_t pop() {
+    size_t idx;
+    qtok_t tok = ClaimHead(idx);
+    if (tok.IsNull()) {
+      return tok;
+    }
+    ReleaseSlot(idx, tok.id_);
+    return tok;
+  }
+
+  /** Get queue depth */
+  HSHM_CROSS_FUN
+  size_t GetDepth() { return queue_->size(); }
+
+  /** Get size at this moment */
+  HSHM_CROSS_FUN
+  size_t GetSize() {
+    size_t tail = tail_.load();
+    size_t head = head_.load();
+    if (tail < head) {
+      return 0;
+    }
+    return tail - head;
+  }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t size() { return GetSize(); }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t Size() { return GetSize(); }
+
+ private:
+  /** Claim the head position if its slot is ready. Null if empty. */
+  HSHM_INLINE_CROSS_FUN
+  qtok_t ClaimHead(size_t &idx) {
+    seq_vector_t &seq = (*seq_);
+    size_t mask = seq.size() - 1;
+    qtok_id head = head_.load(std::memory_order_relaxed);
+    while (true) {
+      idx = (size_t)(head & mask);
+      qtok_id slot_seq = seq[idx].load(std::memory_order_acquire);
+      hshm::i64 diff = (hshm::i64)slot_seq - (hshm::i64)(head + 1);
+      if (diff == 0) {
+        // The slot is ready for this position, claim it
+        if (head_.compare_exchange_weak(head, head + 1,
+                                        std::memory_order_relaxed)) {
+          return qtok_t(head);
+        }
+      } else if (diff < 0) {
+        // The producer of this position has not published yet
+        return qtok_t::GetNull();
+      } else {
+        // Another consumer claimed this position
+        head = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /** Hand the slot of \a head to the producer of the next lap */
+  HSHM_INLINE_CROSS_FUN
+  void ReleaseSlot(size_t idx, qtok_id head) {
+    (*seq_)[idx].store(head + (*seq_).size(), std::memory_order_release);
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using mpmc_ring_queue = hipc::mpmc_ring_queue<T, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_MPMC_RING_QUEUE_H_
@@ -0,0 +1,364 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_MPMC_SEGMENT_QUEUE_H_
+#define HSHM_DATA_STRUCTURES_IPC_MPMC_SEGMENT_QUEUE_H_
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/memory/memory.h"
+#include "hermes_shm/types/qtok.h"
+#include "epoch_manager.h"
+#include "ring_queue.h"
+
+namespace hshm::ipc {
+
+/** Header of an mpmc_segment_queue segment. Its slots follow it. */
+struct segment_queue_header {
+  hipc::atomic<hshm::size_t> enq_; /**< Next slot claimed by producers */
+  ring_queue_pad<true> pad0_;
+  hipc::atomic<hshm::size_t> deq_; /**< Next slot claimed by consumers */
+  ring_queue_pad<true> pad1_;
+  AtomicOffsetPointer next_; /**< The next segment, or null */
+  hshm::size_t id_;          /**< The position of this segment in the queue */
+};
+
+/** A slot of an mpmc_segment_queue segment */
+template <typename T>
+struct segment_queue_slot {
+  hipc::atomic<hshm::u32> state_;
+  delay_ar<T> data_;
+};
+
+/** Forward declaration of mpmc_segment_queue */
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class mpmc_segment_queue;
+
+/**
+ * MACROS used to simplify the mpmc_segment_queue namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME mpmc_segment_queue
+#define CLASS_NEW_ARGS T
+
+/**
+ * An unbounded lock-free queue for multiple producers and consumers.
+ *
+ * The queue is a linked list of fixed-size segments (FAA array queue).
+ * Producers and consumers claim slots within the tail and head segments
+ * with a fetch_add. A consumer which reaches a slot before its producer
+ * marks it taken, and that producer retries in a later slot. Once a
+ * segment is filled, a producer links the next segment. Once a segment
+ * is drained, it is retired to an epoch_manager and freed when no thread
+ * can still reference it.
+ *
+ * Each thread must Register a MemContext with the queue before using it,
+ * and pass it to every operation. A MemContext is registered with one
+ * queue or map at a time.
+ * */
+template <typename T, HSHM_CLASS_TEMPL>
+class mpmc_segment_queue : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+
+ public:
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef segment_queue_slot<T> slot_t;
+  typedef epoch_manager<epoch_no_destroy, HSHM_CLASS_TEMPL_ARGS>
+      epoch_manager_t;
+
+  /** Slot states */
+  CLS_CONST hshm::u32 kEmpty = 0;
+  CLS_CONST hshm::u32 kReady = 1;
+  CLS_CONST hshm::u32 kTaken = 2;
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<epoch_manager_t> epochs_;
+  hshm::size_t seg_size_;
+  ring_queue_pad<true> pad0_;
+  AtomicOffsetPointer tail_;
+  ring_queue_pad<true> pad1_;
+  AtomicOffsetPointer head_;
+  ring_queue_pad<true> pad2_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit mpmc_segment_queue(size_t seg_size = 1024,
+                              size_t max_threads = 1024) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), seg_size,
+             max_threads);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit mpmc_segment_queue(const hipc::CtxAllocator<AllocT> &alloc,
+                              size_t seg_size = 1024,
+                              size_t max_threads = 1024) {
+    shm_init(alloc, seg_size, max_threads);
+  }
+
+  /** SHM Constructor */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc,
+                size_t seg_size = 1024, size_t max_threads = 1024) {
+    init_shm_container(alloc);
+    HSHM_MAKE_AR(epochs_, GetCtxAllocator(), max_threads);
+    seg_size_ = seg_size;
+    size_t seg_off = AllocateSegment(GetMemCtx(), 0);
+    head_ = seg_off;
+    tail_ = seg_off;
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Segments are shared with concurrent threads; copying is disabled */
+  mpmc_segment_queue(const mpmc_segment_queue &other) = delete;
+
+  /** Segments are shared with concurrent threads; copying is disabled */
+  mpmc_segment_queue &operator=(const mpmc_segment_queue &other) = delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor. Destroys remaining entries and frees all segments. */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    hipc::MemContext ctx = GetMemCtx();
+    size_t seg_off = head_.load();
+    while (seg_off != OffsetPointer::GetNull().load()) {
+      segment_queue_header *seg = GetSegment(seg_off);
+      size_t end = seg->enq_.load();
+      if (end > seg_size_) {
+        end = seg_size_;
+      }
+      for (size_t i = 0; i < end; ++i) {
+        slot_t &slot = GetSlot(seg, i);
+        if (slot.state_.load() == kReady) {
+          HSHM_DESTROY_AR(slot.data_);
+        }
+      }
+      size_t next_off = seg->next_.load();
+      FreeSegment(ctx, seg_off);
+      seg_off = next_off;
+    }
+    (*epochs_).shm_destroy();
+  }
+
+  /** Check if the queue is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*epochs_).IsNull(); }
+
+  /** Sets this queue as null */
+  HSHM_CROSS_FUN
+  void SetNull() {}
+
+  /**====================================
+   * Thread Registration
+   * ===================================*/
+
+  /** Register the calling thread's \a ctx. False if no slots are free. */
+  HSHM_CROSS_FUN
+  bool Register(hipc::MemContext &ctx) { return (*epochs_).Register(ctx); }
+
+  /** Unregister \a ctx, handing off any segments it retired */
+  HSHM_CROSS_FUN
+  void Unregister(hipc::MemContext &ctx) { (*epochs_).Unregister(ctx); }
+
+  /**====================================
+   * MPMC Queue Methods
+   * ===================================*/
+
+  /** Construct an element at the tail of the queue */
+  template <typename... Args>
+  HSHM_CROSS_FUN qtok_t emplace(const hipc::MemContext &ctx, Args &&...args) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    delay_ar<T> *staged = nullptr;
+    while (true) {
+      size_t tail_off = tail_.load();
+      segment_queue_header *seg = GetSegment(tail_off);
+      size_t idx = seg->enq_.fetch_add(1);
+      if (idx < seg_size_) {
+        // Construct the entry in our slot, moving it from the slot of a
+        // previous attempt if a consumer gave up on that slot
+        slot_t &slot = GetSlot(seg, idx);
+        if (staged) {
+          HSHM_MAKE_AR(slot.data_, GetCtxAllocator(),
+                       std::move(staged->get_ref()));
+          HSHM_DESTROY_AR(*staged);
+        } else {
+          HSHM_MAKE_AR(slot.data_, GetCtxAllocator(),
+                       std::forward<Args>(args)...);
+        }
+        staged = &slot.data_;
+        hshm::u32 state = kEmpty;
+        if (slot.state_.compare_exchange_strong(state, kReady)) {
+          return qtok_t(seg->id_ * seg_size_ + idx);
+        }
+        continue;
+      }
+
+      // The tail segment is full: link a new segment or help advance tail_
+      if (tail_off != tail_.load()) {
+        continue;
+      }
+      size_t next_off = seg->next_.load();
+      if (next_off == OffsetPointer::GetNull().load()) {
+        size_t new_off = AllocateSegment(ctx, seg->id_ + 1);
+        if (seg->next_.compare_exchange_strong(next_off, new_off)) {
+          next_off = new_off;
+        } else {
+          FreeSegment(ctx, new_off);
+        }
+      }
+      tail_.compare_exchange_strong(tail_off, next_off);
+    }
+  }
+
+  /** Push an element in the queue (wrapper) */
+  template <typename... Args>
+  HSHM_INLINE_CROSS_FUN qtok_t push(const hipc::MemContext &ctx,
+                                    Args &&...args) {
+    return emplace(ctx, std::forward<Args>(args)...);
+  }
+
+  /** Consumer pops the head object. Null if empty. */
+  HSHM_CROSS_FUN
+  qtok_t pop(const hipc::MemContext &ctx, T &val) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    while (true) {
+      size_t head_off = head_.load();
+      segment_queue_header *seg = GetSegment(head_off);
+      if (seg->deq_.load() >= seg->enq_.load() &&
+          seg->next_.load() == OffsetPointer::GetNull().load()) {
+        return qtok_t::GetNull();
+      }
+      size_t idx = seg->deq_.fetch_add(1);
+      if (idx >= seg_size_) {
+        // The head segment is drained: unlink and retire it
+        size_t next_off = seg->next_.load();
+        if (next_off == OffsetPointer::GetNull().load()) {
+          return qtok_t::GetNull();
+        }
+        size_t tail_off = head_off;
+        tail_.compare_exchange_strong(tail_off, next_off);
+        if (head_.compare_exchange_strong(head_off, next_off)) {
+          (*epochs_).Retire(ctx, OffsetPointer(head_off));
+        }
+        continue;
+      }
+
+      // Take the slot. If its producer has not published yet, it retries.
+      slot_t &slot = GetSlot(seg, idx);
+      if (slot.state_.exchange(kTaken) != kReady) {
+        continue;
+      }
+      val = std::move(slot.data_.get_ref());
+      HSHM_DESTROY_AR(slot.data_);
+      return qtok_t(seg->id_ * seg_size_ + idx);
+    }
+  }
+
+  /** Get the number of slots per segment */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetSegmentSize() const { return seg_size_; }
+
+  /** Get the number of entries at this moment */
+  HSHM_CROSS_FUN
+  size_t GetSize(const hipc::MemContext &ctx) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    segment_queue_header *head = GetSegment(head_.load());
+    segment_queue_header *tail = GetSegment(tail_.load());
+    size_t deq = head->deq_.load();
+    size_t enq = tail->enq_.load();
+    if (deq > seg_size_) {
+      deq = seg_size_;
+    }
+    if (enq > seg_size_) {
+      enq = seg_size_;
+    }
+    size_t head_pos = head->id_ * seg_size_ + deq;
+    size_t tail_pos = tail->id_ * seg_size_ + enq;
+    if (tail_pos < head_pos) {
+      return 0;
+    }
+    return tail_pos - head_pos;
+  }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t size(const hipc::MemContext &ctx) { return GetSize(ctx); }
+
+ private:
+  /** Allocate an empty segment at position \a id */
+  HSHM_CROSS_FUN
+  size_t AllocateSegment(const hipc::MemContext &ctx, size_t id) {
+    size_t size = sizeof(segment_queue_header) + seg_size_ * sizeof(slot_t);
+    FullPtr<char, OffsetPointer> p =
+        GetAllocator()->template AllocateLocalPtr<char, OffsetPointer>(ctx,
+                                                                       size);
+    if (p.IsNull()) {
+      HSHM_THROW_ERROR(OUT_OF_MEMORY, size,
+                       GetAllocator()->GetCurrentlyAllocatedSize());
+    }
+    memset(p.ptr_, 0, size);
+    auto *seg = reinterpret_cast<segment_queue_header *>(p.ptr_);
+    seg->next_ = OffsetPointer::GetNull().load();
+    seg->id_ = id;
+    return p.shm_.load();
+  }
+
+  /** Free a segment which no thread can reference */
+  HSHM_INLINE_CROSS_FUN
+  void FreeSegment(const hipc::MemContext &ctx, size_t seg_off) {
+    OffsetPointer p(seg_off);
+    GetAllocator()->template Free<OffsetPointer>(ctx, p);
+  }
+
+  /** Convert a segment offset to a pointer */
+  HSHM_INLINE_CROSS_FUN
+  segment_queue_header *GetSegment(size_t seg_off) {
+    return GetAllocator()->template Convert<segment_queue_header>(
+        OffsetPointer(seg_off));
+  }
+
+  /** Get slot \a idx of \a seg */
+  HSHM_INLINE_CROSS_FUN
+  slot_t &GetSlot(segment_queue_header *seg, size_t idx) {
+    return reinterpret_cast<slot_t *>(seg + 1)[idx];
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using mpmc_segment_queue = hipc::mpmc_segment_queue<T, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_MPMC_SEGMENT_QUEUE_H_
@@ -0,0 +1,294 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_MULTI_PRIORITY_QUEUE_H_
+#define HSHM_DATA_STRUCTURES_IPC_MULTI_PRIORITY_QUEUE_H_
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/thread/lock.h"
+#include "hermes_shm/thread/thread_model_manager.h"
+#include "hermes_shm/types/qtok.h"
+#include "priority_queue.h"
+#include "ring_queue.h"
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/** The lock and entry count of one multi_priority_queue heap */
+struct multi_pq_lane {
+  Mutex lock_;
+  hipc::atomic<hshm::size_t> size_; /**< Entries in the heap */
+  ring_queue_pad<true> pad_;
+
+  /** Default constructor */
+  HSHM_INLINE_CROSS_FUN
+  multi_pq_lane() : size_(0) {}
+
+  /** Copy constructor. The copy starts unlocked. */
+  HSHM_INLINE_CROSS_FUN
+  multi_pq_lane(const multi_pq_lane &other)
+      : lock_(), size_(other.size_.load()) {}
+};
+
+/** Forward declaration of multi_priority_queue */
+template <typename T, class Compare = std::less<T>,
+          HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class multi_priority_queue;
+
+/**
+ * MACROS used to simplify the multi_priority_queue namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME multi_priority_queue
+#define CLASS_NEW_ARGS T, Compare
+
+/**
+ * A concurrent priority queue with relaxed ordering (MultiQueue). Entries
+ * are spread over several heaps, each behind its own lock. A push locks a
+ * random heap. A pop locks two random heaps and takes the greater of
+ * their tops, so it returns an entry near the top of the whole queue
+ * rather than the exact top. There is no central lock: a busy heap is
+ * skipped instead of waited on. A pop only fails once every heap has been
+ * seen empty.
+ * */
+template <typename T, class Compare, HSHM_CLASS_TEMPL>
+class multi_priority_queue : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+
+ public:
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef priority_queue<T, Compare, HSHM_CLASS_TEMPL_ARGS> heap_t;
+  typedef vector<heap_t, HSHM_CLASS_TEMPL_ARGS> heap_vector_t;
+  typedef vector<multi_pq_lane, HSHM_CLASS_TEMPL_ARGS> lane_vector_t;
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<heap_vector_t> heaps_;
+  delay_ar<lane_vector_t> lanes_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit multi_priority_queue(size_t nheaps = 0) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), nheaps);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit multi_priority_queue(const hipc::CtxAllocator<AllocT> &alloc,
+                                size_t nheaps = 0) {
+    shm_init(alloc, nheaps);
+  }
+
+  /** SHM constructor. Defaults to two heaps per CPU. */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc, size_t nheaps = 0) {
+    init_shm_container(alloc);
+    if (nheaps == 0) {
+      nheaps = 2 * HSHM_SYSTEM_INFO->ncpu_;
+    }
+    HSHM_MAKE_AR(heaps_, GetCtxAllocator(), nheaps);
+    HSHM_MAKE_AR(lanes_, GetCtxAllocator(), nheaps);
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Heaps are shared with concurrent workers; copying is disabled */
+  multi_priority_queue(const multi_priority_queue &other) = delete;
+
+  /** Heaps are shared with concurrent workers; copying is disabled */
+  multi_priority_queue &operator=(const multi_priority_queue &other) = delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor.  */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    (*heaps_).shm_destroy();
+    (*lanes_).shm_destroy();
+  }
+
+  /** Check if the queue is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*heaps_).IsNull(); }
+
+  /** Sets this queue as null */
+  HSHM_CROSS_FUN
+  void SetNull() {}
+
+  /**====================================
+   * Priority Queue Methods
+   * ===================================*/
+
+  /** Construct an entry in a random heap. Returns the heap used. */
+  template <typename... Args>
+  HSHM_CROSS_FUN qtok_t emplace(Args &&...args) {
+    size_t nheaps = GetNumHeaps();
+    hshm::u64 seed = GetSeed();
+    for (size_t attempt = 1;; ++attempt) {
+      size_t i = Next(seed) % nheaps;
+      multi_pq_lane &lane = (*lanes_)[i];
+      if (!lane.lock_.TryLock(0)) {
+        if (attempt % nheaps == 0) {
+          HSHM_THREAD_MODEL->Yield();
+        }
+        continue;
+      }
+      (*heaps_)[i].emplace(std::forward<Args>(args)...);
+      lane.size_.fetch_add(1);
+      lane.lock_.Unlock();
+      return qtok_t(i);
+    }
+  }
+
+  /** Push an entry (wrapper) */
+  template <typename... Args>
+  HSHM_INLINE_CROSS_FUN qtok_t push(Args &&...args) {
+    return emplace(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Pop the greater top of two random heaps into \a val. Returns the heap
+   * used. Null if every heap was empty.
+   * */
+  HSHM_CROSS_FUN
+  qtok_t pop(T &val) {
+    size_t nheaps = GetNumHeaps();
+    hshm::u64 seed = GetSeed();
+    for (size_t attempt = 0; attempt < 2 * nheaps; ++attempt) {
+      size_t i = Next(seed) % nheaps;
+      size_t j = Next(seed) % nheaps;
+      if (!IsNonEmpty(i)) {
+        if (!IsNonEmpty(j)) {
+          continue;
+        }
+        i = j;
+      }
+      if (!(*lanes_)[i].lock_.TryLock(0)) {
+        continue;
+      }
+      if (j != i && IsNonEmpty(j) && (*lanes_)[j].lock_.TryLock(0)) {
+        heap_t &a = (*heaps_)[i];
+        heap_t &b = (*heaps_)[j];
+        if (a.empty() || (!b.empty() && Compare{}(a.top(), b.top()))) {
+          std::swap(i, j);
+        }
+        (*lanes_)[j].lock_.Unlock();
+      }
+      if (PopLocked(i, val)) {
+        return qtok_t(i);
+      }
+    }
+    // Sampling found nothing: sweep every heap before reporting empty
+    for (size_t i = 0; i < nheaps; ++i) {
+      if (!IsNonEmpty(i)) {
+        continue;
+      }
+      (*lanes_)[i].lock_.Lock(0);
+      if (PopLocked(i, val)) {
+        return qtok_t(i);
+      }
+    }
+    return qtok_t::GetNull();
+  }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** Get the number of heaps */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetNumHeaps() const { return (*heaps_).size(); }
+
+  /** Get the number of entries at this moment */
+  HSHM_CROSS_FUN
+  size_t GetSize() {
+    size_t size = 0;
+    for (size_t i = 0; i < GetNumHeaps(); ++i) {
+      size += (*lanes_)[i].size_.load();
+    }
+    return size;
+  }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t size() { return GetSize(); }
+
+ private:
+  /** Check the entry count of heap \a i without locking it */
+  HSHM_INLINE_CROSS_FUN
+  bool IsNonEmpty(size_t i) {
+    return (*lanes_)[i].size_.load(std::memory_order_relaxed) > 0;
+  }
+
+  /** Pop the top of heap \a i, whose lock is held, and unlock it */
+  HSHM_CROSS_FUN
+  bool PopLocked(size_t i, T &val) {
+    multi_pq_lane &lane = (*lanes_)[i];
+    bool found = (*heaps_)[i].pop(val);
+    if (found) {
+      lane.size_.fetch_sub(1);
+    }
+    lane.lock_.Unlock();
+    return found;
+  }
+
+  /** Seed the heap choices of one operation */
+  HSHM_INLINE_CROSS_FUN
+  static hshm::u64 GetSeed() {
+#ifdef HSHM_IS_HOST
+    // Each thread continues its own sequence; no shared state is touched
+    static thread_local hshm::u64 seed = HSHM_THREAD_MODEL->GetTid().tid_;
+    return seed += 0x632be59bd9b4e019ULL;
+#else
+    return HSHM_THREAD_MODEL->GetTid().tid_;
+#endif
+  }
+
+  /** The next random number of \a seed (splitmix64) */
+  HSHM_INLINE_CROSS_FUN
+  static hshm::u64 Next(hshm::u64 &seed) {
+    hshm::u64 x = (seed += 0x9e3779b97f4a7c15ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename T, class Compare = std::less<T>,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using multi_priority_queue =
+    hipc::multi_priority_queue<T, Compare, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_MULTI_PRIORITY_QUEUE_H_
@@ -0,0 +1,310 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_PRIORITY_QUEUE_H_
+#define HSHM_DATA_STRUCTURES_IPC_PRIORITY_QUEUE_H_
+
+#include <functional>
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/** Forward declaration of priority_queue */
+template <typename T, class Compare = std::less<T>,
+          HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class priority_queue;
+
+/**
+ * MACROS used to simplify the priority_queue namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME priority_queue
+#define CLASS_NEW_ARGS T, Compare
+
+/**
+ * A priority queue stored as a 4-ary heap in a hipc::vector. As with
+ * std::priority_queue, top() is the greatest entry under Compare, so
+ * std::greater gives a min-queue (e.g., earliest deadline first). A
+ * 4-ary heap is half as deep as a binary one and its children share a
+ * cache line for small T. Not thread-safe; see multi_priority_queue.
+ * */
+template <typename T, class Compare, HSHM_CLASS_TEMPL>
+class priority_queue : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+
+ public:
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef vector<T, HSHM_CLASS_TEMPL_ARGS> vector_t;
+  static constexpr size_t kArity = 4;
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<vector_t> heap_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit priority_queue(size_t reserve = 0) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), reserve);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit priority_queue(const hipc::CtxAllocator<AllocT> &alloc,
+                          size_t reserve = 0) {
+    shm_init(alloc, reserve);
+  }
+
+  /** SHM constructor */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc, size_t reserve = 0) {
+    init_shm_container(alloc);
+    HSHM_MAKE_AR0(heap_, GetCtxAllocator());
+    if (reserve) {
+      (*heap_).reserve(reserve);
+    }
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Copy constructor */
+  HSHM_CROSS_FUN
+  explicit priority_queue(const priority_queue &other) {
+    init_shm_container(other.GetCtxAllocator());
+    HSHM_MAKE_AR0(heap_, GetCtxAllocator());
+    shm_strong_copy_op(other);
+  }
+
+  /** SHM copy constructor */
+  HSHM_CROSS_FUN
+  explicit priority_queue(const hipc::CtxAllocator<AllocT> &alloc,
+                          const priority_queue &other) {
+    init_shm_container(alloc);
+    HSHM_MAKE_AR0(heap_, GetCtxAllocator());
+    shm_strong_copy_op(other);
+  }
+
+  /** SHM copy assignment operator */
+  HSHM_CROSS_FUN
+  priority_queue &operator=(const priority_queue &other) {
+    if (this != &other) {
+      shm_strong_copy_op(other);
+    }
+    return *this;
+  }
+
+  /** SHM copy constructor + operator main */
+  HSHM_CROSS_FUN
+  void shm_strong_copy_op(const priority_queue &other) {
+    (*heap_) = (*other.heap_);
+  }
+
+  /**====================================
+   * Move Constructors
+   * ===================================*/
+
+  /** Move constructor. */
+  HSHM_CROSS_FUN
+  priority_queue(priority_queue &&other) noexcept {
+    shm_move_op<false>(other.GetCtxAllocator(), std::move(other));
+  }
+
+  /** SHM move constructor. */
+  HSHM_CROSS_FUN
+  priority_queue(const hipc::CtxAllocator<AllocT> &alloc,
+                 priority_queue &&other) noexcept {
+    shm_move_op<false>(alloc, std::move(other));
+  }
+
+  /** SHM move assignment operator. */
+  HSHM_CROSS_FUN
+  priority_queue &operator=(priority_queue &&other) noexcept {
+    if (this != &other) {
+      shm_move_op<true>(GetCtxAllocator(), std::move(other));
+    }
+    return *this;
+  }
+
+  /** SHM move assignment operator. */
+  template <bool IS_ASSIGN>
+  HSHM_CROSS_FUN void shm_move_op(const hipc::CtxAllocator<AllocT> &alloc,
+                                  priority_queue &&other) noexcept {
+    if constexpr (!IS_ASSIGN) {
+      init_shm_container(alloc);
+      HSHM_MAKE_AR0(heap_, GetCtxAllocator());
+    }
+    (*heap_) = std::move(*other.heap_);
+  }
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor.  */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() { (*heap_).shm_destroy(); }
+
+  /** Check if the queue is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*heap_).IsNull(); }
+
+  /** Sets this queue as null */
+  HSHM_CROSS_FUN
+  void SetNull() {}
+
+  /**====================================
+   * Priority Queue Methods
+   * ===================================*/
+
+  /** Construct an entry and sift it up to its place */
+  template <typename... Args>
+  HSHM_CROSS_FUN void emplace(Args &&...args) {
+    vector_t &heap = (*heap_);
+    heap.emplace_back(std::forward<Args>(args)...);
+    SiftUp(heap, heap.size() - 1);
+  }
+
+  /** Push an entry (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  void push(const T &val) { emplace(val); }
+
+  /** Push an entry (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  void push(T &&val) { emplace(std::move(val)); }
+
+  /** The greatest entry. The queue must not be empty. */
+  HSHM_INLINE_CROSS_FUN
+  T &top() { return (*heap_)[0]; }
+
+  /** The greatest entry. The queue must not be empty. */
+  HSHM_INLINE_CROSS_FUN
+  const T &top() const { return (*heap_)[0]; }
+
+  /** Remove the greatest entry. The queue must not be empty. */
+  HSHM_CROSS_FUN
+  void pop() {
+    vector_t &heap = (*heap_);
+    size_t last = heap.size() - 1;
+    if (last > 0) {
+      heap[0] = std::move(heap[last]);
+    }
+    heap.pop_back();
+    if (last > 1) {
+      SiftDown(heap, 0);
+    }
+  }
+
+  /** Move the greatest entry into \a val. False if empty. */
+  HSHM_CROSS_FUN
+  bool pop(T &val) {
+    if (empty()) {
+      return false;
+    }
+    val = std::move(top());
+    pop();
+    return true;
+  }
+
+  /** Remove every entry */
+  HSHM_INLINE_CROSS_FUN
+  void clear() { (*heap_).clear(); }
+
+  /** Reserve space for \a length entries */
+  HSHM_INLINE_CROSS_FUN
+  void reserve(size_t length) { (*heap_).reserve(length); }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** Get the number of entries */
+  HSHM_INLINE_CROSS_FUN
+  size_t size() const { return (*heap_).size(); }
+
+  /** Check if there are no entries */
+  HSHM_INLINE_CROSS_FUN
+  bool empty() const { return size() == 0; }
+
+  /** Get the number of entries (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetSize() const { return size(); }
+
+ private:
+  /** Move the entry at \a i up while it is greater than its parent */
+  HSHM_CROSS_FUN
+  static void SiftUp(vector_t &heap, size_t i) {
+    T val(std::move(heap[i]));
+    while (i > 0) {
+      size_t parent = (i - 1) / kArity;
+      if (!Compare{}(heap[parent], val)) {
+        break;
+      }
+      heap[i] = std::move(heap[parent]);
+      i = parent;
+    }
+    heap[i] = std::move(val);
+  }
+
+  /** Move the entry at \a i down while a child is greater */
+  HSHM_CROSS_FUN
+  static void SiftDown(vector_t &heap, size_t i) {
+    size_t count = heap.size();
+    T val(std::move(heap[i]));
+    while (true) {
+      size_t child = kArity * i + 1;
+      if (child >= count) {
+        break;
+      }
+      size_t end = child + kArity < count ? child + kArity : count;
+      size_t best = child;
+      for (size_t c = child + 1; c < end; ++c) {
+        if (Compare{}(heap[best], heap[c])) {
+          best = c;
+        }
+      }
+      if (!Compare{}(val, heap[best])) {
+        break;
+      }
+      heap[i] = std::move(heap[best]);
+      i = best;
+    }
+    heap[i] = std::move(val);
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename T, class Compare = std::less<T>,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using priority_queue = hipc::priority_queue<T, Compare, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_PRIORITY_QUEUE_H_
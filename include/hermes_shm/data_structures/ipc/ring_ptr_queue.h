@@ -201,19 +201,42 @@ class ring_ptr_queue_base : public ShmContainer {
   /** Construct an element at \a pos position in the list */
   template <typename... Args>
   HSHM_CROSS_FUN qtok_t emplace(const T &val) {
-    // Allocate a slot in the queue
-    // The slot is marked NULL, so pop won't do anything if context switch
+    qtok_t tok = reserve_n(1);
+    if (tok.IsNull()) {
+      return tok;
+    }
+    commit(tok.id_, val);
+    return tok;
+  }
+
+  /**
+   * Reserve \a count consecutive slots using a single atomic on tail_.
+   * Returns the token of the first slot. Each slot must be published
+   * using commit() before a consumer can pop past it. Returns null if
+   * \a count exceeds the depth of a fixed-size queue, since that many
+   * slots can never be free at once.
+   * */
+  HSHM_CROSS_FUN
+  qtok_t reserve_n(size_t count) {
+    if constexpr (!DynamicSize) {
+      if (count > GetDepth()) {
+        return qtok_t::GetNull();
+      }
+    }
+    // Allocate the slots in the queue
+    // The slots are marked NULL, so pop won't do anything if context switch
     qtok_id head = head_.load();
-    qtok_id tail = tail_.fetch_add(1);
+    qtok_id tail = tail_.fetch_add(qtok_id(count));
+    qtok_id last = tail + count - 1;
     vector_t &queue = (*queue_);
 
     // Check if there's space in the queue.
     if constexpr (WaitForSpace) {
-      size_t size = tail - head + 1;
+      size_t size = last - head + 1;
       if (size > queue.size()) {
         while (true) {
           head = head_.load();
-          size = tail - head + 1;
+          size = last - head + 1;
           if (size <= GetDepth()) {
             break;
           }
@@ -221,25 +244,43 @@ class ring_ptr_queue_base : public ShmContainer {
         }
       }
     } else if constexpr (ErrorOnNoSpace) {
-      size_t size = tail - head + 1;
+      size_t size = last - head + 1;
       if (size > queue.size()) {
-        tail_.fetch_sub(1);
+        tail_.fetch_sub(qtok_id(count));
         return qtok_t::GetNull();
       }
     } else if constexpr (DynamicSize) {
-      size_t size = tail - head + 1;
+      size_t size = last - head + 1;
       if (size > queue.size()) {
-        resize(queue.size() * 2);
+        size_t depth = queue.size() * 2;
+        while (depth < size) {
+          depth *= 2;
+        }
+        resize(depth);
       }
     }
+    return qtok_t(tail);
+  }
 
-    // Emplace into queue at our slot
-    size_t depth = queue.size();
-    uint32_t idx = tail % depth;
+  /** Store \a val in slot \a id (from reserve_n) and publish it */
+  HSHM_INLINE_CROSS_FUN
+  void commit(qtok_id id, const T &val) {
+    vector_t &queue = (*queue_);
+    size_t idx = id % queue.size();
     Mark(val, queue[idx]);
+  }
 
-    // Let pop know that the data is fully prepared
-    return qtok_t(tail);
+  /** Emplace \a count elements from \a vals using a single reservation */
+  HSHM_CROSS_FUN
+  qtok_t emplace_n(const T *vals, size_t count) {
+    qtok_t tok = reserve_n(count);
+    if (tok.IsNull()) {
+      return tok;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      commit(tok.id_ + i, vals[i]);
+    }
+    return tok;
   }
 
   /** Push an elemnt in the list (wrapper) */
@@ -276,6 +317,40 @@ class ring_ptr_queue_base : public ShmContainer {
     }
   }
 
+  /**
+   * Consumer pops up to \a count marked objects into \a vals, advancing
+   * head_ once for the whole batch. Stops at the first slot which has
+   * not been published yet. Returns the number of objects popped.
+   * */
+  HSHM_CROSS_FUN
+  size_t pop_n(T *vals, size_t count) {
+    // Don't pop if there's no entries
+    qtok_id head = head_.load();
+    qtok_id tail = tail_.load();
+    if (head >= tail) {
+      return 0;
+    }
+    if (count > tail - head) {
+      count = tail - head;
+    }
+
+    // Pop the elements, but only while they are marked valid
+    vector_t &queue = (*queue_);
+    size_t depth = queue.size();
+    size_t i = 0;
+    for (; i < count; ++i) {
+      T &entry = queue[(size_t)((head + i) % depth)];
+      if (!IsMarked(entry)) {
+        break;
+      }
+      Unmark(vals[i], entry);
+    }
+    if (i > 0) {
+      head_.fetch_add(qtok_id(i));
+    }
+    return i;
+  }
+
   /** Consumer pops the head object */
   HSHM_CROSS_FUN
   qtok_t pop() {
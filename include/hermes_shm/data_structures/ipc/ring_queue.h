@@ -15,6 +15,56 @@
 
 namespace hshm::ipc {
 
+/** Pads ring queue indices onto separate cache lines, if enabled */
+template <bool ENABLED>
+struct ring_queue_pad {
+  char pad_[HSHM_CACHE_LINE_SIZE];
+};
+
+/** No padding */
+template <>
+struct ring_queue_pad<false> {};
+
+/**
+ * The producer (tail_) and consumer (head_) indices of a ring_queue_base.
+ * The default layout is only the two indices.
+ * */
+template <bool FAST, bool PUSH_ATOMIC, bool POP_ATOMIC>
+struct ring_queue_indices {
+  hipc::opt_atomic<qtok_id, PUSH_ATOMIC> tail_;
+  hipc::opt_atomic<qtok_id, POP_ATOMIC> head_;
+};
+
+/**
+ * The FastLayout indices. tail_ and head_ sit on their own cache lines,
+ * each next to its side's cached copy of the other index.
+ * */
+template <bool PUSH_ATOMIC, bool POP_ATOMIC>
+struct ring_queue_indices<true, PUSH_ATOMIC, POP_ATOMIC> {
+  ring_queue_pad<true> pad0_;
+  hipc::opt_atomic<qtok_id, PUSH_ATOMIC> tail_;
+  /** Producer copy of head_. Never ahead of head_. */
+  hipc::opt_atomic<qtok_id, PUSH_ATOMIC> cached_head_;
+  ring_queue_pad<true> pad1_;
+  hipc::opt_atomic<qtok_id, POP_ATOMIC> head_;
+  /** Consumer copy of tail_. */
+  hipc::opt_atomic<qtok_id, POP_ATOMIC> cached_tail_;
+  ring_queue_pad<true> pad2_;
+};
+
+/** Futexes which blocking ring queues sleep on, if enabled */
+template <bool ENABLED>
+struct ring_queue_events {
+  /** Signaled when an entry is published */
+  Futex ready_;
+  /** Signaled when an entry is consumed */
+  Futex space_;
+};
+
+/** No futexes */
+template <>
+struct ring_queue_events<false> {};
+
 /** Forward declaration of ring_queue_base */
 template <typename T, RingQueueFlag RQ_FLAGS, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
 class ring_queue_base;
@@ -51,9 +101,9 @@ class ring_queue_base : public ShmContainer {
    * Variables
    * ===================================*/
   delay_ar<vector_t> queue_;
-  hipc::opt_atomic<qtok_id, IsPushAtomic> tail_;
-  hipc::opt_atomic<qtok_id, IsPopAtomic> head_;
+  ring_queue_indices<FastLayout, IsPushAtomic, IsPopAtomic> idx_;
   ibitfield flags_;
+  ring_queue_events<Blocking> events_;
 
  public:
   /**====================================
@@ -80,6 +130,9 @@ class ring_queue_base : public ShmContainer {
   HSHM_CROSS_FUN void shm_init(const hipc::CtxAllocator<AllocT> &alloc,
                                size_t depth = 1024, Args &&...args) {
     init_shm_container(alloc);
+    if constexpr (FastLayout) {
+      depth = hshm::RoundUpPow2(depth);
+    }
     HSHM_MAKE_AR(queue_, GetCtxAllocator(), depth, std::forward<Args>(args)...);
     flags_.Clear();
     SetNull();
@@ -111,8 +164,9 @@ class ring_queue_base : public ShmContainer {
   /** SHM copy constructor + operator main */
   HSHM_CROSS_FUN
   void shm_strong_copy_op(const ring_queue_base &other) {
-    head_ = other.head_.load();
-    tail_ = other.tail_.load();
+    idx_.head_ = other.idx_.head_.load();
+    idx_.tail_ = other.idx_.tail_.load();
+    SyncCachedIndices();
     (*queue_) = (*other.queue_);
   }
 
@@ -152,8 +206,9 @@ class ring_queue_base : public ShmContainer {
       init_shm_container(alloc);
     }
     if (GetAllocator() == other.GetAllocator()) {
-      head_ = other.head_.load();
-      tail_ = other.tail_.load();
+      idx_.head_ = other.idx_.head_.load();
+      idx_.tail_ = other.idx_.tail_.load();
+      SyncCachedIndices();
       (*queue_) = std::move(*other.queue_);
       other.SetNull();
     } else {
@@ -177,8 +232,9 @@ class ring_queue_base : public ShmContainer {
   /** Sets this list as empty */
   HSHM_CROSS_FUN
   void SetNull() {
-    head_ = 0;
-    tail_ = 0;
+    idx_.head_ = 0;
+    idx_.tail_ = 0;
+    SyncCachedIndices();
   }
 
   /**====================================
@@ -203,40 +259,96 @@ class ring_queue_base : public ShmContainer {
   /** Construct an element at \a pos position in the list */
   template <typename... Args>
   HSHM_CROSS_FUN qtok_t emplace(Args &&...args) {
-    // Allocate a slot in the queue
-    // The slot is marked NULL, so pop won't do anything if context switch
-    qtok_id head = head_.load();
-    qtok_id tail = tail_.fetch_add(qtok_id(1));
+    qtok_t tok = reserve_n(1);
+    if (tok.IsNull()) {
+      return tok;
+    }
+    commit(tok.id_, std::forward<Args>(args)...);
+    return tok;
+  }
+
+  /**
+   * Reserve \a count consecutive slots using a single atomic on tail_.
+   * Returns the token of the first slot. Each slot must be published
+   * using commit() before a consumer can pop past it. Returns null if
+   * \a count exceeds the depth of a fixed-size queue, since that many
+   * slots can never be free at once.
+   * */
+  HSHM_CROSS_FUN
+  qtok_t reserve_n(size_t count) {
+    if constexpr (!DynamicSize) {
+      if (count > GetDepth()) {
+        return qtok_t::GetNull();
+      }
+    }
+    // Allocate the slots in the queue
+    // The slots are marked NULL, so pop won't do anything if context switch
+    qtok_id tail = idx_.tail_.fetch_add(qtok_id(count));
+    qtok_id last = tail + count - 1;
     vector_t &queue = (*queue_);
+    qtok_id head = GetPushHead(last, queue.size());
 
     // Check if there's space in the queue.
     if constexpr (WaitForSpace) {
-      size_t size = tail - head + 1;
+      size_t size = last - head + 1;
       if (size > queue.size()) {
-        while (true) {
-          head = head_.load();
-          size = tail - head + 1;
-          if (size <= GetDepth()) {
-            break;
+        if constexpr (Blocking) {
+          events_.space_.Wait([&]() {
+            head = LoadPushHead();
+            return last - head + 1 <= GetDepth();
+          });
+        } else {
+          while (true) {
+            head = LoadPushHead();
+            size = last - head + 1;
+            if (size <= GetDepth()) {
+              break;
+            }
+            HSHM_THREAD_MODEL->Yield();
           }
-          HSHM_THREAD_MODEL->Yield();
         }
       }
     } else if constexpr (ErrorOnNoSpace) {
-      qtok_id size = tail - head + 1;
+      qtok_id size = last - head + 1;
       if (size > queue.size()) {
-        tail_.fetch_sub(1);
+        idx_.tail_.fetch_sub(qtok_id(count));
         return qtok_t::GetNull();
       }
     } else if constexpr (DynamicSize) {
-      size_t size = tail - head + 1;
+      size_t size = last - head + 1;
       if (size > queue.size()) {
-        resize(queue.size() * 2);
+        size_t depth = queue.size() * 2;
+        while (depth < size) {
+          depth *= 2;
+        }
+        resize(depth);
       }
     }
+    return qtok_t(tail);
+  }
+
+  /**
+   * Reserve \a count consecutive slots only if they are free now.
+   * Returns null instead of waiting, erroring, or resizing.
+   * */
+  HSHM_CROSS_FUN
+  qtok_t try_reserve_n(size_t count) {
+    qtok_id tail = idx_.tail_.load();
+    do {
+      qtok_id last = tail + count - 1;
+      if (last - GetPushHead(last, GetDepth()) + 1 > GetDepth()) {
+        return qtok_t::GetNull();
+      }
+    } while (!idx_.tail_.compare_exchange_weak(tail, tail + qtok_id(count)));
+    return qtok_t(tail);
+  }
 
+  /** Construct the element in slot \a id (from reserve_n) and publish it */
+  template <typename... Args>
+  HSHM_CROSS_FUN void commit(qtok_id id, Args &&...args) {
     // Emplace into queue at our slot
-    uint32_t idx = tail % queue.size();
+    vector_t &queue = (*queue_);
+    size_t idx = GetSlot(id, queue.size());
     auto iter = queue.begin() + idx;
     queue.replace(iter, hshm::PiecewiseConstruct(), make_argpack(),
                   make_argpack(std::forward<Args>(args)...));
@@ -244,7 +356,20 @@ class ring_queue_base : public ShmContainer {
     // Let pop know that the data is fully prepared
     pair_t &entry = (*iter);
     entry.GetFirst().SetBits(1);
-    return qtok_t(tail);
+    NotifyReady();
+  }
+
+  /** Emplace \a count elements from \a vals using a single reservation */
+  HSHM_CROSS_FUN
+  qtok_t emplace_n(const T *vals, size_t count) {
+    qtok_t tok = reserve_n(count);
+    if (tok.IsNull()) {
+      return tok;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      commit(tok.id_ + i, vals[i]);
+    }
+    return tok;
   }
 
   /** Push an elemnt in the list (wrapper) */
@@ -257,41 +382,79 @@ class ring_queue_base : public ShmContainer {
   HSHM_CROSS_FUN
   qtok_t pop(T &val) {
     // Don't pop if there's no entries
-    qtok_id head = head_.load();
-    qtok_id tail = tail_.load();
+    qtok_id head = idx_.head_.load();
+    qtok_id tail = GetPopTail(head);
     if (head >= tail) {
       return qtok_t::GetNull();
     }
 
     // Pop the element, but only if it's marked valid
-    qtok_id idx = head % (*queue_).size();
-    pair_t &entry = (*queue_)[(size_t)idx];
+    size_t idx = GetSlot(head, (*queue_).size());
+    pair_t &entry = (*queue_)[idx];
     if (entry.GetFirst().Any(1)) {
       val = std::move(entry.GetSecond());
       entry.GetFirst().Clear();
-      head_.fetch_add(1);
+      idx_.head_.fetch_add(1);
+      NotifySpace();
       return qtok_t(head);
     } else {
       return qtok_t::GetNull();
     }
   }
 
+  /**
+   * Consumer pops up to \a count ready objects into \a vals, advancing
+   * head_ once for the whole batch. Stops at the first slot which has
+   * not been published yet. Returns the number of objects popped.
+   * */
+  HSHM_CROSS_FUN
+  size_t pop_n(T *vals, size_t count) {
+    // Don't pop if there's no entries
+    qtok_id head = idx_.head_.load();
+    qtok_id tail = LoadPopTail();
+    if (head >= tail) {
+      return 0;
+    }
+    if (count > tail - head) {
+      count = tail - head;
+    }
+
+    // Pop the elements, but only while they are marked valid
+    vector_t &queue = (*queue_);
+    size_t depth = queue.size();
+    size_t i = 0;
+    for (; i < count; ++i) {
+      pair_t &entry = queue[GetSlot(head + i, depth)];
+      if (!entry.GetFirst().Any(1)) {
+        break;
+      }
+      vals[i] = std::move(entry.GetSecond());
+      entry.GetFirst().Clear();
+    }
+    if (i > 0) {
+      idx_.head_.fetch_add(qtok_id(i));
+      NotifySpace();
+    }
+    return i;
+  }
+
   /** Consumer pops the head object */
   HSHM_CROSS_FUN
   qtok_t pop() {
     // Don't pop if there's no entries
-    qtok_id head = head_.load();
-    qtok_id tail = tail_.load();
+    qtok_id head = idx_.head_.load();
+    qtok_id tail = GetPopTail(head);
     if (head >= tail) {
       return qtok_t::GetNull();
     }
 
     // Pop the element, but only if it's marked valid
-    qtok_id idx = head % (*queue_).size();
+    size_t idx = GetSlot(head, (*queue_).size());
     pair_t &entry = (*queue_)[idx];
     if (entry.GetFirst().Any(1)) {
       entry.GetFirst().Clear();
-      head_.fetch_add(1);
+      idx_.head_.fetch_add(1);
+      NotifySpace();
       return qtok_t(head);
     } else {
       return qtok_t::GetNull();
@@ -302,36 +465,76 @@ class ring_queue_base : public ShmContainer {
   HSHM_CROSS_FUN
   qtok_t pop_back(T &val) {
     // Don't pop if there's no entries
-    qtok_id head = head_.load();
-    qtok_id tail = tail_.load();
+    qtok_id head = idx_.head_.load();
+    qtok_id tail = idx_.tail_.load();
     if (head >= tail) {
       return qtok_t::GetNull();
     }
     tail -= 1;
 
     // Pop the element at tail
-    qtok_id idx = tail % (*queue_).size();
+    size_t idx = GetSlot(tail, (*queue_).size());
     pair_t &entry = (*queue_)[idx];
     if (entry.GetFirst().Any(1)) {
       val = std::move(entry.GetSecond());
       entry.GetFirst().Clear();
-      tail_.fetch_sub(1);
+      idx_.tail_.fetch_sub(1);
+      NotifySpace();
       return qtok_t(tail);
     } else {
       return qtok_t::GetNull();
     }
   }
 
+  /**
+   * Consumer pops the head object, sleeping while the queue is empty.
+   * Returns null if nothing was popped within \a timeout_us.
+   * Requires RqFlag::kBlocking.
+   * */
+  HSHM_CROSS_FUN
+  qtok_t pop_wait(T &val, size_t timeout_us = Futex::kForever) {
+    static_assert(Blocking, "pop_wait requires RqFlag::kBlocking");
+    qtok_t tok = qtok_t::GetNull();
+    events_.ready_.Wait(
+        [&]() {
+          tok = pop(val);
+          return !tok.IsNull();
+        },
+        timeout_us);
+    return tok;
+  }
+
+  /**
+   * Producer emplaces \a val, sleeping while the queue is full.
+   * Returns null if no space freed up within \a timeout_us.
+   * Requires RqFlag::kBlocking.
+   * */
+  HSHM_CROSS_FUN
+  qtok_t emplace_wait(const T &val, size_t timeout_us = Futex::kForever) {
+    static_assert(Blocking, "emplace_wait requires RqFlag::kBlocking");
+    qtok_t tok = qtok_t::GetNull();
+    events_.space_.Wait(
+        [&]() {
+          tok = try_reserve_n(1);
+          return !tok.IsNull();
+        },
+        timeout_us);
+    if (!tok.IsNull()) {
+      commit(tok.id_, val);
+    }
+    return tok;
+  }
+
   /** Consumer peeks an object pair by qtoken */
   HSHM_CROSS_FUN
   qtok_t peek(pair_t *&entry, const qtok_t &tok) {
-    qtok_id tail = tail_.load();
+    qtok_id tail = idx_.tail_.load();
     if (tok.IsNull() || tok.id_ >= tail) {
       return qtok_t::GetNull();
     }
 
     // Pop the element, but only if it's marked valid
-    qtok_id idx = tok.id_ % (*queue_).size();
+    size_t idx = GetSlot(tok.id_, (*queue_).size());
     entry = &(*queue_)[idx];
     if (entry->GetFirst().Any(1)) {
       return tok;
@@ -356,14 +559,14 @@ class ring_queue_base : public ShmContainer {
   /** Consumer peeks an object */
   HSHM_CROSS_FUN
   qtok_t peek(T *&val, int off = 0) {
-    qtok_t tok(head_.load() + off);
+    qtok_t tok(idx_.head_.load() + off);
     return peek(val, tok);
   }
 
   /** Consumer peeks an object pair */
   HSHM_CROSS_FUN
   qtok_t peek(pair_t *&val, int off = 0) {
-    qtok_t tok(head_.load() + off);
+    qtok_t tok(idx_.head_.load() + off);
     return peek(val, tok);
   }
 
@@ -371,11 +574,93 @@ class ring_queue_base : public ShmContainer {
   HSHM_CROSS_FUN
   size_t GetDepth() { return queue_->size(); }
 
+ private:
+  /** Map a queue token to a slot in the queue */
+  HSHM_INLINE_CROSS_FUN
+  static size_t GetSlot(qtok_id id, size_t depth) {
+    if constexpr (FastLayout) {
+      return (size_t)(id & (depth - 1));
+    } else {
+      return (size_t)(id % depth);
+    }
+  }
+
+  /** Reset the producer's and consumer's copies (FastLayout only) */
+  HSHM_INLINE_CROSS_FUN
+  void SyncCachedIndices() {
+    if constexpr (FastLayout) {
+      idx_.cached_head_ = idx_.head_.load();
+      idx_.cached_tail_ = idx_.tail_.load();
+    }
+  }
+
+  /** Load head_ for a producer, refreshing the producer's copy */
+  HSHM_INLINE_CROSS_FUN
+  qtok_id LoadPushHead() {
+    qtok_id head = idx_.head_.load();
+    if constexpr (FastLayout) {
+      idx_.cached_head_ = head;
+    }
+    return head;
+  }
+
+  /** Get head_ for a producer, avoiding a load of head_ if \a tail fits */
+  HSHM_INLINE_CROSS_FUN
+  qtok_id GetPushHead(qtok_id tail, size_t depth) {
+    if constexpr (FastLayout) {
+      qtok_id head = idx_.cached_head_.load();
+      if (tail - head + 1 <= depth) {
+        return head;
+      }
+    }
+    return LoadPushHead();
+  }
+
+  /** Get tail_ for a consumer, avoiding a load of tail_ if \a head < tail */
+  HSHM_INLINE_CROSS_FUN
+  qtok_id GetPopTail(qtok_id head) {
+    if constexpr (FastLayout) {
+      qtok_id tail = idx_.cached_tail_.load();
+      if (head < tail) {
+        return tail;
+      }
+    }
+    return LoadPopTail();
+  }
+
+  /** Wake consumers sleeping in pop_wait (Blocking only) */
+  HSHM_INLINE_CROSS_FUN
+  void NotifyReady() {
+    if constexpr (Blocking) {
+      events_.ready_.Notify();
+    }
+  }
+
+  /** Wake producers sleeping for space (Blocking only) */
+  HSHM_INLINE_CROSS_FUN
+  void NotifySpace() {
+    if constexpr (Blocking) {
+      events_.space_.Notify();
+    }
+  }
+
+  /** Load tail_ for a consumer, refreshing the consumer's copy */
+  HSHM_INLINE_CROSS_FUN
+  qtok_id LoadPopTail() {
+    qtok_id tail = idx_.tail_.load();
+    if constexpr (FastLayout) {
+      idx_.cached_tail_ = tail;
+    }
+    return tail;
+  }
+
+ public:
+
   /** Get size at this moment */
   HSHM_CROSS_FUN
   size_t GetSize() {
-    size_t tail = tail_.load();
-    size_t head = head_.load();
+    size_t tail = idx_.tail_.load();
+    size_t head = idx_.head_.load();
     if (tail < head) {
       return 0;
     }
@@ -419,6 +704,22 @@ template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
 using ext_ring_buffer =
     ring_queue_base<T, RING_BUFFER_EXTENSIBLE_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
 
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using fast_mpsc_queue =
+    ring_queue_base<T, RING_BUFFER_FAST_MPSC_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using fast_spsc_queue =
+    ring_queue_base<T, RING_BUFFER_FAST_SPSC_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using blocking_mpsc_queue =
+    ring_queue_base<T, RING_BUFFER_BLOCKING_MPSC_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using blocking_spsc_queue =
+    ring_queue_base<T, RING_BUFFER_BLOCKING_SPSC_FLAGS, HSHM_CLASS_TEMPL_ARGS>;
+
 }  // namespace hshm::ipc
 
 namespace hshm {
@@ -453,6 +754,24 @@ template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
 using ext_ring_buffer = hipc::ring_queue_base<T, RING_BUFFER_EXTENSIBLE_FLAGS,
                                               HSHM_CLASS_TEMPL_ARGS>;
 
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using fast_mpsc_queue = hipc::ring_queue_base<T, RING_BUFFER_FAST_MPSC_FLAGS,
+                                              HSHM_CLASS_TEMPL_ARGS>;
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using fast_spsc_queue = hipc::ring_queue_base<T, RING_BUFFER_FAST_SPSC_FLAGS,
+                                              HSHM_CLASS_TEMPL_ARGS>;
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using blocking_mpsc_queue =
+    hipc::ring_queue_base<T, RING_BUFFER_BLOCKING_MPSC_FLAGS,
+                          HSHM_CLASS_TEMPL_ARGS>;
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using blocking_spsc_queue =
+    hipc::ring_queue_base<T, RING_BUFFER_BLOCKING_SPSC_FLAGS,
+                          HSHM_CLASS_TEMPL_ARGS>;
+
 }  // namespace hshm
 
 #undef CLASS_NAME
@@ -22,6 +22,16 @@ class RqFlag {
   CLS_CONST RingQueueFlag kErrorOnNoSpace = BIT_OPT(RingQueueFlag, 4);
   /** Queue supports dynamic resizing */
   CLS_CONST RingQueueFlag kDynamicResize = BIT_OPT(RingQueueFlag, 5);
+  /**
+   * Round the depth to a power of two, place head and tail on separate
+   * cache lines, and cache the opposite index on each side
+   * */
+  CLS_CONST RingQueueFlag kFastLayout = BIT_OPT(RingQueueFlag, 6);
+  /**
+   * Keep futexes in the queue header so that pop_wait and emplace_wait
+   * can sleep, and so that kWaitForSpace producers park instead of yield
+   * */
+  CLS_CONST RingQueueFlag kBlocking = BIT_OPT(RingQueueFlag, 7);
 };
 
 }  // namespace hshm::ipc
@@ -45,6 +55,12 @@ using hshm::ipc::RqFlag;
 #define RING_BUFFER_CIRCULAR_SPSC_FLAGS 0
 #define RING_BUFFER_CIRCULAR_MPMC_FLAGS RqFlag::kPushAtomic | RqFlag::kPopAtomic
 #define RING_BUFFER_EXTENSIBLE_FLAGS RqFlag::kDynamicResize
+#define RING_BUFFER_FAST_MPSC_FLAGS RING_BUFFER_MPSC_FLAGS | RqFlag::kFastLayout
+#define RING_BUFFER_FAST_SPSC_FLAGS RING_BUFFER_SPSC_FLAGS | RqFlag::kFastLayout
+#define RING_BUFFER_BLOCKING_MPSC_FLAGS \
+  RING_BUFFER_MPSC_FLAGS | RqFlag::kBlocking
+#define RING_BUFFER_BLOCKING_SPSC_FLAGS \
+  RING_BUFFER_SPSC_FLAGS | RqFlag::kBlocking
 
 #define RING_QUEUE_DEFS                                                        \
   CLS_CONST RingQueueFlag IsPopAtomic = (RQ_FLAGS & RqFlag::kPopAtomic) > 0;   \
@@ -53,6 +69,9 @@ using hshm::ipc::RqFlag;
       (RQ_FLAGS & RqFlag::kWaitForSpace) > 0;                                  \
   CLS_CONST RingQueueFlag ErrorOnNoSpace =                                     \
       (RQ_FLAGS & RqFlag::kErrorOnNoSpace) > 0;                                \
-  CLS_CONST RingQueueFlag DynamicSize = (RQ_FLAGS & RqFlag::kDynamicResize) > 0;
+  CLS_CONST RingQueueFlag DynamicSize =                                        \
+      (RQ_FLAGS & RqFlag::kDynamicResize) > 0;                                 \
+  CLS_CONST RingQueueFlag FastLayout = (RQ_FLAGS & RqFlag::kFastLayout) > 0;   \
+  CLS_CONST RingQueueFlag Blocking = (RQ_FLAGS & RqFlag::kBlocking) > 0;
 
 #endif  // HSHM_SHM_INCLUDE_HSHM_SHM_DATA_STRUCTURES_IPC_RING_QUEUE_FLAGS_H_
\ No newline at end of file
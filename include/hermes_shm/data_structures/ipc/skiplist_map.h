@@ -0,0 +1,706 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_SKIPLIST_MAP_H_
+#define HSHM_DATA_STRUCTURES_IPC_SKIPLIST_MAP_H_
+
+#include <functional>
+#include <type_traits>
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/memory/memory.h"
+#include "hermes_shm/thread/thread_model_manager.h"
+#include "hermes_shm/types/numbers.h"
+#include "epoch_manager.h"
+
+namespace hshm::ipc {
+
+/**
+ * The header of every skiplist_map node. It is followed by height_
+ * links, then the key and the value. Link i is the next node at level i;
+ * its first bit is marked once the node is being erased.
+ * */
+struct skiplist_node {
+  hshm::u32 height_;              /**< The number of links */
+  hipc::atomic<hshm::u32> state_; /**< Whether linking or erasing finished */
+};
+
+/** forward pointer for skiplist_map */
+template <typename Key, typename T, class Compare = std::less<Key>,
+          HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class skiplist_map;
+
+/** A (key, value) entry of a skiplist_map */
+template <typename Key, typename T>
+struct skiplist_map_entry {
+  const Key &first;
+  T &second;
+
+  /** Get the key */
+  HSHM_INLINE_CROSS_FUN const Key &GetKey() const { return first; }
+
+  /** Get the value */
+  HSHM_INLINE_CROSS_FUN T &GetVal() const { return second; }
+};
+
+/**
+ * The skiplist_map iterator. Walks the bottom level in key order,
+ * skipping entries which are being erased.
+ * */
+template <typename Key, typename T, class Compare, HSHM_CLASS_TEMPL>
+struct skiplist_map_iterator {
+ public:
+  using MAP_T = skiplist_map<Key, T, Compare, HSHM_CLASS_TEMPL_ARGS>;
+  using ENTRY_T = skiplist_map_entry<Key, T>;
+
+  MAP_T *map_;
+  skiplist_node *node_; /**< The current node, or nullptr at the end */
+
+  /** Default constructor */
+  HSHM_CROSS_FUN skiplist_map_iterator() = default;
+
+  /** Construct the iterator at \a node */
+  HSHM_INLINE_CROSS_FUN explicit skiplist_map_iterator(MAP_T &map,
+                                                       skiplist_node *node)
+      : map_(&map), node_(node) {}
+
+  /** Get the pointed entry */
+  HSHM_INLINE_CROSS_FUN ENTRY_T operator*() const {
+    return ENTRY_T{GetKey(), GetVal()};
+  }
+
+  /** Get the pointed key */
+  HSHM_INLINE_CROSS_FUN const Key &GetKey() const {
+    return MAP_T::KeyAr(node_).get_ref();
+  }
+
+  /** Get the pointed value */
+  HSHM_INLINE_CROSS_FUN T &GetVal() const {
+    return MAP_T::ValAr(node_).get_ref();
+  }
+
+  /** Go to the next entry */
+  HSHM_INLINE_CROSS_FUN skiplist_map_iterator &operator++() {
+    node_ = map_->NextLive(node_);
+    return *this;
+  }
+
+  /** Return the next iterator */
+  HSHM_INLINE_CROSS_FUN skiplist_map_iterator operator++(int) const {
+    skiplist_map_iterator next(*this);
+    ++next;
+    return next;
+  }
+
+  /** Check if two iterators are equal */
+  HSHM_INLINE_CROSS_FUN friend bool operator==(
+      const skiplist_map_iterator &a, const skiplist_map_iterator &b) {
+    return a.node_ == b.node_;
+  }
+
+  /** Check if two iterators are inequal */
+  HSHM_INLINE_CROSS_FUN friend bool operator!=(
+      const skiplist_map_iterator &a, const skiplist_map_iterator &b) {
+    return !(a == b);
+  }
+
+  /** Determine whether this iterator is the end iterator */
+  HSHM_INLINE_CROSS_FUN bool is_end() const { return node_ == nullptr; }
+
+  /** Set this iterator to the end iterator */
+  HSHM_INLINE_CROSS_FUN void set_end() { node_ = nullptr; }
+};
+
+/**
+ * MACROS to simplify the skiplist_map namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+
+#define CLASS_NAME skiplist_map
+#define CLASS_NEW_ARGS Key, T, Compare
+
+/**
+ * A lock-free ordered map which many threads and processes may insert
+ * into, erase from, and read concurrently.
+ *
+ * Nodes form a skiplist whose links are offsets updated with CAS. A node
+ * is inserted by linking the bottom level, then each level of its tower,
+ * whose height is drawn from a per-thread PRNG. A node is erased by
+ * marking its links from the top down; the thread which marks the
+ * bottom link owns the erase. Searches unlink marked nodes they pass.
+ * Once both the insert and the erase of a node are done with it, the
+ * node is retired to an epoch_manager, which destroys and frees it when
+ * no thread can still reference it.
+ *
+ * Each thread must Register a MemContext with the map before using it,
+ * and pass it to every operation. A MemContext is registered with one
+ * map or queue at a time. Iterators are only valid within an
+ * epoch_guard of the map. Values are never replaced in place, since a
+ * lock-free reader may be copying them.
+ * */
+template <typename Key, typename T, class Compare, HSHM_CLASS_TEMPL>
+class skiplist_map : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+
+  /**====================================
+   * Typedefs
+   * ===================================*/
+  typedef skiplist_map_iterator<Key, T, Compare, HSHM_CLASS_TEMPL_ARGS>
+      iterator_t;
+  friend iterator_t;
+
+  /** Destroys the entry of a node right before it is freed */
+  struct node_destroyer {
+    HSHM_INLINE_CROSS_FUN
+    void operator()(AllocT *alloc, const OffsetPointer &p) const {
+      DestroyEntry(alloc->template Convert<skiplist_node>(p));
+    }
+  };
+  typedef epoch_manager<node_destroyer, HSHM_CLASS_TEMPL_ARGS>
+      epoch_manager_t;
+
+  /** The tallest tower. With p = 1/4, enough for 4^16 entries. */
+  CLS_CONST hshm::u32 kMaxHeight = 16;
+  /** Node states. Each is added to state_ exactly once. */
+  CLS_CONST hshm::u32 kLinked = 1; /**< The insert stopped linking */
+  CLS_CONST hshm::u32 kErased = 2; /**< The bottom link was marked */
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  delay_ar<epoch_manager_t> epochs_;
+  OffsetPointer head_; /**< Sentinel before the first node, at every level */
+  OffsetPointer tail_; /**< Sentinel after the last node. It has no links. */
+  hipc::atomic<hshm::u32> levels_; /**< The levels which may hold nodes */
+  hipc::atomic<hshm::size_t> length_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit skiplist_map(size_t max_threads = 1024) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(),
+             max_threads);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit skiplist_map(const hipc::CtxAllocator<AllocT> &alloc,
+                        size_t max_threads = 1024) {
+    shm_init(alloc, max_threads);
+  }
+
+  /** SHM constructor. */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc,
+                size_t max_threads = 1024) {
+    init_shm_container(alloc);
+    HSHM_MAKE_AR(epochs_, GetCtxAllocator(), max_threads);
+    hipc::MemContext ctx = GetMemCtx();
+    tail_ = OffsetPointer(AllocateNode(ctx, 0));
+    head_ = OffsetPointer(AllocateNode(ctx, kMaxHeight));
+    AtomicOffsetPointer *links = Links(GetNode(head_.load()));
+    for (hshm::u32 i = 0; i < kMaxHeight; ++i) {
+      links[i].store(tail_.load());
+    }
+    levels_ = 1;
+    length_ = 0;
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Nodes are shared with concurrent threads; copying is disabled */
+  skiplist_map(const skiplist_map &other) = delete;
+
+  /** Nodes are shared with concurrent threads; copying is disabled */
+  skiplist_map &operator=(const skiplist_map &other) = delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor. Destroys every entry, including retired ones. */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    hipc::MemContext ctx = GetMemCtx();
+    size_t off = Unmark(Links(GetNode(head_.load()))[0].load());
+    while (off != tail_.load()) {
+      skiplist_node *node = GetNode(off);
+      size_t next = Unmark(Links(node)[0].load());
+      DestroyEntry(node);
+      FreeNode(ctx, off);
+      off = next;
+    }
+    (*epochs_).FreeRetired();
+    FreeNode(ctx, head_.load());
+    FreeNode(ctx, tail_.load());
+    (*epochs_).shm_destroy();
+  }
+
+  /** Check if the map is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const { return (*epochs_).IsNull(); }
+
+  /** Sets this map as null */
+  HSHM_CROSS_FUN
+  void SetNull() {}
+
+  /**====================================
+   * Thread Registration
+   * ===================================*/
+
+  /** Register the calling thread's \a ctx. False if no slots are free. */
+  HSHM_CROSS_FUN
+  bool Register(hipc::MemContext &ctx) { return (*epochs_).Register(ctx); }
+
+  /** Unregister \a ctx, handing off any nodes it retired */
+  HSHM_CROSS_FUN
+  void Unregister(hipc::MemContext &ctx) { (*epochs_).Unregister(ctx); }
+
+  /** Begin a critical section in which iterators stay valid */
+  HSHM_INLINE_CROSS_FUN
+  void Enter(const hipc::MemContext &ctx) { (*epochs_).Enter(ctx); }
+
+  /** End a critical section */
+  HSHM_INLINE_CROSS_FUN
+  void Exit(const hipc::MemContext &ctx) { (*epochs_).Exit(ctx); }
+
+  /**====================================
+   * Emplace Methods
+   * ===================================*/
+
+  /**
+   * Construct an entry in the map. Does nothing and returns false if
+   * \a key already exists.
+   * */
+  template <typename... Args>
+  HSHM_CROSS_FUN bool try_emplace(const hipc::MemContext &ctx,
+                                  const Key &key, Args &&...args) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    size_t preds[kMaxHeight], succs[kMaxHeight];
+    hshm::u32 height = RandomHeight();
+    RaiseLevels(height);
+    if (Search<false>(key, preds, succs)) {
+      return false;
+    }
+    size_t off = AllocateNode(ctx, height);
+    skiplist_node *node = GetNode(off);
+    HSHM_MAKE_AR(KeyAr(node), GetCtxAllocator(), key)
+    HSHM_MAKE_AR(ValAr(node), GetCtxAllocator(), std::forward<Args>(args)...)
+
+    // The node is in the map once its bottom level is linked
+    AtomicOffsetPointer *links = Links(node);
+    while (true) {
+      for (hshm::u32 i = 0; i < height; ++i) {
+        links[i].store(succs[i], std::memory_order_relaxed);
+      }
+      size_t succ = succs[0];
+      if (Links(GetNode(preds[0]))[0].compare_exchange_strong(succ, off)) {
+        break;
+      }
+      if (Search<false>(key, preds, succs)) {
+        DestroyEntry(node);
+        FreeNode(ctx, off);
+        return false;
+      }
+    }
+    length_.fetch_add(1, std::memory_order_relaxed);
+    LinkTower(key, node, off, preds, succs);
+    if (node->state_.fetch_add(kLinked) & kErased) {
+      // An erase finished first and left the node to us
+      Search<true>(key, preds, succs);
+      (*epochs_).Retire(ctx, OffsetPointer(off));
+    }
+    return true;
+  }
+
+  /**====================================
+   * Erase Methods
+   * ===================================*/
+
+  /** Erase \a key. Returns false if it did not exist. */
+  HSHM_CROSS_FUN
+  bool erase(const hipc::MemContext &ctx, const Key &key) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    size_t preds[kMaxHeight], succs[kMaxHeight];
+    if (!Search<false>(key, preds, succs)) {
+      return false;
+    }
+    size_t off = succs[0];
+    skiplist_node *node = GetNode(off);
+    AtomicOffsetPointer *links = Links(node);
+    for (hshm::u32 i = node->height_ - 1; i > 0; --i) {
+      size_t next = links[i].load();
+      while (!IsMarked(next) &&
+             !links[i].compare_exchange_weak(next, Mark(next))) {
+      }
+    }
+    size_t next = links[0].load();
+    while (true) {
+      if (IsMarked(next)) {
+        return false;
+      }
+      if (links[0].compare_exchange_weak(next, Mark(next))) {
+        break;
+      }
+    }
+    length_.fetch_sub(1, std::memory_order_relaxed);
+    // Unlink every level. If the insert is still linking, it may link the
+    // node again, so the insert unlinks and retires it when it finishes.
+    bool linked = node->state_.fetch_add(kErased) & kLinked;
+    Search<true>(key, preds, succs);
+    if (linked) {
+      (*epochs_).Retire(ctx, OffsetPointer(off));
+    }
+    return true;
+  }
+
+  /** Erase every entry */
+  HSHM_CROSS_FUN
+  void clear(const hipc::MemContext &ctx) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    for (iterator_t iter = begin(); !iter.is_end(); ++iter) {
+      erase(ctx, iter.GetKey());
+    }
+  }
+
+  /**====================================
+   * Index Methods
+   * ===================================*/
+
+  /**
+   * Copy the value of \a key into \a val. Returns false if the key does
+   * not exist.
+   * */
+  HSHM_CROSS_FUN
+  bool find(const hipc::MemContext &ctx, const Key &key, T &val) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    skiplist_node *node = LowerBound(key);
+    if (node == nullptr || Less(key, KeyAr(node).get_ref())) {
+      return false;
+    }
+    val = ValAr(node).get_ref();
+    return true;
+  }
+
+  /** Check whether \a key exists */
+  HSHM_CROSS_FUN
+  bool contains(const hipc::MemContext &ctx, const Key &key) {
+    epoch_guard<epoch_manager_t> guard(*epochs_, ctx);
+    skiplist_node *node = LowerBound(key);
+    return node != nullptr && !Less(key, KeyAr(node).get_ref());
+  }
+
+  /**
+   * The first entry whose key is not less than \a key. Only valid within
+   * an epoch_guard of the map.
+   * */
+  HSHM_CROSS_FUN
+  iterator_t lower_bound(const Key &key) {
+    return iterator_t(*this, LowerBound(key));
+  }
+
+  /** The first entry. Only valid within an epoch_guard of the map. */
+  HSHM_CROSS_FUN
+  iterator_t begin() { return iterator_t(*this, NextLive(GetNode(head_))); }
+
+  /** The end iterator */
+  HSHM_INLINE_CROSS_FUN
+  iterator_t end() { return iterator_t(*this, nullptr); }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** The number of entries at this moment */
+  HSHM_INLINE_CROSS_FUN
+  size_t size() const { return length_.load(std::memory_order_relaxed); }
+
+  /** The number of levels which may hold nodes */
+  HSHM_INLINE_CROSS_FUN
+  size_t get_levels() const { return levels_.load(); }
+
+ private:
+  /**====================================
+   * Internal Methods
+   * ===================================*/
+
+  /** Compare two keys */
+  HSHM_INLINE_CROSS_FUN
+  static bool Less(const Key &a, const Key &b) { return Compare{}(a, b); }
+
+  /** Link the upper levels of a node whose bottom level is linked */
+  HSHM_CROSS_FUN
+  void LinkTower(const Key &key, skiplist_node *node, size_t off,
+                 size_t *preds, size_t *succs) {
+    AtomicOffsetPointer *links = Links(node);
+    for (hshm::u32 i = 1; i < node->height_; ++i) {
+      while (true) {
+        size_t next = links[i].load();
+        if (IsMarked(next)) {
+          return;
+        }
+        if (next != succs[i] &&
+            !links[i].compare_exchange_strong(next, succs[i])) {
+          continue;
+        }
+        size_t succ = succs[i];
+        if (Links(GetNode(preds[i]))[i].compare_exchange_strong(succ, off)) {
+          break;
+        }
+        Search<false>(key, preds, succs);
+        if (succs[0] != off) {
+          return;
+        }
+      }
+    }
+  }
+
+  /**
+   * Find the predecessor and successor of \a key at each level, unlinking
+   * marked nodes on the way. The successors are the first nodes whose key
+   * is not less than \a key, or, if \a kUpper, greater than \a key.
+   * Returns whether \a key exists.
+   * */
+  template <bool kUpper>
+  HSHM_CROSS_FUN bool Search(const Key &key, size_t *preds, size_t *succs) {
+    bool found;
+    while (!TrySearch<kUpper>(key, preds, succs, found)) {
+    }
+    return found;
+  }
+
+  /** One attempt of Search. False if a concurrent change got in the way. */
+  template <bool kUpper>
+  HSHM_CROSS_FUN bool TrySearch(const Key &key, size_t *preds, size_t *succs,
+                                bool &found) {
+    size_t head = head_.load(), tail = tail_.load();
+    hshm::u32 levels = levels_.load();
+    for (hshm::u32 i = levels; i < kMaxHeight; ++i) {
+      preds[i] = head;
+      succs[i] = tail;
+    }
+    size_t pred = head, curr = tail;
+    for (hshm::u32 i = levels; i-- > 0;) {
+      curr = Unmark(Links(GetNode(pred))[i].load());
+      while (curr != tail) {
+        skiplist_node *node = GetNode(curr);
+        size_t succ = Links(node)[i].load();
+        if (IsMarked(succ)) {
+          size_t expected = curr;
+          if (!Links(GetNode(pred))[i].compare_exchange_strong(
+                  expected, Unmark(succ))) {
+            return false;
+          }
+          curr = Unmark(succ);
+          continue;
+        }
+        const Key &node_key = KeyAr(node).get_ref();
+        if (kUpper ? Less(key, node_key) : !Less(node_key, key)) {
+          break;
+        }
+        pred = curr;
+        curr = succ;
+      }
+      preds[i] = pred;
+      succs[i] = curr;
+    }
+    found = curr != tail && !Less(key, KeyAr(GetNode(curr)).get_ref());
+    return true;
+  }
+
+  /**
+   * The first live node whose key is not less than \a key, or nullptr.
+   * Marked nodes are skipped rather than unlinked, so readers never write.
+   * */
+  HSHM_CROSS_FUN
+  skiplist_node *LowerBound(const Key &key) {
+    size_t pred = head_.load(), tail = tail_.load(), curr = tail;
+    for (hshm::u32 i = levels_.load(); i-- > 0;) {
+      curr = Unmark(Links(GetNode(pred))[i].load());
+      while (curr != tail) {
+        skiplist_node *node = GetNode(curr);
+        size_t succ = Links(node)[i].load();
+        if (IsMarked(succ)) {
+          curr = Unmark(succ);
+          continue;
+        }
+        if (!Less(KeyAr(node).get_ref(), key)) {
+          break;
+        }
+        pred = curr;
+        curr = succ;
+      }
+    }
+    return curr == tail ? nullptr : GetNode(curr);
+  }
+
+  /** The first live node after \a node, or nullptr */
+  HSHM_CROSS_FUN
+  skiplist_node *NextLive(skiplist_node *node) {
+    size_t tail = tail_.load();
+    size_t off = Unmark(Links(node)[0].load());
+    while (off != tail) {
+      size_t next = Links(GetNode(off))[0].load();
+      if (!IsMarked(next)) {
+        return GetNode(off);
+      }
+      off = Unmark(next);
+    }
+    return nullptr;
+  }
+
+  /** Let searches start at level \a height */
+  HSHM_INLINE_CROSS_FUN
+  void RaiseLevels(hshm::u32 height) {
+    hshm::u32 levels = levels_.load();
+    while (levels < height &&
+           !levels_.compare_exchange_weak(levels, height)) {
+    }
+  }
+
+  /** Draw a tower height: each level is kept with probability 1/4 */
+  HSHM_INLINE_CROSS_FUN
+  hshm::u32 RandomHeight() {
+#ifdef HSHM_IS_HOST
+    // Each thread continues its own xorshift sequence
+    static thread_local hshm::u64 x =
+        (HSHM_THREAD_MODEL->GetTid().tid_ + 1) * 0x9e3779b97f4a7c15ULL;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    hshm::u64 r = x;
+#else
+    hshm::u64 r = (HSHM_THREAD_MODEL->GetTid().tid_ + length_.load()) *
+                  0x9e3779b97f4a7c15ULL;
+    r ^= r >> 29;
+#endif
+    hshm::u32 height = 1;
+    while (height < kMaxHeight && (r & 3) == 0) {
+      ++height;
+      r >>= 2;
+    }
+    return height;
+  }
+
+  /** Round \a off up to a multiple of \a align */
+  HSHM_INLINE_CROSS_FUN
+  static constexpr size_t AlignUp(size_t off, size_t align) {
+    return (off + align - 1) / align * align;
+  }
+
+  /** The offset of the key of a node with \a height links */
+  HSHM_INLINE_CROSS_FUN
+  static size_t KeyOff(hshm::u32 height) {
+    return AlignUp(sizeof(skiplist_node) + height * sizeof(AtomicOffsetPointer),
+                   alignof(Key));
+  }
+
+  /** The offset of the value of a node with \a height links */
+  HSHM_INLINE_CROSS_FUN
+  static size_t ValOff(hshm::u32 height) {
+    return AlignUp(KeyOff(height) + sizeof(delay_ar<Key>), alignof(T));
+  }
+
+  /** The links of \a node */
+  HSHM_INLINE_CROSS_FUN
+  static AtomicOffsetPointer *Links(skiplist_node *node) {
+    return reinterpret_cast<AtomicOffsetPointer *>(node + 1);
+  }
+
+  /** The key of \a node */
+  HSHM_INLINE_CROSS_FUN
+  static delay_ar<Key> &KeyAr(skiplist_node *node) {
+    return *reinterpret_cast<delay_ar<Key> *>(
+        reinterpret_cast<char *>(node) + KeyOff(node->height_));
+  }
+
+  /** The value of \a node */
+  HSHM_INLINE_CROSS_FUN
+  static delay_ar<T> &ValAr(skiplist_node *node) {
+    return *reinterpret_cast<delay_ar<T> *>(reinterpret_cast<char *>(node) +
+                                            ValOff(node->height_));
+  }
+
+  /** Mark a link */
+  HSHM_INLINE_CROSS_FUN
+  static size_t Mark(size_t off) { return MARK_FIRST_BIT(size_t, off); }
+
+  /** Unmark a link */
+  HSHM_INLINE_CROSS_FUN
+  static size_t Unmark(size_t off) { return UNMARK_FIRST_BIT(size_t, off); }
+
+  /** Check whether a link is marked */
+  HSHM_INLINE_CROSS_FUN
+  static bool IsMarked(size_t off) { return IS_FIRST_BIT_MARKED(size_t, off); }
+
+  /** Convert a node offset to a pointer */
+  HSHM_INLINE_CROSS_FUN
+  skiplist_node *GetNode(size_t off) {
+    return GetAllocator()->template Convert<skiplist_node>(OffsetPointer(off));
+  }
+
+  /** Convert a node offset to a pointer */
+  HSHM_INLINE_CROSS_FUN
+  skiplist_node *GetNode(const OffsetPointer &off) {
+    return GetNode(off.load());
+  }
+
+  /** Allocate a node with \a height links and an unconstructed entry */
+  HSHM_CROSS_FUN
+  size_t AllocateNode(const hipc::MemContext &ctx, hshm::u32 height) {
+    size_t size = ValOff(height) + sizeof(delay_ar<T>);
+    FullPtr<skiplist_node, OffsetPointer> p =
+        GetAllocator()->template AllocateLocalPtr<skiplist_node, OffsetPointer>(
+            ctx, size);
+    p.ptr_->height_ = height;
+    p.ptr_->state_ = 0;
+    return p.shm_.load();
+  }
+
+  /** Free a node which no thread can reference */
+  HSHM_INLINE_CROSS_FUN
+  void FreeNode(const hipc::MemContext &ctx, size_t off) {
+    OffsetPointer p(off);
+    GetAllocator()->template Free<OffsetPointer>(ctx, p);
+  }
+
+  /** Destroy the key and value of a node */
+  HSHM_INLINE_CROSS_FUN
+  static void DestroyEntry(skiplist_node *node) {
+    HSHM_DESTROY_AR(KeyAr(node))
+    HSHM_DESTROY_AR(ValAr(node))
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename Key, typename T, class Compare = std::less<Key>,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using skiplist_map =
+    hipc::skiplist_map<Key, T, Compare, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_SKIPLIST_MAP_H_
@@ -14,6 +14,7 @@
 #define HSHM_DATA_STRUCTURES__Sslist_H
 
 #include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/data_structures/internal/shm_node_pool.h"
 #include "hermes_shm/data_structures/ipc/functional.h"
 #include "hermes_shm/data_structures/serialization/serialize_common.h"
 
@@ -27,8 +28,9 @@ class slist;
 template <typename T, HSHM_CLASS_TEMPL>
 struct slist_entry {
  public:
-  OffsetPointer next_ptr_;
-  delay_ar<T> data_;
+  HSHM_LINK_POINTER next_ptr_;
+  /** Aligned for T even after compact links, up to the node pool limit */
+  alignas(std::min(alignof(T), alignof(OffsetPointer))) delay_ar<T> data_;
 
   /** Constructor */
   template <typename... Args>
@@ -98,7 +100,7 @@ struct slist_iterator_templ {
     entry_ptr_ = entry_->next_ptr_;
     entry_ = slist_->GetAllocator()
                  ->template Convert<slist_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
-                     entry_->next_ptr_);
+                     entry_ptr_);
     return *this;
   }
 
@@ -213,8 +215,10 @@ class slist : public ShmContainer {
    * Variables
    * ===================================*/
   HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  HSHM_TRIVIALLY_RELOCATABLE
   OffsetPointer head_ptr_, tail_ptr_;
   size_t length_;
+  node_pool<slist_entry<T, HSHM_CLASS_TEMPL_ARGS>> pool_;
 
   /**====================================
    * Iterator Typedefs
@@ -297,11 +301,15 @@ class slist : public ShmContainer {
     head_ptr_ = other.head_ptr_;
     tail_ptr_ = other.tail_ptr_;
     length_ = other.length_;
+    pool_ = other.pool_;
   }
 
   /** SHM copy constructor + operator main */
   template <typename ListT>
   HSHM_CROSS_FUN void shm_strong_copy_op(const ListT &other) {
+    if constexpr (std::is_same_v<ListT, slist>) {
+      pool_.chunk_nodes_ = other.pool_.chunk_nodes_;
+    }
     for (auto iter = other.cbegin(); iter != other.cend(); ++iter) {
       emplace_back(*iter);
     }
@@ -354,9 +362,9 @@ class slist : public ShmContainer {
    * Destructor
    * ===================================*/
 
-  /** Check if the list is empty */
+  /** Check if the list is empty and owns no pooled entries */
   HSHM_CROSS_FUN
-  bool IsNull() const { return length_ == 0; }
+  bool IsNull() const { return length_ == 0 && pool_.IsNull(); }
 
   /** Sets this list as empty */
   HSHM_CROSS_FUN
@@ -364,6 +372,7 @@ class slist : public ShmContainer {
     length_ = 0;
     head_ptr_.SetNull();
     tail_ptr_.SetNull();
+    pool_.SetNull();
   }
 
   /** Destroy all shared memory allocated by the slist */
@@ -414,6 +423,38 @@ class slist : public ShmContainer {
     ++length_;
   }
 
+  /**
+   * Move the front entry of \a other to the front of this slist without
+   * reallocating it. Both slists must use the same allocator, and
+   * neither may use a node pool.
+   *
+   * @exception SLIST_SPLICE_POOLED either slist uses a node pool. Both
+   * slists are left unchanged.
+   * */
+  HSHM_CROSS_FUN
+  void splice_front(slist &other) {
+    if (pool_.chunk_nodes_ != 0 || other.pool_.chunk_nodes_ != 0) {
+      HSHM_THROW_ERROR(SLIST_SPLICE_POOLED);
+      return;
+    }
+    OffsetPointer entry_ptr = other.head_ptr_;
+    auto entry =
+        GetAllocator()->template Convert<slist_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
+            entry_ptr);
+    other.head_ptr_ = entry->next_ptr_;
+    if (--other.length_ == 0) {
+      other.tail_ptr_.SetNull();
+    }
+    if (size() == 0) {
+      entry->next_ptr_.SetNull();
+      tail_ptr_ = entry_ptr;
+    } else {
+      entry->next_ptr_ = head_ptr_;
+    }
+    head_ptr_ = entry_ptr;
+    ++length_;
+  }
+
   /** Find the element prior to an slist_entry */
   HSHM_CROSS_FUN
   iterator_t find_prior(iterator_t pos) {
@@ -455,7 +496,7 @@ class slist : public ShmContainer {
     while (pos != last) {
       auto next = pos + 1;
       HSHM_DESTROY_AR(pos.entry_->data_)
-      GetAllocator()->Free(GetMemCtx(), pos.entry_ptr_);
+      pool_.Free(GetAllocator(), GetMemCtx(), pos.entry_ptr_, pos.entry_);
       --length_;
       pos = next;
     }
@@ -471,9 +512,34 @@ class slist : public ShmContainer {
     }
   }
 
-  /** Destroy all elements in the slist */
+  /** Destroy all elements in the slist and free its pooled entries */
+  HSHM_CROSS_FUN
+  void clear() {
+    erase(begin(), end());
+    pool_.Release(GetAllocator(), GetMemCtx());
+  }
+
+  /**
+   * Allocate entries in chunks of \a count, recycling erased entries
+   * within this slist instead of freeing them. 0 allocates every entry
+   * individually (the default). The slist must be empty.
+   *
+   * @return false, leaving the chunk size unchanged, if the slist is not
+   * empty
+   * */
+  HSHM_CROSS_FUN
+  bool set_node_chunk(u32 count) {
+    if (length_ != 0) {
+      return false;
+    }
+    pool_.Release(GetAllocator(), GetMemCtx());
+    pool_.chunk_nodes_ = count;
+    return true;
+  }
+
+  /** Get the number of entries allocated per chunk */
   HSHM_CROSS_FUN
-  void clear() { erase(begin(), end()); }
+  u32 get_node_chunk() const { return pool_.chunk_nodes_; }
 
   /** Get the object at the front of the slist */
   HSHM_CROSS_FUN
@@ -569,10 +635,7 @@ class slist : public ShmContainer {
   template <typename... Args>
   HSHM_CROSS_FUN slist_entry<T, HSHM_CLASS_TEMPL_ARGS> *_create_entry(
       OffsetPointer &p, Args &&...args) {
-    auto entry =
-        GetAllocator()
-            ->template AllocateObjs<slist_entry<T, HSHM_CLASS_TEMPL_ARGS>>(
-                GetMemCtx(), 1, p);
+    auto entry = pool_.Allocate(GetAllocator(), GetMemCtx(), p);
     HSHM_MAKE_AR(entry->data_, GetCtxAllocator(), std::forward<Args>(args)...)
     return entry;
   }
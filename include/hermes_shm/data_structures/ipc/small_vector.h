@@ -0,0 +1,37 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_SMALL_VECTOR_H_
+#define HSHM_DATA_STRUCTURES_IPC_SMALL_VECTOR_H_
+
+#include "vector.h"
+
+namespace hshm::ipc {
+
+/**
+ * A vector whose first N elements are stored inline in the container
+ * object. It only allocates once it grows beyond N elements, after which
+ * it behaves like hipc::vector.
+ * */
+template <typename T, size_t N, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using small_vector = vector_templ<T, N, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename T, size_t N, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using small_vector = hipc::small_vector<T, N, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_SMALL_VECTOR_H_
@@ -13,15 +13,118 @@
 #ifndef HSHM_SHM__DATA_STRUCTURES_IPC_SPLIT_TICKET_QUEUE_H_
 #define HSHM_SHM__DATA_STRUCTURES_IPC_SPLIT_TICKET_QUEUE_H_
 
+#include <chrono>
+
 #include "hermes_shm/data_structures/internal/shm_internal.h"
 #include "hermes_shm/thread/lock.h"
+#include "hermes_shm/thread/thread_model_manager.h"
 #include "ticket_queue.h"
 #include "vector.h"
 
+#if defined(HSHM_IS_HOST) && defined(__linux__)
+#include <sched.h>
+#define HSHM_HAS_SCHED_GETCPU
+#endif
+
 namespace hshm::ipc {
 
+/**
+ * Lane policy which spreads operations over the splits with a shared
+ * round-robin counter, then probes the following splits in order.
+ * */
+struct split_rr_lanes {
+  size_t lane_;
+  size_t nlanes_;
+
+  /** Pick the first lane by incrementing \a rr */
+  HSHM_INLINE_CROSS_FUN
+  split_rr_lanes(hipc::atomic<hshm::min_i32> &rr, size_t nlanes)
+      : lane_((uint16_t)rr.fetch_add(1) % nlanes), nlanes_(nlanes) {}
+
+  /** Number of probes before giving up */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetProbeCount() const { return nlanes_; }
+
+  /** The lane of the \a i-th probe */
+  HSHM_INLINE_CROSS_FUN
+  size_t Probe(size_t i) const { return (lane_ + i) % nlanes_; }
+};
+
+/**
+ * Lane policy which maps each thread to a home split by its CPU
+ * (BY_CPU) or its thread id. Threads touch no shared state to pick a
+ * lane. When the home split is empty or full, the remaining splits are
+ * probed starting from a random victim, so stealing threads spread out.
+ * */
+template <bool BY_CPU>
+struct split_affine_lanes {
+  size_t home_;
+  size_t nlanes_;
+  size_t victim_;
+
+  /** Pick the home lane of the calling thread */
+  HSHM_INLINE_CROSS_FUN
+  split_affine_lanes(hipc::atomic<hshm::min_i32> &rr, size_t nlanes)
+      : home_(GetHome() % nlanes), nlanes_(nlanes), victim_(nlanes) {
+    (void)rr;
+  }
+
+  /** Number of probes before giving up: home, then every other lane */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetProbeCount() const { return nlanes_; }
+
+  /** The lane of the \a i-th probe. Probes after the first skip home_. */
+  HSHM_INLINE_CROSS_FUN
+  size_t Probe(size_t i) {
+    if (i == 0) {
+      return home_;
+    }
+    if (victim_ == nlanes_) {
+      victim_ = GetRandom() % (nlanes_ - 1);
+    }
+    return (home_ + 1 + (victim_ + i - 1) % (nlanes_ - 1)) % nlanes_;
+  }
+
+ private:
+  /** The CPU or thread id of the caller */
+  HSHM_INLINE_CROSS_FUN
+  static size_t GetHome() {
+#ifdef HSHM_HAS_SCHED_GETCPU
+    if constexpr (BY_CPU) {
+      int cpu = sched_getcpu();
+      if (cpu >= 0) {
+        return (size_t)cpu;
+      }
+    }
+#endif
+    return (size_t)HSHM_THREAD_MODEL->GetTid().tid_;
+  }
+
+  /** A cheap random number, only drawn when the home lane fails */
+  HSHM_INLINE_CROSS_FUN
+  size_t GetRandom() const {
+    hshm::u64 x = home_;
+#ifdef HSHM_IS_HOST
+    x ^= (hshm::u64)std::chrono::steady_clock::now()
+             .time_since_epoch()
+             .count();
+#endif
+    // splitmix64 finalizer
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return (size_t)(x ^ (x >> 31));
+  }
+};
+
+/** Prefer the split of the CPU the caller runs on */
+typedef split_affine_lanes<true> split_cpu_lanes;
+/** Prefer the split of the caller's thread id */
+typedef split_affine_lanes<false> split_tid_lanes;
+
 /** Forward declaration of split_ticket_queue */
-template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+template <typename T, typename LaneT = split_tid_lanes,
+          HSHM_CLASS_TEMPL_WITH_DEFAULTS>
 class split_ticket_queue;
 
 /**
@@ -29,13 +132,14 @@ class split_ticket_queue;
  * Used as inputs to the HIPC_CONTAINER_TEMPLATE
  * */
 #define CLASS_NAME split_ticket_queue
-#define CLASS_NEW_ARGS T
+#define CLASS_NEW_ARGS T, LaneT
 
 /**
  * A MPMC queue for allocating tickets. Handles concurrency
- * without blocking.
+ * without blocking. Tickets are sharded over several ticket_queues;
+ * LaneT decides which shards an operation probes and in which order.
  * */
-template <typename T, HSHM_CLASS_TEMPL>
+template <typename T, typename LaneT, HSHM_CLASS_TEMPL>
 class split_ticket_queue : public ShmContainer {
  public:
   HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
@@ -176,16 +280,14 @@ class split_ticket_queue : public ShmContainer {
    * ticket Queue Methods
    * ===================================*/
 
-  /** Construct an element at \a pos position in the queue */
-  template <typename... Args>
-  HSHM_CROSS_FUN qtok_t emplace(T &tkt) {
-    uint16_t rr = rr_tail_.fetch_add(1);
+  /** Emplace a ticket in the first split with space. Null if all full. */
+  HSHM_CROSS_FUN
+  qtok_t emplace(const T &tkt) {
     auto &splits = (*splits_);
-    size_t num_splits = splits.size();
-    uint16_t qid_start = rr % num_splits;
-    for (size_t i = 0; i < num_splits; ++i) {
-      uint32_t qid = (qid_start + i) % num_splits;
-      ticket_queue_t &queue = (*splits_)[qid];
+    LaneT lanes(rr_tail_, splits.size());
+    size_t nprobes = lanes.GetProbeCount();
+    for (size_t i = 0; i < nprobes; ++i) {
+      ticket_queue_t &queue = splits[lanes.Probe(i)];
       qtok_t qtok = queue.emplace(tkt);
       if (!qtok.IsNull()) {
         return qtok;
@@ -195,16 +297,14 @@ class split_ticket_queue : public ShmContainer {
   }
 
  public:
-  /** Pop an element from the queue */
+  /** Pop a ticket from the first non-empty split. Null if all empty. */
   HSHM_CROSS_FUN
   qtok_t pop(T &tkt) {
-    uint16_t rr = rr_head_.fetch_add(1);
     auto &splits = (*splits_);
-    size_t num_splits = splits.size();
-    uint16_t qid_start = rr % num_splits;
-    for (size_t i = 0; i < num_splits; ++i) {
-      uint32_t qid = (qid_start + i) % num_splits;
-      ticket_queue_t &queue = (*splits_)[qid];
+    LaneT lanes(rr_head_, splits.size());
+    size_t nprobes = lanes.GetProbeCount();
+    for (size_t i = 0; i < nprobes; ++i) {
+      ticket_queue_t &queue = splits[lanes.Probe(i)];
       qtok_t qtok = queue.pop(tkt);
       if (!qtok.IsNull()) {
         return qtok;
@@ -218,8 +318,10 @@ class split_ticket_queue : public ShmContainer {
 
 namespace hshm {
 
-template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
-using split_ticket_queue = hipc::split_ticket_queue<T, HSHM_CLASS_TEMPL_ARGS>;
+template <typename T, typename LaneT = hipc::split_tid_lanes,
+          HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using split_ticket_queue =
+    hipc::split_ticket_queue<T, LaneT, HSHM_CLASS_TEMPL_ARGS>;
 
 }  // namespace hshm
 
@@ -14,6 +14,7 @@
 #define HSHM_DATA_STRUCTURES_LOCKLESS_STRING_H_
 
 #include <string>
+#include <string_view>
 
 #include "chararr.h"
 #include "hermes_shm/data_structures/internal/shm_internal.h"
@@ -45,6 +46,7 @@ template <size_t SSO, u32 FLAGS, HSHM_CLASS_TEMPL>
 class string_templ : public ShmContainer {
  public:
   HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  HSHM_TRIVIALLY_RELOCATABLE
 
  public:
   size_t length_, max_length_;
@@ -476,6 +478,9 @@ class string_templ : public ShmContainer {
   bool operator op(const std::string &other) const {                           \
     return hshm::strncmp(data(), size(), other.data(), other.size()) op 0;     \
   }                                                                            \
+  bool operator op(std::string_view other) const {                             \
+    return hshm::strncmp(data(), size(), other.data(), other.size()) op 0;     \
+  }                                                                            \
   template <size_t SSO1, u32 FLAGS1, HSHM_CLASS_TEMPL2>                        \
   bool operator op(                                                            \
       const string_templ<SSO1, FLAGS1, HSHM_CLASS_TEMPL_ARGS2> &other) const { \
@@ -546,16 +551,14 @@ struct hash<hshm::ipc::string_templ<SSO, FLAGS, HSHM_CLASS_TEMPL_ARGS>> {
 };
 }  // namespace std
 
-/** hshm::hash function for string */
+/**
+ * hshm::hash function for string. Transparent, so maps keyed by string
+ * can be searched with a const char *, std::string, or std::string_view.
+ * */
 namespace hshm {
 template <size_t SSO, u32 FLAGS, HSHM_CLASS_TEMPL>
-struct hash<hshm::ipc::string_templ<SSO, FLAGS, HSHM_CLASS_TEMPL_ARGS>> {
-  HSHM_CROSS_FUN size_t operator()(
-      const hshm::ipc::string_templ<SSO, FLAGS, HSHM_CLASS_TEMPL_ARGS> &text)
-      const {
-    return text.Hash();
-  }
-};
+struct hash<hshm::ipc::string_templ<SSO, FLAGS, HSHM_CLASS_TEMPL_ARGS>>
+    : public transparent_string_hash {};
 }  // namespace hshm
 
 #undef CLASS_NAME
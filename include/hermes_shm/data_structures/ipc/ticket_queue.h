@@ -14,9 +14,8 @@
 #define HSHM_SHM_INCLUDE_HSHM_SHM_DATA_STRUCTURES_IPC_TICKET_QUEUE_H_
 
 #include "hermes_shm/data_structures/internal/shm_internal.h"
-#include "hermes_shm/thread/lock.h"
 #include "hermes_shm/types/qtok.h"
-#include "ring_queue.h"
+#include "mpmc_ring_queue.h"
 
 namespace hshm::ipc {
 
@@ -33,14 +32,16 @@ class ticket_queue;
 
 /**
  * A MPMC queue for allocating tickets. Handles concurrency
- * without blocking.
+ * without blocking: tickets are stored in a sequenced mpmc_ring_queue,
+ * so producers and consumers only contend on their own end of the ring.
+ * The depth is rounded up to a power of two.
  * */
 template <typename T, HSHM_CLASS_TEMPL>
 class ticket_queue : public ShmContainer {
  public:
   HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
-  delay_ar<fixed_spsc_queue<T, HSHM_CLASS_TEMPL_ARGS>> queue_;
-  hshm::Mutex lock_;
+  typedef mpmc_ring_queue<T, HSHM_CLASS_TEMPL_ARGS> queue_t;
+  delay_ar<queue_t> queue_;
 
  public:
   /**====================================
@@ -64,7 +65,6 @@ class ticket_queue : public ShmContainer {
   void shm_init(const hipc::CtxAllocator<AllocT> &alloc, size_t depth = 1024) {
     init_shm_container(alloc);
     HSHM_MAKE_AR(queue_, GetCtxAllocator(), depth);
-    lock_.Init();
     SetNull();
   }
 
@@ -76,7 +76,7 @@ class ticket_queue : public ShmContainer {
   HSHM_CROSS_FUN
   explicit ticket_queue(const ticket_queue &other) {
     init_shm_container(other.GetCtxAllocator());
-    SetNull();
+    HSHM_MAKE_AR(queue_, GetCtxAllocator(), other.queue_->GetDepth());
     shm_strong_copy_op(other);
   }
 
@@ -85,7 +85,7 @@ class ticket_queue : public ShmContainer {
   explicit ticket_queue(const hipc::CtxAllocator<AllocT> &alloc,
                         const ticket_queue &other) {
     init_shm_container(alloc);
-    SetNull();
+    HSHM_MAKE_AR(queue_, GetCtxAllocator(), other.queue_->GetDepth());
     shm_strong_copy_op(other);
   }
 
@@ -93,7 +93,6 @@ class ticket_queue : public ShmContainer {
   HSHM_CROSS_FUN
   ticket_queue &operator=(const ticket_queue &other) {
     if (this != &other) {
-      shm_destroy();
       shm_strong_copy_op(other);
     }
     return *this;
@@ -137,6 +136,7 @@ class ticket_queue : public ShmContainer {
                                   ticket_queue &&other) noexcept {
     if constexpr (!IS_ASSIGN) {
       init_shm_container(alloc);
+      HSHM_MAKE_AR(queue_, GetCtxAllocator(), 0);
     }
     if (GetAllocator() == other.GetAllocator()) {
       (*queue_) = std::move(*other.queue_);
@@ -167,23 +167,20 @@ class ticket_queue : public ShmContainer {
    * ticket Queue Methods
    * ===================================*/
 
-  /** Construct an element at \a pos position in the queue */
-  template <typename... Args>
-  HSHM_INLINE_CROSS_FUN qtok_t emplace(T &tkt) {
-    lock_.Lock(0);
-    auto qtok = queue_->emplace(tkt);
-    lock_.Unlock();
-    return qtok;
+  /** Emplace a ticket in the queue. Null if the queue is full. */
+  HSHM_INLINE_CROSS_FUN qtok_t emplace(const T &tkt) {
+    return queue_->emplace(tkt);
   }
 
  public:
-  /** Pop an element from the queue */
-  HSHM_INLINE_CROSS_FUN qtok_t pop(T &tkt) {
-    lock_.Lock(0);
-    auto qtok = queue_->pop(tkt);
-    lock_.Unlock();
-    return qtok;
-  }
+  /** Pop a ticket from the queue. Null if the queue is empty. */
+  HSHM_INLINE_CROSS_FUN qtok_t pop(T &tkt) { return queue_->pop(tkt); }
+
+  /** Get queue depth */
+  HSHM_INLINE_CROSS_FUN size_t GetDepth() { return queue_->GetDepth(); }
+
+  /** Get size at this moment */
+  HSHM_INLINE_CROSS_FUN size_t GetSize() { return queue_->GetSize(); }
 };
 
 }  // namespace hshm::ipc
@@ -42,6 +42,7 @@ struct unordered_map_iterator {
   unordered_map<Key, T, Hash, HSHM_CLASS_TEMPL_ARGS> *map_;
   typename BUCKET_VEC_T::iterator_t bucket_;
   typename COLLISION_LIST_T::iterator_t collision_;
+  bool old_ = false; /**< Whether bucket_ is in the buckets being rehashed */
 
   /** Default constructor */
   HSHM_CROSS_FUN unordered_map_iterator() = default;
@@ -72,6 +73,7 @@ struct unordered_map_iterator {
     map_ = other.map_;
     bucket_ = other.bucket_;
     collision_ = other.collision_;
+    old_ = other.old_;
   }
 
   /** Get the pointed object */
@@ -99,6 +101,8 @@ struct unordered_map_iterator {
   /**
    * Shifts bucket and collision iterator until there is a valid element.
    * Returns true if such an element is found, and false otherwise.
+   * During a rehash, the new buckets are visited first and then the old
+   * buckets which have not been moved yet.
    * */
   HSHM_INLINE_CROSS_FUN bool make_correct() {
     do {
@@ -110,7 +114,14 @@ struct unordered_map_iterator {
       } else {
         ++bucket_;
         if (bucket_.is_end()) {
-          return false;
+          if (old_ || !map_->IsRehashing()) {
+            return false;
+          }
+          old_ = true;
+          bucket_ = map_->GetOldBuckets().begin() + map_->rehash_idx_;
+          if (bucket_.is_end()) {
+            return false;
+          }
         }
         BUCKET_T &bkt = *bucket_;
         collision_ = bkt.begin();
@@ -152,12 +163,20 @@ struct unordered_map_iterator {
 #define CLASS_NEW_ARGS Key, T, Hash
 
 /**
- * The unordered map implementation
+ * The unordered map implementation. Buckets are slists of (key, value)
+ * pairs. Once the entry count exceeds max_capacity (the max load factor)
+ * times the bucket count, a bucket vector \a growth times larger is made
+ * and entries are moved into it incrementally: each insert and erase
+ * moves the entries of a few old buckets, so no single operation pays
+ * for a full rehash. find() does not modify the map, so it remains safe
+ * under a shared read lock. Entries are relinked rather than reallocated,
+ * so references to them stay valid while the table grows.
  * */
 template <typename Key, typename T, class Hash, HSHM_CLASS_TEMPL>
 class unordered_map : public ShmContainer {
  public:
   HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  HSHM_TRIVIALLY_RELOCATABLE
 
   /**====================================
    * Typedefs
@@ -168,11 +187,25 @@ class unordered_map : public ShmContainer {
   using COLLISION_T = hipc::pair<Key, T, HSHM_CLASS_TEMPL_ARGS>;
   using BUCKET_T = hipc::slist<COLLISION_T, HSHM_CLASS_TEMPL_ARGS>;
   using BUCKET_VEC_T = hipc::vector<BUCKET_T, HSHM_CLASS_TEMPL_ARGS>;
+  /**
+   * Types find, contains, and erase accept as keys: Key, types convertible
+   * to Key, and anything else if Hash is transparent
+   * */
+  template <typename K>
+  using lookup_key_t = std::enable_if_t<
+      !std::is_same_v<K, iterator_t> &&
+          (std::is_convertible_v<const K &, Key> ||
+           hshm::hash_is_transparent<Hash>::value),
+      int>;
+  /** The number of old buckets moved by each operation during a rehash */
+  static constexpr size_t kRehashStep = 8;
 
   /**====================================
    * Variables
    * ===================================*/
   delay_ar<BUCKET_VEC_T> buckets_;
+  delay_ar<BUCKET_VEC_T> old_buckets_; /**< Buckets still being rehashed */
+  hshm::size_t rehash_idx_;            /**< The next old bucket to rehash */
   RealNumber max_capacity_;
   RealNumber growth_;
   hipc::atomic<hshm::size_t> length_;
@@ -222,6 +255,8 @@ class unordered_map : public ShmContainer {
                 RealNumber growth = RealNumber(5, 4)) {
     init_shm_container(alloc);
     HSHM_MAKE_AR(buckets_, GetCtxAllocator(), num_buckets)
+    HSHM_MAKE_AR0(old_buckets_, GetCtxAllocator())
+    rehash_idx_ = 0;
     max_capacity_ = max_capacity;
     growth_ = growth;
     length_ = 0;
@@ -250,7 +285,9 @@ class unordered_map : public ShmContainer {
   HSHM_CROSS_FUN
   void shm_strong_copy_construct(const unordered_map &other) {
     SetNull();
-    HSHM_MAKE_AR(buckets_, GetCtxAllocator(), other.GetBuckets())
+    HSHM_MAKE_AR0(buckets_, GetCtxAllocator())
+    HSHM_MAKE_AR0(old_buckets_, GetCtxAllocator())
+    rehash_idx_ = 0;
     shm_strong_copy_op(other);
   }
 
@@ -269,6 +306,7 @@ class unordered_map : public ShmContainer {
   void shm_strong_copy_op(const unordered_map &other) {
     int num_buckets = other.get_num_buckets();
     GetBuckets().resize(num_buckets);
+    length_ = 0;
     max_capacity_ = other.max_capacity_;
     growth_ = other.growth_;
     for (hipc::pair<Key, T, HSHM_CLASS_TEMPL_ARGS> &entry : other) {
@@ -306,7 +344,12 @@ class unordered_map : public ShmContainer {
                                   unordered_map &&other) noexcept {
     if constexpr (!IS_ASSIGN) {
       init_shm_container(alloc);
+      HSHM_MAKE_AR0(old_buckets_, GetCtxAllocator())
+      rehash_idx_ = 0;
+    } else {
+      shm_destroy();
     }
+    other.FinishRehash();
     if (GetAllocator() == other.GetAllocator()) {
       if constexpr (IS_ASSIGN) {
         GetBuckets() = std::move(other.GetBuckets());
@@ -332,12 +375,17 @@ class unordered_map : public ShmContainer {
   HSHM_INLINE_CROSS_FUN bool IsNull() { return buckets_->IsNull(); }
 
   /** Sets this pair as empty */
-  HSHM_INLINE_CROSS_FUN void SetNull() { buckets_->SetNull(); }
+  HSHM_INLINE_CROSS_FUN void SetNull() {
+    buckets_->SetNull();
+    old_buckets_->SetNull();
+    rehash_idx_ = 0;
+  }
 
   /** Destroy the unordered_map buckets */
   HSHM_INLINE_CROSS_FUN void shm_destroy_main() {
     BUCKET_VEC_T &buckets = GetBuckets();
     buckets.shm_destroy();
+    GetOldBuckets().shm_destroy();
   }
 
   /**====================================
@@ -381,9 +429,13 @@ class unordered_map : public ShmContainer {
    * */
   template <bool growth, bool modify_existing, typename... Args>
   HSHM_INLINE_CROSS_FUN bool emplace_templ(const Key &key, Args &&...args) {
+    if constexpr (growth) {
+      RehashStep();
+    }
+
     // Hash the key to a bucket
-    BUCKET_VEC_T &buckets = GetBuckets();
-    size_t bkt_id = Hash{}(key) % buckets.size();
+    size_t bkt_id;
+    BUCKET_VEC_T &buckets = GetKeyBuckets(Hash{}(key), bkt_id);
     BUCKET_T &bkt = (buckets)[bkt_id];
 
     // Insert into the map
@@ -401,9 +453,86 @@ class unordered_map : public ShmContainer {
 
     // Increment the size of the map
     ++length_;
+    if constexpr (growth) {
+      GrowIfNeeded();
+    }
     return true;
   }
 
+  /** Start a rehash if the load factor exceeds max_capacity */
+  HSHM_CROSS_FUN
+  void GrowIfNeeded() {
+    size_t num_buckets = GetBuckets().size();
+    if (length_.load() <= (max_capacity_ * num_buckets).as_int()) {
+      return;
+    }
+    FinishRehash();
+    size_t new_size = (growth_ * num_buckets).as_int();
+    if (new_size <= num_buckets) {
+      new_size = num_buckets + 1;
+    }
+    StartRehash(new_size);
+  }
+
+  /** Make \a num_buckets new buckets and mark the current ones as old */
+  HSHM_CROSS_FUN
+  void StartRehash(size_t num_buckets) {
+    GetOldBuckets() = std::move(GetBuckets());
+    GetBuckets().resize(num_buckets);
+    rehash_idx_ = 0;
+  }
+
+  /**
+   * Move the entries of the next \a count old buckets into the new
+   * buckets. The old buckets are freed once all of them are moved.
+   * */
+  HSHM_CROSS_FUN
+  void RehashStep(size_t count = kRehashStep) {
+    if (!IsRehashing()) {
+      return;
+    }
+    BUCKET_VEC_T &old_buckets = GetOldBuckets();
+    BUCKET_VEC_T &buckets = GetBuckets();
+    size_t num_old = old_buckets.size();
+    for (; count > 0 && rehash_idx_ < num_old; --count, ++rehash_idx_) {
+      BUCKET_T &old_bkt = old_buckets[rehash_idx_];
+      while (old_bkt.size()) {
+        size_t bkt_id = Hash{}(old_bkt.front().GetKey()) % buckets.size();
+        buckets[bkt_id].splice_front(old_bkt);
+      }
+    }
+    if (rehash_idx_ == num_old) {
+      old_buckets.shm_destroy();
+      rehash_idx_ = 0;
+    }
+  }
+
+  /** Move every remaining old bucket into the new buckets */
+  HSHM_CROSS_FUN
+  void FinishRehash() {
+    while (IsRehashing()) {
+      RehashStep(GetOldBuckets().size());
+    }
+  }
+
+  /**
+   * Get the bucket vector holding \a hash and its bucket index. During a
+   * rehash, keys stay in the old buckets until their bucket is moved.
+   * */
+  HSHM_INLINE_CROSS_FUN
+  BUCKET_VEC_T &GetKeyBuckets(size_t hash, size_t &bkt_id) {
+    if (IsRehashing()) {
+      BUCKET_VEC_T &old_buckets = GetOldBuckets();
+      bkt_id = hash % old_buckets.size();
+      if (bkt_id >= rehash_idx_) {
+        return old_buckets;
+      }
+    }
+    BUCKET_VEC_T &buckets = GetBuckets();
+    bkt_id = hash % buckets.size();
+    return buckets;
+  }
+
  public:
   /**====================================
    * Erase Methods
@@ -412,15 +541,27 @@ class unordered_map : public ShmContainer {
   /**
    * Erase an object indexable by \a key key
    * */
-  HSHM_CROSS_FUN
-  void erase(const Key &key) {
+  template <typename K, lookup_key_t<K> = 0>
+  HSHM_CROSS_FUN void erase(const K &key) {
+    auto &&lookup_key = LookupKey(key);
+    erase(lookup_key, Hash{}(lookup_key));
+  }
+
+  /**
+   * Erase an object indexable by \a key key, where \a hash is the
+   * hash of key computed by the caller with hash_function()
+   * */
+  template <typename K, lookup_key_t<K> = 0>
+  HSHM_CROSS_FUN void erase(const K &key, size_t hash) {
+    RehashStep();
+
     // Get the bucket the key belongs to
-    BUCKET_VEC_T &buckets = GetBuckets();
-    size_t bkt_id = Hash{}(key) % buckets.size();
+    size_t bkt_id;
+    BUCKET_VEC_T &buckets = GetKeyBuckets(hash, bkt_id);
     BUCKET_T &bkt = (buckets)[bkt_id];
 
     // Find and remove key from collision slist
-    auto iter = find_collision(key, bkt);
+    auto iter = find_collision(LookupKey(key), bkt);
     if (iter.is_end()) {
       return;
     }
@@ -450,6 +591,8 @@ class unordered_map : public ShmContainer {
    * Erase the entire map
    * */
   HSHM_CROSS_FUN void clear() {
+    GetOldBuckets().shm_destroy();
+    rehash_idx_ = 0;
     BUCKET_VEC_T &buckets = GetBuckets();
     size_t num_buckets = buckets.size();
     buckets.clear();
@@ -457,6 +600,39 @@ class unordered_map : public ShmContainer {
     length_ = 0;
   }
 
+  /**
+   * Make enough buckets to hold \a count entries without exceeding the
+   * max load factor. The rehash, if any, is done here rather than spread
+   * over later operations.
+   * */
+  HSHM_CROSS_FUN void reserve(size_t count) {
+    hshm::u64 load = max_capacity_.decimal_ * RealNumber::precision +
+                     max_capacity_.numerator_;
+    if (load == 0) {
+      return;
+    }
+    size_t num_buckets = (count * RealNumber::precision + load - 1) / load;
+    if (num_buckets <= GetBuckets().size()) {
+      return;
+    }
+    FinishRehash();
+    StartRehash(num_buckets);
+    FinishRehash();
+  }
+
+  /**
+   * Set the max load factor (entries per bucket) before the map grows.
+   * Takes effect on the next insert.
+   * */
+  HSHM_INLINE_CROSS_FUN void max_load_factor(RealNumber max_capacity) {
+    max_capacity_ = max_capacity;
+  }
+
+  /** The max load factor (entries per bucket) before the map grows */
+  HSHM_INLINE_CROSS_FUN RealNumber max_load_factor() const {
+    return max_capacity_;
+  }
+
   /**====================================
    * Index Methods
    * ===================================*/
@@ -475,28 +651,74 @@ class unordered_map : public ShmContainer {
     HSHM_THROW_ERROR(UNORDERED_MAP_CANT_FIND);
   }
 
-  /** Find an object in the unordered_map */
-  HSHM_CROSS_FUN
-  iterator_t find(const Key &key) {
+  /**
+   * Find an object in the unordered_map. With a transparent Hash, \a key
+   * can be any type Hash accepts and Key compares equal to (e.g., a
+   * std::string_view for hipc::string keys), so no Key is constructed.
+   * */
+  template <typename K, lookup_key_t<K> = 0>
+  HSHM_CROSS_FUN iterator_t find(const K &key) {
+    auto &&lookup_key = LookupKey(key);
+    return find(lookup_key, Hash{}(lookup_key));
+  }
+
+  /**
+   * Find an object in the unordered_map, where \a hash is the hash of
+   * \a key computed by the caller with hash_function()
+   * */
+  template <typename K, lookup_key_t<K> = 0>
+  HSHM_CROSS_FUN iterator_t find(const K &key, size_t hash) {
     iterator_t iter(*this);
 
     // Determine the bucket corresponding to the key
-    BUCKET_VEC_T &buckets = GetBuckets();
-    size_t bkt_id = Hash{}(key) % buckets.size();
+    size_t bkt_id;
+    BUCKET_VEC_T &buckets = GetKeyBuckets(hash, bkt_id);
     iter.bucket_ = buckets.begin() + bkt_id;
+    iter.old_ = &buckets == &GetOldBuckets();
     BUCKET_T &bkt = (*iter.bucket_);
 
     // Get the specific collision iterator
-    iter.collision_ = find_collision(key, bkt);
+    iter.collision_ = find_collision(LookupKey(key), bkt);
     if (iter.collision_.is_end()) {
       iter.set_end();
     }
     return iter;
   }
 
+  /** Whether the map has an entry for \a key */
+  template <typename K, lookup_key_t<K> = 0>
+  HSHM_INLINE_CROSS_FUN bool contains(const K &key) {
+    return !find(key).is_end();
+  }
+
+  /** Whether the map has an entry for \a key, whose hash is \a hash */
+  template <typename K, lookup_key_t<K> = 0>
+  HSHM_INLINE_CROSS_FUN bool contains(const K &key, size_t hash) {
+    return !find(key, hash).is_end();
+  }
+
+  /** The hash function of the map, for precomputing key hashes */
+  HSHM_INLINE_CROSS_FUN Hash hash_function() const { return Hash{}; }
+
+ private:
+  /**
+   * Pass \a key through if Hash is transparent. Otherwise, convert it to
+   * Key once so it is not converted on every hash and comparison.
+   * */
+  template <typename K>
+  HSHM_INLINE_CROSS_FUN static decltype(auto) LookupKey(const K &key) {
+    if constexpr (std::is_same_v<K, Key> ||
+                  hshm::hash_is_transparent<Hash>::value) {
+      return (key);
+    } else {
+      return Key(key);
+    }
+  }
+
   /** Find a key in the collision slist */
+  template <typename K>
   typename BUCKET_T::iterator_t HSHM_INLINE_CROSS_FUN
-  find_collision(const Key &key, BUCKET_T &bkt) {
+  find_collision(const K &key, BUCKET_T &bkt) {
     auto iter = bkt.begin();
     auto iter_end = bkt.end();
     for (; iter != iter_end; ++iter) {
@@ -508,6 +730,7 @@ class unordered_map : public ShmContainer {
     return iter_end;
   }
 
+ public:
   /**====================================
    * Query Methods
    * ===================================*/
@@ -521,6 +744,11 @@ class unordered_map : public ShmContainer {
     return buckets.size();
   }
 
+  /** Whether entries are still being moved into new buckets */
+  HSHM_INLINE_CROSS_FUN bool IsRehashing() const {
+    return !GetOldBuckets().IsNull();
+  }
+
  public:
   /**====================================
    * Iterators
@@ -555,6 +783,14 @@ class unordered_map : public ShmContainer {
   HSHM_INLINE_CROSS_FUN BUCKET_VEC_T &GetBuckets() const {
     return const_cast<BUCKET_VEC_T &>(*buckets_);
   }
+
+  /** Get the buckets being rehashed */
+  HSHM_INLINE_CROSS_FUN BUCKET_VEC_T &GetOldBuckets() { return *old_buckets_; }
+
+  /** Get the buckets being rehashed (const) */
+  HSHM_INLINE_CROSS_FUN BUCKET_VEC_T &GetOldBuckets() const {
+    return const_cast<BUCKET_VEC_T &>(*old_buckets_);
+  }
 };
 
 }  // namespace hshm::ipc
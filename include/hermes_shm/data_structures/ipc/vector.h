@@ -13,6 +13,8 @@
 #ifndef HSHM_DATA_STRUCTURES_LOCKLESS_VECTOR_H_
 #define HSHM_DATA_STRUCTURES_LOCKLESS_VECTOR_H_
 
+#include <cfloat>
+#include <cstdint>
 #include <vector>
 
 #include "hermes_shm/data_structures/internal/shm_internal.h"
@@ -20,17 +22,17 @@
 
 namespace hshm::ipc {
 
-/** forward pointer for vector */
-template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
-class vector;
+/** forward pointer for vector_templ */
+template <typename T, size_t N, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class vector_templ;
 
 /**
  * The vector iterator implementation
  * */
-template <typename T, bool FORWARD_ITER, HSHM_CLASS_TEMPL>
+template <typename T, size_t N, bool FORWARD_ITER, HSHM_CLASS_TEMPL>
 struct vector_iterator_templ {
  public:
-  vector<T, HSHM_CLASS_TEMPL_ARGS> *vec_;
+  vector_templ<T, N, HSHM_CLASS_TEMPL_ARGS> *vec_;
   i64 i_;
 
   /** Default constructor */
@@ -39,12 +41,12 @@ struct vector_iterator_templ {
   /** Construct an iterator (called from vector class) */
   template <typename SizeT>
   HSHM_INLINE_CROSS_FUN explicit vector_iterator_templ(
-      vector<T, HSHM_CLASS_TEMPL_ARGS> *vec, SizeT i)
+      vector_templ<T, N, HSHM_CLASS_TEMPL_ARGS> *vec, SizeT i)
       : vec_(vec), i_(static_cast<i64>(i)) {}
 
   /** Construct an iterator (called from iterator) */
   HSHM_INLINE_CROSS_FUN explicit vector_iterator_templ(
-      vector<T, HSHM_CLASS_TEMPL_ARGS> *vec, i64 i)
+      vector_templ<T, N, HSHM_CLASS_TEMPL_ARGS> *vec, i64 i)
       : vec_(vec), i_(i) {}
 
   /** Copy constructor */
@@ -206,18 +208,31 @@ struct vector_iterator_templ {
   }
 };
 
+/** The first N elements of a vector_templ, stored in the container */
+template <typename T, size_t N>
+struct vector_inline_storage {
+  alignas(T) delay_ar<T> inline_[N];
+};
+
+/** No inline elements */
+template <typename T>
+struct vector_inline_storage<T, 0> {};
+
 /**
  * MACROS used to simplify the vector namespace
  * Used as inputs to the HIPC_CONTAINER_TEMPLATE
  * */
-#define CLASS_NAME vector
-#define CLASS_NEW_ARGS T
+#define CLASS_NAME vector_templ
+#define CLASS_NEW_ARGS T, N
 
 /**
- * The vector class
+ * The vector class. The first N elements are stored inline in the
+ * container object, and the vector only allocates once it grows beyond
+ * them. Elements never move back inline. N is 0 for hipc::vector and
+ * positive for hipc::small_vector.
  * */
-template <typename T, HSHM_CLASS_TEMPL>
-class vector : public ShmContainer {
+template <typename T, size_t N, HSHM_CLASS_TEMPL>
+class vector_templ : public ShmContainer, public vector_inline_storage<T, N> {
  public:
   HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
 
@@ -227,20 +242,29 @@ class vector : public ShmContainer {
    * ===================================*/
 
   /** forwrard iterator */
-  typedef vector_iterator_templ<T, true, HSHM_CLASS_TEMPL_ARGS> iterator_t;
+  typedef vector_iterator_templ<T, N, true, HSHM_CLASS_TEMPL_ARGS> iterator_t;
   /** reverse iterator */
-  typedef vector_iterator_templ<T, false, HSHM_CLASS_TEMPL_ARGS> riterator_t;
+  typedef vector_iterator_templ<T, N, false, HSHM_CLASS_TEMPL_ARGS>
+      riterator_t;
   /** const iterator */
-  typedef vector_iterator_templ<T, true, HSHM_CLASS_TEMPL_ARGS> citerator_t;
+  typedef vector_iterator_templ<T, N, true, HSHM_CLASS_TEMPL_ARGS> citerator_t;
   /** const reverse iterator */
-  typedef vector_iterator_templ<T, false, HSHM_CLASS_TEMPL_ARGS> criterator_t;
+  typedef vector_iterator_templ<T, N, false, HSHM_CLASS_TEMPL_ARGS>
+      criterator_t;
+  /** Whether elements are moved with memmove and realloc */
+  static constexpr bool kRelocatable = is_trivially_relocatable_v<T>;
+  /** Whether ranges of elements are copied with memcpy */
+  static constexpr bool kTriviallyCopyable = std::is_trivially_copyable_v<T>;
+  /** The default factor the capacity is multiplied by on growth */
+  static constexpr float kDefaultGrowth = 1.25f;
 
  public:
   /**====================================
    * Variables
    * ===================================*/
-  OffsetPointer vec_ptr_;
+  OffsetPointer vec_ptr_; /**< Allocated elements, or null while inline */
   size_t max_length_, length_;
+  float growth_ = kDefaultGrowth;
 
  public:
   /**====================================
@@ -249,29 +273,29 @@ class vector : public ShmContainer {
 
   /** SHM constructor. Default. */
   HSHM_CROSS_FUN
-  explicit vector() {
+  explicit vector_templ() {
     init_shm_container(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>());
     SetNull();
   }
 
   /** SHM constructor. Default. */
   HSHM_CROSS_FUN
-  explicit vector(const hipc::CtxAllocator<AllocT> &alloc) {
+  explicit vector_templ(const hipc::CtxAllocator<AllocT> &alloc) {
     init_shm_container(alloc);
     SetNull();
   }
 
   /** Constructor. Resize + construct. */
   template <typename... Args>
-  HSHM_CROSS_FUN explicit vector(size_t length, Args &&...args) {
+  HSHM_CROSS_FUN explicit vector_templ(size_t length, Args &&...args) {
     shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), length,
              std::forward<Args>(args)...);
   }
 
   /** SHM constructor. Resize + construct. */
   template <typename... Args>
-  HSHM_CROSS_FUN explicit vector(const hipc::CtxAllocator<AllocT> &alloc,
-                                 size_t length, Args &&...args) {
+  HSHM_CROSS_FUN explicit vector_templ(const hipc::CtxAllocator<AllocT> &alloc,
+                                       size_t length, Args &&...args) {
     shm_init(alloc, length, std::forward<Args>(args)...);
   }
 
@@ -290,43 +314,43 @@ class vector : public ShmContainer {
 
   /** Copy constructor. From vector. */
   HSHM_CROSS_FUN
-  explicit vector(const vector &other) {
+  explicit vector_templ(const vector_templ &other) {
     init_shm_container(other.GetCtxAllocator());
     SetNull();
-    shm_strong_copy_main<vector<T, HSHM_CLASS_TEMPL_ARGS>>(other);
+    shm_strong_copy_main<vector_templ>(other);
   }
 
   /** SHM copy constructor. From vector. */
   HSHM_CROSS_FUN
-  explicit vector(const hipc::CtxAllocator<AllocT> &alloc,
-                  const vector &other) {
+  explicit vector_templ(const hipc::CtxAllocator<AllocT> &alloc,
+                        const vector_templ &other) {
     init_shm_container(alloc);
     SetNull();
-    shm_strong_copy_main<vector<T, HSHM_CLASS_TEMPL_ARGS>>(other);
+    shm_strong_copy_main<vector_templ>(other);
   }
 
   /** SHM copy assignment operator. From vector. */
   HSHM_CROSS_FUN
-  vector &operator=(const vector &other) {
+  vector_templ &operator=(const vector_templ &other) {
     if (this != &other) {
       shm_destroy();
-      shm_strong_copy_main<vector>(other);
+      shm_strong_copy_main<vector_templ>(other);
     }
     return *this;
   }
 
   /** Copy constructor. From std::vector */
   HSHM_HOST_FUN
-  explicit vector(const std::vector<T> &other) {
-    init_shm_container(other.GetCtxAllocator());
+  explicit vector_templ(const std::vector<T> &other) {
+    init_shm_container(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>());
     SetNull();
     shm_strong_copy_main<std::vector<T>>(other);
   }
 
   /** SHM copy constructor. From std::vector */
   HSHM_HOST_FUN
-  explicit vector(const hipc::CtxAllocator<AllocT> &alloc,
-                  const std::vector<T> &other) {
+  explicit vector_templ(const hipc::CtxAllocator<AllocT> &alloc,
+                        const std::vector<T> &other) {
     init_shm_container(alloc);
     SetNull();
     shm_strong_copy_main<std::vector<T>>(other);
@@ -334,7 +358,7 @@ class vector : public ShmContainer {
 
   /** SHM copy assignment operator. From std::vector */
   HSHM_HOST_FUN
-  vector &operator=(const std::vector<T> &other) {
+  vector_templ &operator=(const std::vector<T> &other) {
     shm_destroy();
     shm_strong_copy_main<std::vector<T>>(other);
     return *this;
@@ -343,15 +367,24 @@ class vector : public ShmContainer {
   /** The main copy operation  */
   template <typename VectorT>
   HSHM_CROSS_FUN void shm_strong_copy_main(const VectorT &other) {
-    reserve(other.size());
-    if constexpr (std::is_pod<T>() && !IS_SHM_ARCHIVEABLE(T)) {
-      memcpy(data(), other.data(), other.size() * sizeof(T));
-      length_ = other.size();
+    if constexpr (std::is_same_v<VectorT, vector_templ>) {
+      growth_ = other.growth_;
+    }
+    size_t count = other.size();
+    if (count == 0) {
+      return;
+    }
+    delay_ar<T> *vec = reserve_for(count);
+    if constexpr (kTriviallyCopyable) {
+      memcpy((void *)vec, (const void *)other.data(), count * sizeof(T));
     } else {
-      for (auto iter = other.cbegin(); iter != other.cend(); ++iter) {
-        emplace_back((*iter));
+      CtxAllocator<AllocT> alloc = GetCtxAllocator();
+      size_t i = 0;
+      for (auto iter = other.cbegin(); iter != other.cend(); ++iter, ++i) {
+        HSHM_MAKE_AR(vec[i], alloc, *iter)
       }
     }
+    length_ = count;
   }
 
   /**====================================
@@ -360,40 +393,63 @@ class vector : public ShmContainer {
 
   /** Move constructor. */
   HSHM_CROSS_FUN
-  vector(vector &&other) {
-    shm_move_op<false>(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(),
-                       std::move(other));
+  vector_templ(vector_templ &&other) {
+    shm_move_op<false>(other.GetCtxAllocator(), std::move(other));
   }
 
   /** SHM move constructor. */
   HSHM_CROSS_FUN
-  vector(const hipc::CtxAllocator<AllocT> &alloc, vector &&other) {
+  vector_templ(const hipc::CtxAllocator<AllocT> &alloc, vector_templ &&other) {
     shm_move_op<false>(alloc, std::move(other));
   }
 
   /** SHM move assignment operator. */
   HSHM_CROSS_FUN
-  vector &operator=(vector &&other) noexcept {
+  vector_templ &operator=(vector_templ &&other) noexcept {
     if (this != &other) {
       shm_move_op<true>(other.GetCtxAllocator(), std::move(other));
     }
     return *this;
   }
 
-  /** SHM move assignment operator. */
+  /**
+   * SHM move operator. Allocated elements are taken over when both
+   * vectors share an allocator. Inline elements are always moved one by
+   * one.
+   * */
   template <bool IS_ASSIGN>
   HSHM_CROSS_FUN void shm_move_op(const hipc::CtxAllocator<AllocT> &alloc,
-                                  vector &&other) noexcept {
-    if constexpr (!IS_ASSIGN) {
+                                  vector_templ &&other) noexcept {
+    if constexpr (IS_ASSIGN) {
+      shm_destroy();
+    } else {
       init_shm_container(alloc);
+      SetNull();
     }
-    if (GetAllocator() == other.GetAllocator()) {
-      memcpy((void *)this, (void *)&other, sizeof(*this));
+    growth_ = other.growth_;
+    if (!other.is_inline() && GetAllocator() == other.GetAllocator()) {
+      vec_ptr_ = other.vec_ptr_;
+      max_length_ = other.max_length_;
+      length_ = other.length_;
       other.SetNull();
-    } else {
-      shm_strong_copy_main<vector>(other);
-      other.shm_destroy();
+      return;
+    }
+    size_t count = other.size();
+    if (count) {
+      delay_ar<T> *vec = reserve_for(count);
+      delay_ar<T> *src = other.data_ar();
+      if constexpr (kRelocatable) {
+        memcpy((void *)vec, (void *)src, count * sizeof(delay_ar<T>));
+        other.length_ = 0;
+      } else {
+        CtxAllocator<AllocT> ctx_alloc = GetCtxAllocator();
+        for (size_t i = 0; i < count; ++i) {
+          HSHM_MAKE_AR(vec[i], ctx_alloc, std::move(src[i].get_ref()))
+        }
+      }
+      length_ = count;
     }
+    other.shm_destroy();
   }
 
   /**====================================
@@ -402,13 +458,13 @@ class vector : public ShmContainer {
 
   /** Check if null */
   HSHM_INLINE_CROSS_FUN
-  bool IsNull() const { return vec_ptr_.IsNull(); }
+  bool IsNull() const { return length_ == 0 && vec_ptr_.IsNull(); }
 
   /** Make null */
   HSHM_INLINE_CROSS_FUN
   void SetNull() {
     length_ = 0;
-    max_length_ = 0;
+    max_length_ = N;
     vec_ptr_.SetNull();
   }
 
@@ -416,8 +472,10 @@ class vector : public ShmContainer {
   HSHM_INLINE_CROSS_FUN
   void shm_destroy_main() {
     erase(begin(), end());
-    CtxAllocator<AllocT> alloc = GetCtxAllocator();
-    alloc->Free(alloc.ctx_, vec_ptr_);
+    if (!vec_ptr_.IsNull()) {
+      CtxAllocator<AllocT> alloc = GetCtxAllocator();
+      alloc->Free(alloc.ctx_, vec_ptr_);
+    }
   }
 
   /**====================================
@@ -437,35 +495,36 @@ class vector : public ShmContainer {
     return v;
   }
 
+  /** Whether the elements are stored inline (or there are none yet) */
+  HSHM_INLINE_CROSS_FUN
+  bool is_inline() const { return vec_ptr_.IsNull(); }
+
   /**
    * Reserve space in the vector to emplace elements. Does not
    * change the size of the list.
    *
    * @param length the maximum size the vector can get before a growth occurs
-   * @param args the arguments to construct
    * */
-  template <typename... Args>
-  HSHM_INLINE_CROSS_FUN void reserve(size_t length, Args &&...args) {
-    if (length == 0) {
-      return;
-    }
-    grow_vector(data_ar(), length, false, std::forward<Args>(args)...);
-  }
+  HSHM_INLINE_CROSS_FUN void reserve(size_t length) { grow_vector(length); }
 
   /**
-   * Reserve space in the vector to emplace elements. Changes the
-   * size of the list.
+   * Change the size of the vector. New elements are constructed from
+   * \a args and removed elements are destroyed.
    *
-   * @param length the maximum size the vector can get before a growth occurs
-   * @param args the arguments used to construct the vector elements
+   * @param length the new size of the vector
+   * @param args the arguments used to construct new elements
    * */
   template <typename... Args>
   HSHM_CROSS_FUN void resize(size_t length, Args &&...args) {
-    if (length == 0) {
-      length_ = 0;
+    if (length < length_) {
+      erase(begin() + length, end());
       return;
     }
-    grow_vector(data_ar(), length, true, std::forward<Args>(args)...);
+    delay_ar<T> *vec = grow_vector(length);
+    CtxAllocator<AllocT> alloc = GetCtxAllocator();
+    for (size_t i = length_; i < length; ++i) {
+      HSHM_MAKE_AR(vec[i], alloc, std::forward<Args>(args)...)
+    }
     length_ = length;
   }
 
@@ -506,7 +565,7 @@ class vector : public ShmContainer {
   HSHM_CROSS_FUN void emplace_back(Args &&...args) {
     delay_ar<T> *vec = data_ar();
     if (length_ == max_length_) {
-      vec = grow_vector(vec, 0, false);
+      vec = grow_vector(grown_length());
     }
     HSHM_MAKE_AR(vec[length_], GetCtxAllocator(), std::forward<Args>(args)...)
     ++length_;
@@ -520,6 +579,96 @@ class vector : public ShmContainer {
     }
   }
 
+  /** Replace the contents of the vector with \a count elements of \a src */
+  HSHM_CROSS_FUN void assign(const T *src, size_t count) {
+    clear();
+    if (count == 0) {
+      return;
+    }
+    copy_range(reserve_for(count), src, count);
+    length_ = count;
+  }
+
+  /** Append \a count elements of \a src to the back of the vector */
+  HSHM_CROSS_FUN void append_n(const T *src, size_t count) {
+    insert(end(), src, src + count);
+  }
+
+  /**
+   * Insert the elements of [first, last) before \a pos. The vector grows
+   * at most once, and arrays of trivially-copyable elements are copied
+   * with a single memcpy.
+   * */
+  template <typename Iterator>
+  HSHM_CROSS_FUN void insert(iterator_t pos, Iterator first, Iterator last) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (count == 0) {
+      return;
+    }
+    size_t off = pos.is_end() ? size() : static_cast<size_t>(pos.i_);
+    delay_ar<T> *vec = reserve_for(length_ + count);
+    shift_right(iterator_t(this, off), count);
+    copy_range(vec + off, first, count);
+    length_ += count;
+  }
+
+  /**
+   * Change the size of the vector without constructing the new elements.
+   * Only valid for trivially-copyable elements, which the caller is
+   * expected to fill (e.g., through data()).
+   * */
+  HSHM_CROSS_FUN void resize_uninitialized(size_t length) {
+    static_assert(kTriviallyCopyable,
+                  "resize_uninitialized requires a trivially-copyable T");
+    reserve_for(length);
+    length_ = length;
+  }
+
+  /**
+   * Set the factor the capacity is multiplied by when the vector grows.
+   * Must be at least 1 and finite. Factors close to 1 grow the capacity
+   * by only about 10 elements per step, which makes a sequence of n
+   * appends copy O(n^2) elements.
+   *
+   * @exception INVALID_GROWTH_FACTOR \a growth is below 1, infinite or NaN.
+   * The current factor is kept.
+   * */
+  HSHM_INLINE_CROSS_FUN void set_growth_factor(float growth) {
+    if (!(growth >= 1.0f && growth <= FLT_MAX)) {
+      HSHM_THROW_ERROR(INVALID_GROWTH_FACTOR, growth);
+      return;
+    }
+    growth_ = growth;
+  }
+
+  /** Get the factor the capacity is multiplied by when the vector grows */
+  HSHM_INLINE_CROSS_FUN float get_growth_factor() const { return growth_; }
+
+  /**
+   * The capacity a vector of capacity \a max_length grows to with the
+   * factor \a growth. Small vectors grow by at least 10 elements and the
+   * result is always larger than \a max_length. The product is computed
+   * in double so that large capacities do not round down.
+   * */
+  HSHM_INLINE_CROSS_FUN static size_t grown_capacity(size_t max_length,
+                                                     float growth) {
+    if (max_length >= SIZE_MAX - 10) {
+      return SIZE_MAX;
+    }
+    double grown = static_cast<double>(max_length) * growth;
+    if (grown >= static_cast<double>(SIZE_MAX)) {
+      return SIZE_MAX;
+    }
+    size_t new_length = static_cast<size_t>(grown);
+    if (new_length <= max_length + 10) {
+      new_length += 10;
+    }
+    if (new_length <= max_length) {
+      new_length = max_length + 1;
+    }
+    return new_length;
+  }
+
   /** Assign elements to vector using iterator up to maximum size */
   template <typename Iterator>
   HSHM_INLINE_CROSS_FUN void assign(Iterator first, Iterator last,
@@ -544,7 +693,7 @@ class vector : public ShmContainer {
     }
     delay_ar<T> *vec = data_ar();
     if (length_ == max_length_) {
-      vec = grow_vector(vec, 0, false);
+      vec = grow_vector(grown_length());
     }
     shift_right(pos);
     HSHM_MAKE_AR(vec[pos.i_], GetCtxAllocator(), std::forward<Args>(args)...)
@@ -612,78 +761,119 @@ class vector : public ShmContainer {
     return reinterpret_cast<void *>(data_ar());
   }
 
-  /** Retreives a pointer to the internal array */
+  /** Retreives a pointer to the inline or allocated array */
   HSHM_INLINE_CROSS_FUN delay_ar<T> *data_ar() {
+    if constexpr (N > 0) {
+      if (vec_ptr_.IsNull()) {
+        return this->inline_;
+      }
+    }
     return GetAllocator()->template Convert<delay_ar<T>>(vec_ptr_);
   }
 
-  /** Retreives a pointer to the array */
+  /** Retreives a pointer to the inline or allocated array */
   HSHM_INLINE_CROSS_FUN delay_ar<T> *data_ar() const {
-    return GetAllocator()->template Convert<delay_ar<T>>(vec_ptr_);
+    return const_cast<vector_templ *>(this)->data_ar();
   }
 
   /**====================================
    * Internal Operations
    * ===================================*/
  private:
+  /** The capacity after growing by the growth factor */
+  HSHM_INLINE_CROSS_FUN size_t grown_length() const {
+    return grown_capacity(max_length_, growth_);
+  }
+
   /**
-   * Grow a vector to a new size.
+   * Move the elements to an allocated array of \a max_length elements.
+   * Does nothing if the vector already holds that many.
    *
-   * @param vec the C-style array of elements to grow
-   * @param max_length the new length of the vector. If 0, the current size
-   * of the vector will be multiplied by a constant.
-   * @param args the arguments used to construct the elements of the vector
+   * @return the (possibly moved) array of elements
    * */
-  template <typename... Args>
-  HSHM_CROSS_FUN delay_ar<T> *grow_vector(delay_ar<T> *vec, size_t max_length,
-                                          bool resize, Args &&...args) {
-    // Grow vector by 25%
-    if (max_length == 0) {
-      max_length = 5 * max_length_ / 4;
-      if (max_length <= max_length_ + 10) {
-        max_length += 10;
-      }
-    }
-    if (max_length < max_length_) {
-      return nullptr;
+  HSHM_CROSS_FUN delay_ar<T> *grow_vector(size_t max_length) {
+    delay_ar<T> *vec = data_ar();
+    if (max_length <= max_length_) {
+      return vec;
     }
-
-    // Allocate new shared-memory vec
     delay_ar<T> *new_vec;
     CtxAllocator<AllocT> alloc = GetCtxAllocator();
-    if constexpr (std::is_pod<T>() && !IS_SHM_ARCHIVEABLE(T)) {
-      // Use reallocate for well-behaved objects
-      new_vec = alloc->template ReallocateObjs<delay_ar<T>>(
-          alloc.ctx_, vec_ptr_, max_length);
-    } else {
-      // Use std::move for unpredictable objects
-      OffsetPointer new_p;
-      new_vec = alloc->template AllocateObjs<delay_ar<T>>(alloc.ctx_,
-                                                          max_length, new_p);
-      for (size_t i = 0; i < length_; ++i) {
-        T &old_entry = (*this)[i];
-        HSHM_MAKE_AR(new_vec[i], alloc, std::move(old_entry))
-      }
+    if constexpr (kRelocatable) {
       if (!vec_ptr_.IsNull()) {
-        alloc->Free(alloc.ctx_, vec_ptr_);
+        // Allocated relocatable objects are moved with the allocation
+        new_vec = alloc->template ReallocateObjs<delay_ar<T>>(
+            alloc.ctx_, vec_ptr_, max_length);
+        if (new_vec == nullptr) {
+          HSHM_THROW_ERROR(OUT_OF_MEMORY, max_length * sizeof(delay_ar<T>),
+                           alloc->GetCurrentlyAllocatedSize());
+        }
+        max_length_ = max_length;
+        return new_vec;
       }
-      vec_ptr_ = new_p;
     }
+    OffsetPointer new_p;
+    new_vec = alloc->template AllocateObjs<delay_ar<T>>(alloc.ctx_,
+                                                        max_length, new_p);
     if (new_vec == nullptr) {
       HSHM_THROW_ERROR(OUT_OF_MEMORY, max_length * sizeof(delay_ar<T>),
                        alloc->GetCurrentlyAllocatedSize());
     }
-    if (resize) {
-      for (size_t i = length_; i < max_length; ++i) {
-        HSHM_MAKE_AR(new_vec[i], alloc, std::forward<Args>(args)...)
+    if constexpr (kRelocatable) {
+      if (length_ > 0) {
+        memcpy((void *)new_vec, (void *)vec, length_ * sizeof(delay_ar<T>));
+      }
+    } else {
+      // Use std::move for unpredictable objects
+      for (size_t i = 0; i < length_; ++i) {
+        HSHM_MAKE_AR(new_vec[i], alloc, std::move(vec[i].get_ref()))
+        HSHM_DESTROY_AR(vec[i])
       }
     }
-
-    // Update vector header
+    if (!vec_ptr_.IsNull()) {
+      alloc->Free(alloc.ctx_, vec_ptr_);
+    }
+    vec_ptr_ = new_p;
     max_length_ = max_length;
     return new_vec;
   }
 
+  /**
+   * Ensure the vector can hold \a length elements with at most one
+   * allocation. An empty vector is sized exactly, otherwise the capacity
+   * grows by at least the growth factor so that repeated appends stay
+   * amortized.
+   *
+   * @return the (possibly moved) array of elements
+   * */
+  HSHM_INLINE_CROSS_FUN delay_ar<T> *reserve_for(size_t length) {
+    if (length <= max_length_) {
+      return data_ar();
+    }
+    if (length_ > 0) {
+      size_t grown = grown_length();
+      if (grown > length) {
+        length = grown;
+      }
+    }
+    return grow_vector(length);
+  }
+
+  /** Copy-construct \a count elements starting at \a first into \a dst */
+  template <typename Iterator>
+  HSHM_INLINE_CROSS_FUN void copy_range(delay_ar<T> *dst, Iterator first,
+                                        size_t count) {
+    if constexpr (kTriviallyCopyable && std::is_pointer_v<Iterator> &&
+                  std::is_same_v<
+                      std::remove_cv_t<std::remove_pointer_t<Iterator>>, T>) {
+      memcpy((void *)dst, (const void *)first, count * sizeof(T));
+    } else {
+      CtxAllocator<AllocT> alloc = GetCtxAllocator();
+      for (size_t i = 0; i < count; ++i, ++first) {
+        HSHM_MAKE_AR(dst[i], alloc, *first)
+      }
+    }
+  }
+
   /**
    * Shift every element starting at "pos" to the left by count. Any element
    * who would be shifted before "pos" will be deleted.
@@ -697,12 +887,17 @@ class vector : public ShmContainer {
     for (size_t i = 0; i < count; ++i) {
       HSHM_DESTROY_AR(vec[pos.i_ + i])
     }
-    auto dst = vec + pos.i_;
-    auto src = dst + count;
-    for (auto i = pos.i_ + count; i < size(); ++i) {
-      memcpy((void *)dst, (void *)src, sizeof(delay_ar<T>));
-      dst += 1;
-      src += 1;
+    delay_ar<T> *dst = vec + pos.i_;
+    delay_ar<T> *src = dst + count;
+    size_t nmove = size() - pos.i_ - count;
+    if constexpr (kRelocatable) {
+      memmove((void *)dst, (void *)src, nmove * sizeof(delay_ar<T>));
+    } else {
+      CtxAllocator<AllocT> alloc = GetCtxAllocator();
+      for (size_t i = 0; i < nmove; ++i) {
+        HSHM_MAKE_AR(dst[i], alloc, std::move(src[i].get_ref()))
+        HSHM_DESTROY_AR(src[i])
+      }
     }
   }
 
@@ -716,13 +911,17 @@ class vector : public ShmContainer {
    * */
   HSHM_INLINE_CROSS_FUN void shift_right(const iterator_t pos,
                                          size_t count = 1) {
-    auto src = data_ar() + size() - 1;
-    auto dst = src + count;
-    auto sz = static_cast<i64>(size());
-    for (auto i = sz - 1; i >= pos.i_; --i) {
-      memcpy((void *)dst, (void *)src, sizeof(delay_ar<T>));
-      dst -= 1;
-      src -= 1;
+    delay_ar<T> *src = data_ar() + pos.i_;
+    delay_ar<T> *dst = src + count;
+    size_t nmove = size() - pos.i_;
+    if constexpr (kRelocatable) {
+      memmove((void *)dst, (void *)src, nmove * sizeof(delay_ar<T>));
+    } else {
+      CtxAllocator<AllocT> alloc = GetCtxAllocator();
+      for (size_t i = nmove; i-- > 0;) {
+        HSHM_MAKE_AR(dst[i], alloc, std::move(src[i].get_ref()))
+        HSHM_DESTROY_AR(src[i])
+      }
     }
   }
 
@@ -738,12 +937,12 @@ class vector : public ShmContainer {
 
   /** Beginning of the constant forward iterator */
   HSHM_INLINE_CROSS_FUN citerator_t cbegin() const {
-    return citerator_t(const_cast<vector *>(this), 0);
+    return citerator_t(const_cast<vector_templ *>(this), 0);
   }
 
   /** End of the forward iterator */
   HSHM_INLINE_CROSS_FUN citerator_t cend() const {
-    return citerator_t(const_cast<vector *>(this), size<i64>());
+    return citerator_t(const_cast<vector_templ *>(this), size<i64>());
   }
 
   /** Beginning of the reverse iterator */
@@ -753,32 +952,44 @@ class vector : public ShmContainer {
 
   /** End of the reverse iterator */
   HSHM_INLINE_CROSS_FUN riterator_t rend() {
-    return citerator_t(this, (i64)-1);
+    return riterator_t(this, (i64)-1);
   }
 
   /** Beginning of the constant reverse iterator */
   HSHM_INLINE_CROSS_FUN criterator_t crbegin() const {
-    return criterator_t(const_cast<vector *>(this), size<i64>() - 1);
+    return criterator_t(const_cast<vector_templ *>(this), size<i64>() - 1);
   }
 
   /** End of the constant reverse iterator */
   HSHM_INLINE_CROSS_FUN criterator_t crend() const {
-    return criterator_t(const_cast<vector *>(this), (i64)-1);
+    return criterator_t(const_cast<vector_templ *>(this), (i64)-1);
   }
 
   /** Lets Thallium know how to serialize an hipc::vector. */
   template <typename Ar>
   HSHM_CROSS_FUN void save(Ar &ar) const {
-    save_vec<Ar, hipc::vector<T, HSHM_CLASS_TEMPL_ARGS>, T>(ar, *this);
+    save_vec<Ar, vector_templ, T>(ar, *this);
   }
 
   /** Lets Thallium know how to deserialize an hipc::vector. */
   template <typename Ar>
   HSHM_CROSS_FUN void load(Ar &ar) {
-    load_vec<Ar, hipc::vector<T, HSHM_CLASS_TEMPL_ARGS>, T>(ar, *this);
+    load_vec<Ar, vector_templ, T>(ar, *this);
   }
 };
 
+/**
+ * A vector is relocatable when none of its elements are inline, or when
+ * its inline elements are relocatable, since those move with it.
+ * */
+template <typename T, size_t N, HSHM_CLASS_TEMPL>
+struct is_trivially_relocatable<vector_templ<T, N, HSHM_CLASS_TEMPL_ARGS>>
+    : std::bool_constant<N == 0 || is_trivially_relocatable_v<T>> {};
+
+/** A vector whose elements are all allocated */
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+using vector = vector_templ<T, 0, HSHM_CLASS_TEMPL_ARGS>;
+
 }  // namespace hshm::ipc
 
 namespace hshm {
@@ -0,0 +1,297 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_DATA_STRUCTURES_IPC_WS_DEQUE_H_
+#define HSHM_DATA_STRUCTURES_IPC_WS_DEQUE_H_
+
+#include <type_traits>
+
+#include "hermes_shm/data_structures/internal/shm_internal.h"
+#include "hermes_shm/memory/memory.h"
+#include "hermes_shm/types/numbers.h"
+#include "hermes_shm/types/qtok.h"
+#include "ring_queue.h"
+
+namespace hshm::ipc {
+
+/** Header of a ws_deque buffer. Its slots follow it. */
+struct ws_deque_buffer {
+  hshm::size_t capacity_; /**< Number of slots, a power of two */
+  OffsetPointer prev_;    /**< The buffer this one replaced, or null */
+};
+
+/** Forward declaration of ws_deque */
+template <typename T, HSHM_CLASS_TEMPL_WITH_DEFAULTS>
+class ws_deque;
+
+/**
+ * MACROS used to simplify the ws_deque namespace
+ * Used as inputs to the HIPC_CONTAINER_TEMPLATE
+ * */
+#define CLASS_NAME ws_deque
+#define CLASS_NEW_ARGS T
+
+/**
+ * A work-stealing deque (Chase-Lev). A single owner pushes and pops at
+ * the bottom without atomic read-modify-writes, except to race thieves
+ * for the last entry. Any number of thieves steal from the top with a
+ * CAS. The circular buffer doubles when full. Replaced buffers may still
+ * be read by thieves, so they are kept until the deque is destroyed;
+ * their total size is less than that of the live buffer.
+ *
+ * Thieves read an entry before claiming it, so T must be trivially
+ * copyable (e.g., a task id or an offset pointer).
+ * */
+template <typename T, HSHM_CLASS_TEMPL>
+class ws_deque : public ShmContainer {
+ public:
+  HIPC_CONTAINER_TEMPLATE((CLASS_NAME), (CLASS_NEW_ARGS))
+  static_assert(std::is_trivially_copyable_v<T>,
+                "ws_deque entries must be trivially copyable");
+  static_assert(alignof(T) <= alignof(ws_deque_buffer),
+                "ws_deque entries are over-aligned");
+
+ public:
+  /**====================================
+   * Variables
+   * ===================================*/
+  ring_queue_pad<true> pad0_;
+  hipc::atomic<hshm::i64> top_;
+  ring_queue_pad<true> pad1_;
+  hipc::atomic<hshm::i64> bottom_;
+  AtomicOffsetPointer buf_;
+  ring_queue_pad<true> pad2_;
+
+ public:
+  /**====================================
+   * Default Constructor
+   * ===================================*/
+
+  /** Constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit ws_deque(size_t depth = 1024) {
+    shm_init(HSHM_MEMORY_MANAGER->GetDefaultAllocator<AllocT>(), depth);
+  }
+
+  /** SHM constructor. Default. */
+  HSHM_CROSS_FUN
+  explicit ws_deque(const hipc::CtxAllocator<AllocT> &alloc,
+                    size_t depth = 1024) {
+    shm_init(alloc, depth);
+  }
+
+  /** SHM Constructor */
+  HSHM_CROSS_FUN
+  void shm_init(const hipc::CtxAllocator<AllocT> &alloc, size_t depth = 1024) {
+    init_shm_container(alloc);
+    top_ = 0;
+    bottom_ = 0;
+    buf_ = AllocateBuffer(hshm::RoundUpPow2(depth ? depth : 1),
+                          OffsetPointer::GetNull().load());
+  }
+
+  /**====================================
+   * Copy Constructors
+   * ===================================*/
+
+  /** Entries are shared with concurrent thieves; copying is disabled */
+  ws_deque(const ws_deque &other) = delete;
+
+  /** Entries are shared with concurrent thieves; copying is disabled */
+  ws_deque &operator=(const ws_deque &other) = delete;
+
+  /**====================================
+   * Destructor
+   * ===================================*/
+
+  /** SHM destructor. Frees the live buffer and all replaced buffers. */
+  HSHM_CROSS_FUN
+  void shm_destroy_main() {
+    size_t buf_off = buf_.load();
+    while (buf_off != OffsetPointer::GetNull().load()) {
+      size_t prev_off = GetBuffer(buf_off)->prev_.load();
+      OffsetPointer p(buf_off);
+      GetAllocator()->template Free<OffsetPointer>(GetMemCtx(), p);
+      buf_off = prev_off;
+    }
+    SetNull();
+  }
+
+  /** Check if the deque is null */
+  HSHM_CROSS_FUN
+  bool IsNull() const {
+    return buf_.load() == OffsetPointer::GetNull().load();
+  }
+
+  /** Sets this deque as null */
+  HSHM_CROSS_FUN
+  void SetNull() { buf_ = OffsetPointer::GetNull().load(); }
+
+  /**====================================
+   * Owner Methods
+   * ===================================*/
+
+  /** Owner pushes \a val at the bottom, growing the buffer if full */
+  HSHM_CROSS_FUN
+  qtok_t push(const T &val) {
+    hshm::i64 b = bottom_.load(std::memory_order_relaxed);
+    hshm::i64 t = top_.load(std::memory_order_acquire);
+    ws_deque_buffer *buf = GetBuffer(buf_.load(std::memory_order_relaxed));
+    if (b - t > (hshm::i64)buf->capacity_ - 1) {
+      buf = Grow(buf, t, b);
+    }
+    GetSlots(buf)[b & (buf->capacity_ - 1)] = val;
+#ifdef HSHM_IS_HOST
+    std::atomic_thread_fence(std::memory_order_release);
+#endif
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return qtok_t(b);
+  }
+
+  /** Push (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  qtok_t emplace(const T &val) { return push(val); }
+
+  /** Owner pops the most recently pushed entry. Null if empty. */
+  HSHM_CROSS_FUN
+  qtok_t pop(T &val) {
+    hshm::i64 b = bottom_.load(std::memory_order_relaxed) - 1;
+    ws_deque_buffer *buf = GetBuffer(buf_.load(std::memory_order_relaxed));
+    bottom_.store(b, std::memory_order_relaxed);
+#ifdef HSHM_IS_HOST
+    // Orders the bottom_ store before the top_ load against thieves
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+    hshm::i64 t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return qtok_t::GetNull();
+    }
+    T tmp = GetSlots(buf)[b & (buf->capacity_ - 1)];
+    if (t == b) {
+      // Last entry: race thieves for it
+      bool won = top_.compare_exchange_strong(t, t + 1);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return qtok_t::GetNull();
+      }
+    }
+    val = tmp;
+    return qtok_t(b);
+  }
+
+  /**====================================
+   * Thief Methods
+   * ===================================*/
+
+  /** Steal the oldest entry. Null if empty or another thread won it. */
+  HSHM_CROSS_FUN
+  qtok_t steal(T &val) {
+    hshm::i64 t = top_.load(std::memory_order_acquire);
+#ifdef HSHM_IS_HOST
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+    hshm::i64 b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return qtok_t::GetNull();
+    }
+    ws_deque_buffer *buf = GetBuffer(buf_.load(std::memory_order_acquire));
+    T tmp = GetSlots(buf)[t & (buf->capacity_ - 1)];
+    if (!top_.compare_exchange_strong(t, t + 1)) {
+      return qtok_t::GetNull();
+    }
+    val = tmp;
+    return qtok_t(t);
+  }
+
+  /**====================================
+   * Query Methods
+   * ===================================*/
+
+  /** Get the capacity of the live buffer */
+  HSHM_CROSS_FUN
+  size_t GetDepth() { return GetBuffer(buf_.load())->capacity_; }
+
+  /** Get size at this moment */
+  HSHM_CROSS_FUN
+  size_t GetSize() {
+    hshm::i64 b = bottom_.load();
+    hshm::i64 t = top_.load();
+    return b > t ? (size_t)(b - t) : 0;
+  }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t size() { return GetSize(); }
+
+  /** Get size (wrapper) */
+  HSHM_INLINE_CROSS_FUN
+  size_t Size() { return GetSize(); }
+
+ private:
+  /** Owner replaces \a buf with one twice as large holding [t, b) */
+  HSHM_CROSS_FUN
+  ws_deque_buffer *Grow(ws_deque_buffer *buf, hshm::i64 t, hshm::i64 b) {
+    size_t old_off = buf_.load(std::memory_order_relaxed);
+    size_t new_off = AllocateBuffer(buf->capacity_ * 2, old_off);
+    ws_deque_buffer *new_buf = GetBuffer(new_off);
+    T *old_slots = GetSlots(buf);
+    T *new_slots = GetSlots(new_buf);
+    for (hshm::i64 i = t; i < b; ++i) {
+      new_slots[i & (new_buf->capacity_ - 1)] =
+          old_slots[i & (buf->capacity_ - 1)];
+    }
+    buf_.store(new_off, std::memory_order_release);
+    return new_buf;
+  }
+
+  /** Allocate a buffer of \a capacity slots which replaces \a prev_off */
+  HSHM_CROSS_FUN
+  size_t AllocateBuffer(size_t capacity, size_t prev_off) {
+    size_t size = sizeof(ws_deque_buffer) + capacity * sizeof(T);
+    FullPtr<char, OffsetPointer> p =
+        GetAllocator()->template AllocateLocalPtr<char, OffsetPointer>(
+            GetMemCtx(), size);
+    auto *buf = reinterpret_cast<ws_deque_buffer *>(p.ptr_);
+    buf->capacity_ = capacity;
+    buf->prev_ = OffsetPointer(prev_off);
+    return p.shm_.load();
+  }
+
+  /** Convert a buffer offset to a pointer */
+  HSHM_INLINE_CROSS_FUN
+  ws_deque_buffer *GetBuffer(size_t buf_off) {
+    return GetAllocator()->template Convert<ws_deque_buffer>(
+        OffsetPointer(buf_off));
+  }
+
+  /** Get the slots following \a buf */
+  HSHM_INLINE_CROSS_FUN
+  static T *GetSlots(ws_deque_buffer *buf) {
+    return reinterpret_cast<T *>(buf + 1);
+  }
+};
+
+}  // namespace hshm::ipc
+
+namespace hshm {
+
+template <typename T, HSHM_CLASS_TEMPL_WITH_PRIV_DEFAULTS>
+using ws_deque = hipc::ws_deque<T, HSHM_CLASS_TEMPL_ARGS>;
+
+}  // namespace hshm
+
+#undef CLASS_NAME
+#undef CLASS_NEW_ARGS
+
+#endif  // HSHM_DATA_STRUCTURES_IPC_WS_DEQUE_H_
@@ -3,11 +3,13 @@
 
 #include "hermes_shm/introspect/system_info.h"
 
+#include <cerrno>
 #include <cstdlib>
 
 #include "hermes_shm/constants/macros.h"
 #if defined(HSHM_ENABLE_PROCFS_SYSINFO)
 #include <fcntl.h>
+#include <signal.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
@@ -214,6 +216,23 @@ int SystemInfo::GetPid() {
 #endif
 }
 
+bool SystemInfo::IsProcessAlive(int pid) {
+#if defined(HSHM_ENABLE_PROCFS_SYSINFO)
+  return kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+#elif defined(HSHM_ENABLE_WINDOWS_SYSINFO)
+  HANDLE proc = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+  if (proc == nullptr) {
+    return false;
+  }
+  DWORD ret = WaitForSingleObject(proc, 0);
+  CloseHandle(proc);
+  return ret == WAIT_TIMEOUT;
+#else
+  // Without a way to check, assume the process is alive
+  return true;
+#endif
+}
+
 int SystemInfo::GetUid() {
 #if defined(HSHM_ENABLE_PROCFS_SYSINFO)
   return getuid();
@@ -83,6 +83,10 @@ struct AllocatorHeader {
 class MemContext {
  public:
   ThreadId tid_ = ThreadId::GetNull();
+  /** The slot claimed in an epoch_manager (see epoch_manager::Register) */
+  hshm::size_t epoch_slot_ = (hshm::size_t)-1;
+  /** The epoch_manager which owns epoch_slot_, or null */
+  const void *epoch_mgr_ = nullptr;
 
  public:
   /** Default constructor */
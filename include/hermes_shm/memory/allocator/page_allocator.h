@@ -47,7 +47,7 @@ struct PageId {
     round_ = (1 << exp_) + sizeof(MpPage);
     if (exp_ < min_cached_size_exp_) {
       round_ = min_cached_size_;
-      exp_ = min_cached_size_exp_;
+      exp_ = 0;
     } else if (exp_ > max_cached_size_exp_) {
       round_ = size;
       exp_ = max_cached_size_exp_;
@@ -65,9 +65,12 @@ class PageAllocator {
   typedef TlsAllocatorInfo<AllocT> TLS;
   typedef hipc::lifo_list_queue<MpPage, Alloc_> LIFO_LIST;
   typedef hipc::mpsc_lifo_list_queue<MpPage, Alloc_> MPSC_LIFO_LIST;
+  typedef hipc::mpmc_lifo_list_queue<MpPage, Alloc_> MPMC_LIFO_LIST;
+  /** Free lists are popped concurrently only when MPMC */
+  typedef std::conditional_t<MPMC, MPMC_LIFO_LIST, MPSC_LIFO_LIST> FREE_LIST;
 
  public:
-  hipc::delay_ar<MPSC_LIFO_LIST> free_lists_[PageId::num_caches_];
+  hipc::delay_ar<FREE_LIST> free_lists_[PageId::num_caches_];
   hipc::delay_ar<LIFO_LIST> fallback_list_;
   TLS tls_info_;
   HeapAllocator<MPMC> heap_;
@@ -108,25 +111,23 @@ class PageAllocator {
 
   HSHM_INLINE_CROSS_FUN
   MpPage *Allocate(const PageId &page_id) {
+    // Allocate cached page (lock-free)
+    if (page_id.exp_ < PageId::num_caches_) {
+      FREE_LIST &free_list = *free_lists_[page_id.exp_];
+      MpPage *page = free_list.pop();
+      return page;
+    }
+    // Allocate a large page size
     if constexpr (!MPMC) {
-      return AllocateMpsc(page_id);
+      return AllocateLarge(page_id);
     } else {
       hipc::ScopedMutex lock(lock_, 0);
-      return AllocateMpsc(page_id);
+      return AllocateLarge(page_id);
     }
-    // No page was cached
-    return nullptr;
   }
 
   HSHM_INLINE_CROSS_FUN
-  MpPage *AllocateMpsc(const PageId &page_id) {
-    // Allocate cached page
-    if (page_id.exp_ < PageId::num_caches_) {
-      MPSC_LIFO_LIST &free_list = *free_lists_[page_id.exp_];
-      MpPage *page = free_list.pop();
-      return page;
-    }
-    // Allocate a large page size
+  MpPage *AllocateLarge(const PageId &page_id) {
     for (auto it = fallback_list_->begin(); it != fallback_list_->end(); ++it) {
       MpPage *page = *it;
       if (page->page_size_ >= page_id.round_) {
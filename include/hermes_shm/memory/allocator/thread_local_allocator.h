@@ -237,7 +237,9 @@ class _ThreadLocalAllocator : public Allocator {
         GetAllocator()->AllocateLocalPtr<char, OffsetPointer>(ctx, new_size);
     char *old = Convert<char, OffsetPointer>(p);
     MpPage *old_hdr = (MpPage *)(old - sizeof(MpPage));
-    memcpy(new_ptr.ptr_, old, old_hdr->page_size_ - sizeof(MpPage));
+    // Recycled pages may be larger than the new one, so bound the copy
+    size_t old_size = old_hdr->page_size_ - sizeof(MpPage);
+    memcpy(new_ptr.ptr_, old, old_size < new_size ? old_size : new_size);
     FreeOffsetNoNullCheck(ctx.tid_, p);
     return new_ptr.shm_;
   }
@@ -21,6 +21,7 @@
 #include "hermes_shm/types/atomic.h"
 #include "hermes_shm/types/bitfield.h"
 #include "hermes_shm/types/real_number.h"
+#include "hermes_shm/util/logging.h"
 
 namespace hshm::ipc {
 
@@ -178,6 +179,12 @@ struct OffsetPointerBase : public ShmPointer {
     return off_.load(order);
   }
 
+  /** Atomic store wrapper */
+  HSHM_INLINE_CROSS_FUN void store(
+      size_t count, std::memory_order order = std::memory_order_seq_cst) {
+    off_.store(count, order);
+  }
+
   /** Atomic exchange wrapper */
   HSHM_INLINE_CROSS_FUN void exchange(
       size_t count, std::memory_order order = std::memory_order_seq_cst) {
@@ -195,7 +202,7 @@ struct OffsetPointerBase : public ShmPointer {
   HSHM_INLINE_CROSS_FUN bool compare_exchange_strong(
       size_t &expected, size_t desired,
       std::memory_order order = std::memory_order_seq_cst) {
-    return off_.compare_exchange_weak(expected, desired, order);
+    return off_.compare_exchange_strong(expected, desired, order);
   }
 
   /** Atomic add operator */
@@ -298,6 +305,220 @@ using TypedOffsetPointer = OffsetPointer;
 template <typename T>
 using TypedAtomicOffsetPointer = AtomicOffsetPointer;
 
+/**
+ * An offset and a generation tag packed into a single 64-bit word, so
+ * that both can be swapped with one CAS. Lock-free structures bump the
+ * tag on every update of the word, which makes them ABA-safe. Offsets
+ * must fit within kOffsetBits bits; Pack fails fatally otherwise.
+ * */
+template <bool ATOMIC = false>
+struct TaggedOffsetPointerBase {
+  CLS_CONST hshm::min_u64 kOffsetBits = 44;
+  CLS_CONST hshm::min_u64 kOffsetMask =
+      (((hshm::min_u64)1) << kOffsetBits) - 1;
+  CLS_CONST hshm::min_u64 kNullOffset = kOffsetMask;
+  hipc::opt_atomic<hshm::min_u64, ATOMIC> bits_; /**< (tag | offset) */
+
+  /** Default constructor */
+  HSHM_INLINE_CROSS_FUN TaggedOffsetPointerBase() = default;
+
+  /** Packed constructor */
+  HSHM_INLINE_CROSS_FUN explicit TaggedOffsetPointerBase(hshm::min_u64 bits)
+      : bits_(bits) {}
+
+  /** Offset + tag constructor */
+  HSHM_INLINE_CROSS_FUN explicit TaggedOffsetPointerBase(
+      const OffsetPointer &off, hshm::min_u64 tag)
+      : bits_(Pack(off, tag)) {}
+
+  /** Copy constructor */
+  HSHM_INLINE_CROSS_FUN TaggedOffsetPointerBase(
+      const TaggedOffsetPointerBase &other)
+      : bits_(other.bits_.load()) {}
+
+  /** Other copy constructor */
+  HSHM_INLINE_CROSS_FUN TaggedOffsetPointerBase(
+      const TaggedOffsetPointerBase<!ATOMIC> &other)
+      : bits_(other.bits_.load()) {}
+
+  /** Copy assignment operator */
+  HSHM_INLINE_CROSS_FUN TaggedOffsetPointerBase &operator=(
+      const TaggedOffsetPointerBase &other) {
+    bits_ = other.bits_.load();
+    return *this;
+  }
+
+  /** Pack an offset and a tag into a word */
+  HSHM_INLINE_CROSS_FUN static hshm::min_u64 Pack(const OffsetPointer &off,
+                                                  hshm::min_u64 tag) {
+    hshm::min_u64 off_bits = kNullOffset;
+    if (!off.IsNull()) {
+      off_bits = (hshm::min_u64)off.load();
+      if (off_bits >= kNullOffset) {
+        HELOG(kFatal, "Offset {} does not fit in a tagged offset pointer",
+              off_bits);
+      }
+    }
+    return (tag << kOffsetBits) | off_bits;
+  }
+
+  /** Get the offset */
+  HSHM_INLINE_CROSS_FUN OffsetPointer GetOffset() const {
+    hshm::min_u64 off_bits = bits_.load() & kOffsetMask;
+    if (off_bits == kNullOffset) {
+      return OffsetPointer::GetNull();
+    }
+    return OffsetPointer((size_t)off_bits);
+  }
+
+  /** Get the generation tag */
+  HSHM_INLINE_CROSS_FUN hshm::min_u64 GetTag() const {
+    return bits_.load() >> kOffsetBits;
+  }
+
+  /** Derive the successor of this word, pointing to \a off */
+  HSHM_INLINE_CROSS_FUN TaggedOffsetPointerBase<false> Next(
+      const OffsetPointer &off) const {
+    return TaggedOffsetPointerBase<false>(off, GetTag() + 1);
+  }
+
+  /** Set to null, keeping the tag */
+  HSHM_INLINE_CROSS_FUN void SetNull() {
+    bits_ = Pack(OffsetPointer::GetNull(), GetTag());
+  }
+
+  /** Check if null */
+  HSHM_INLINE_CROSS_FUN bool IsNull() const {
+    return (bits_.load() & kOffsetMask) == kNullOffset;
+  }
+
+  /** Get the null pointer */
+  HSHM_INLINE_CROSS_FUN static TaggedOffsetPointerBase GetNull() {
+    return TaggedOffsetPointerBase(kNullOffset);
+  }
+
+  /** Atomic load wrapper */
+  HSHM_INLINE_CROSS_FUN TaggedOffsetPointerBase<false>
+  load(std::memory_order order = std::memory_order_seq_cst) const {
+    return TaggedOffsetPointerBase<false>(bits_.load(order));
+  }
+
+  /** Atomic compare exchange weak wrapper */
+  HSHM_INLINE_CROSS_FUN bool compare_exchange_weak(
+      TaggedOffsetPointerBase<false> &expected,
+      const TaggedOffsetPointerBase<false> &desired,
+      std::memory_order order = std::memory_order_seq_cst) {
+    return bits_.compare_exchange_weak(expected.bits_.ref(),
+                                       desired.bits_.load(), order);
+  }
+
+  /** Equality check */
+  HSHM_INLINE_CROSS_FUN bool operator==(
+      const TaggedOffsetPointerBase &other) const {
+    return bits_.load() == other.bits_.load();
+  }
+
+  /** Inequality check */
+  HSHM_INLINE_CROSS_FUN bool operator!=(
+      const TaggedOffsetPointerBase &other) const {
+    return bits_.load() != other.bits_.load();
+  }
+};
+
+/** Non-atomic tagged offset */
+typedef TaggedOffsetPointerBase<false> TaggedOffsetPointer;
+
+/** Atomic tagged offset */
+typedef TaggedOffsetPointerBase<true> AtomicTaggedOffsetPointer;
+
+/**
+ * An offset stored in 32 bits by dropping its low SHIFT bits. Objects
+ * must be (1 << SHIFT)-byte aligned within the allocator and lie within
+ * its first kMaxOffset bytes, so this only suits allocators over a
+ * memory backend (not MallocAllocator, whose offsets are addresses).
+ * Pack fails fatally on offsets that break either rule.
+ * Converts implicitly to and from OffsetPointer, so it can replace an
+ * OffsetPointer link field without touching the code that follows it.
+ * */
+template <u32 SHIFT = 2>
+struct CompactOffsetPointerBase {
+  static_assert(SHIFT < 32, "CompactOffsetPointer shift is too large");
+  CLS_CONST u32 kShift = SHIFT;
+  CLS_CONST u32 kNullBits = (u32)-1;
+  CLS_CONST hshm::min_u64 kMaxOffset = ((hshm::min_u64)kNullBits) << SHIFT;
+  CLS_CONST hshm::min_u64 kAlign = ((hshm::min_u64)1) << SHIFT;
+  u32 bits_; /**< The offset shifted right by SHIFT */
+
+  /** Default constructor */
+  HSHM_INLINE_CROSS_FUN CompactOffsetPointerBase() = default;
+
+  /** Offset pointer constructor */
+  HSHM_INLINE_CROSS_FUN CompactOffsetPointerBase(const OffsetPointer &off)
+      : bits_(Pack(off)) {}
+
+  /** Copy constructor */
+  HSHM_INLINE_CROSS_FUN CompactOffsetPointerBase(
+      const CompactOffsetPointerBase &other) = default;
+
+  /** Copy assignment operator */
+  HSHM_INLINE_CROSS_FUN CompactOffsetPointerBase &operator=(
+      const CompactOffsetPointerBase &other) = default;
+
+  /** Compress an offset pointer */
+  HSHM_INLINE_CROSS_FUN static u32 Pack(const OffsetPointer &off) {
+    if (off.IsNull()) {
+      return kNullBits;
+    }
+    hshm::min_u64 off_bits = (hshm::min_u64)off.load();
+    if (off_bits >= kMaxOffset || (off_bits & (kAlign - 1)) != 0) {
+      HELOG(kFatal,
+            "Offset {} does not fit in a compact offset pointer "
+            "(must be {}-byte aligned and below {})",
+            off_bits, kAlign, kMaxOffset);
+    }
+    return static_cast<u32>(off_bits >> SHIFT);
+  }
+
+  /** Get the offset pointer */
+  HSHM_INLINE_CROSS_FUN OffsetPointer ToOffsetPointer() const {
+    if (bits_ == kNullBits) {
+      return OffsetPointer::GetNull();
+    }
+    return OffsetPointer(static_cast<size_t>(bits_) << SHIFT);
+  }
+
+  /** Implicit conversion to offset pointer */
+  HSHM_INLINE_CROSS_FUN operator OffsetPointer() const {
+    return ToOffsetPointer();
+  }
+
+  /** Set to null */
+  HSHM_INLINE_CROSS_FUN void SetNull() { bits_ = kNullBits; }
+
+  /** Check if null */
+  HSHM_INLINE_CROSS_FUN bool IsNull() const { return bits_ == kNullBits; }
+
+  /** Get the null pointer */
+  HSHM_INLINE_CROSS_FUN static CompactOffsetPointerBase GetNull() {
+    return CompactOffsetPointerBase(OffsetPointer::GetNull());
+  }
+
+  /** Equality check */
+  HSHM_INLINE_CROSS_FUN bool operator==(
+      const CompactOffsetPointerBase &other) const {
+    return bits_ == other.bits_;
+  }
+
+  /** Inequality check */
+  HSHM_INLINE_CROSS_FUN bool operator!=(
+      const CompactOffsetPointerBase &other) const {
+    return bits_ != other.bits_;
+  }
+};
+
+/** Compact offset of a 4-byte aligned object, covering 16GB */
+typedef CompactOffsetPointerBase<2> CompactOffsetPointer;
+
 /**
  * A process-independent pointer, which stores both the allocator's
  * information and the offset within the allocator's region
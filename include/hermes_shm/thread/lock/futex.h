@@ -0,0 +1,150 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HSHM_THREAD_FUTEX_H_
+#define HSHM_THREAD_FUTEX_H_
+
+#include "hermes_shm/constants/macros.h"
+#include "hermes_shm/thread/thread_model_manager.h"
+#include "hermes_shm/types/atomic.h"
+#include "hermes_shm/types/numbers.h"
+#include "hermes_shm/util/timer.h"
+
+#if defined(HSHM_IS_HOST) && defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <climits>
+#include <ctime>
+#define HSHM_HAS_FUTEX
+#endif
+
+namespace hshm {
+
+/**
+ * An event count over a 32-bit futex word, meant to be placed in shared
+ * memory. Waiters spin for a while, then register themselves and park in
+ * the kernel after re-checking their condition. Notifiers only make a
+ * syscall when a waiter is registered. The futex is not process-private,
+ * so waiters and notifiers may live in different processes.
+ * */
+struct Futex {
+  ipc::atomic<hshm::u32> seq_;
+  ipc::atomic<hshm::u32> waiters_;
+
+  /** Timeout for an unbounded wait */
+  CLS_CONST size_t kForever = (size_t)-1;
+  /** Number of times the condition is polled before parking */
+  CLS_CONST int kSpinCount = 256;
+
+  /** Default constructor */
+  HSHM_INLINE_CROSS_FUN
+  Futex() : seq_(0), waiters_(0) {}
+
+  /** Copy constructor */
+  HSHM_INLINE_CROSS_FUN
+  Futex(const Futex &) : seq_(0), waiters_(0) {}
+
+  /** Explicit initialization */
+  HSHM_INLINE_CROSS_FUN
+  void Init() {
+    seq_ = 0;
+    waiters_ = 0;
+  }
+
+  /** Wake every waiter, if there are any. Call after changing state. */
+  HSHM_INLINE_CROSS_FUN
+  void Notify() {
+#ifdef HSHM_IS_HOST
+    // Orders the caller's state change before the load of waiters_
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+    if (waiters_.load() == 0) {
+      return;
+    }
+    seq_.fetch_add(1);
+    WakeAll();
+  }
+
+  /**
+   * Wait until \a ready returns true or \a timeout_us elapses.
+   * Returns false on timeout.
+   * */
+  template <typename ReadyT>
+  HSHM_CROSS_FUN bool Wait(ReadyT &&ready, size_t timeout_us = kForever) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (ready()) {
+        return true;
+      }
+    }
+    hshm::Timer timer;
+    timer.Resume();
+    while (true) {
+      waiters_.fetch_add(1);
+      hshm::u32 key = seq_.load();
+      if (ready()) {
+        waiters_.fetch_sub(1);
+        return true;
+      }
+      size_t wait_us = kForever;
+      if (timeout_us != kForever) {
+        size_t elapsed_us = (size_t)timer.GetUsecFromStart();
+        if (elapsed_us >= timeout_us) {
+          waiters_.fetch_sub(1);
+          return false;
+        }
+        wait_us = timeout_us - elapsed_us;
+      }
+      Park(key, wait_us);
+      waiters_.fetch_sub(1);
+    }
+  }
+
+ private:
+  /** Sleep while seq_ still equals \a key, for at most \a wait_us */
+  HSHM_INLINE_CROSS_FUN
+  void Park(hshm::u32 key, size_t wait_us) {
+#ifdef HSHM_HAS_FUTEX
+    struct timespec ts;
+    struct timespec *tsp = nullptr;
+    if (wait_us != kForever) {
+      ts.tv_sec = (time_t)(wait_us / 1000000);
+      ts.tv_nsec = (long)((wait_us % 1000000) * 1000);
+      tsp = &ts;
+    }
+    syscall(SYS_futex, reinterpret_cast<hshm::u32 *>(&seq_), FUTEX_WAIT, key,
+            tsp, nullptr, 0);
+#else
+    HSHM_THREAD_MODEL->Yield();
+#endif
+  }
+
+  /** Wake every thread parked on seq_ */
+  HSHM_INLINE_CROSS_FUN
+  void WakeAll() {
+#ifdef HSHM_HAS_FUTEX
+    syscall(SYS_futex, reinterpret_cast<hshm::u32 *>(&seq_), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+#endif
+  }
+};
+
+}  // namespace hshm
+
+namespace hshm::ipc {
+
+using hshm::Futex;
+
+}  // namespace hshm::ipc
+
+#endif  // HSHM_THREAD_FUTEX_H_
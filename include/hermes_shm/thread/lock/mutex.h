@@ -61,6 +61,7 @@ struct Mutex {
       return false;
     }
     Lock(owner);
+    try_lock_.fetch_sub(1);
     return true;
   }
 
@@ -51,6 +51,7 @@ struct SpinLock {
       return false;
     }
     Lock(owner);
+    try_lock_.fetch_sub(1);
     return true;
   }
 
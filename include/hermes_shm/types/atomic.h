@@ -101,10 +101,12 @@ struct nonatomic {
 
   /** Atomic exchange wrapper */
   template <typename U>
-  HSHM_INLINE_CROSS_FUN void exchange(
-      U count, std::memory_order order = std::memory_order_seq_cst) {
+  HSHM_INLINE_CROSS_FUN T
+  exchange(U count, std::memory_order order = std::memory_order_seq_cst) {
     (void)order;
+    T old = x;
     x = count;
+    return old;
   }
 
   /** Atomic compare exchange weak wrapper */
@@ -522,9 +524,9 @@ struct std_atomic {
 
   /** Atomic exchange wrapper */
   template <typename U>
-  HSHM_INLINE void exchange(
-      U count, std::memory_order order = std::memory_order_seq_cst) {
-    x.exchange(count, order);
+  HSHM_INLINE T
+  exchange(U count, std::memory_order order = std::memory_order_seq_cst) {
+    return x.exchange(count, order);
   }
 
   /** Atomic compare exchange weak wrapper */
@@ -105,6 +105,16 @@ typedef u64 min_u64;
 /** A custom definition of size_t compatible with cuda */
 typedef std::conditional<sizeof(size_t) == 8, min_u64, min_u32>::type size_t;
 
+/** Round \a n up to the nearest power of two */
+template <typename T>
+HSHM_INLINE_CROSS_FUN T RoundUpPow2(T n) {
+  T pow2 = 1;
+  while (pow2 < n) {
+    pow2 <<= 1;
+  }
+  return pow2;
+}
+
 template <typename T>
 class Unit {
  public:
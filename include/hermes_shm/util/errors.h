@@ -38,6 +38,10 @@ const Error IPC_ARGS_NOT_SHM_COMPATIBLE("Args are not compatible with SHM");
 
 const Error UNORDERED_MAP_CANT_FIND("Could not find key in unordered_map");
 const Error KEY_SET_OUT_OF_BOUNDS("Too many keys in the key set");
+const Error INVALID_GROWTH_FACTOR(
+    "Vector growth factor {} is not a finite number of at least 1");
+const Error SLIST_SPLICE_POOLED(
+    "Cannot splice entries between slists that use node pools");
 
 const Error ARGPACK_INDEX_OUT_OF_BOUNDS("Argpack index out of bounds");
 }  // namespace hshm
@@ -80,6 +80,10 @@ TEST_CASE("ThreadLocalAllocator") {
   Workloads<hipc::ThreadLocalAllocator>::ReallocationTest(alloc);
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  Workloads<hipc::ThreadLocalAllocator>::RecycledReallocationTest(alloc);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+
   Posttest();
 }
 
@@ -147,6 +147,30 @@ class Workloads {
     }
   }
 
+  static void RecycledReallocationTest(AllocT *alloc) {
+    // Leave a large page on a free list for small requests to find
+    Pointer big = alloc->Allocate(HSHM_DEFAULT_MEM_CTX,
+                                  hshm::Unit<size_t>::Kilobytes(4));
+    alloc->Free(HSHM_DEFAULT_MEM_CTX, big);
+
+    // Grow a small buffer, then shrink a large one
+    std::vector<std::pair<size_t, size_t>> sizes = {
+        {16, 48}, {hshm::Unit<size_t>::Kilobytes(4), 256}};
+    for (auto &[old_size, new_size] : sizes) {
+      Pointer p;
+      char *ptr =
+          alloc->template AllocatePtr<char>(HSHM_DEFAULT_MEM_CTX, old_size, p);
+      memset(ptr, 10, old_size);
+      char *new_ptr = alloc->template ReallocatePtr<char>(HSHM_DEFAULT_MEM_CTX,
+                                                          p, new_size);
+      size_t kept = old_size < new_size ? old_size : new_size;
+      for (size_t i = 0; i < kept; ++i) {
+        REQUIRE(new_ptr[i] == 10);
+      }
+      alloc->Free(HSHM_DEFAULT_MEM_CTX, p);
+    }
+  }
+
   static void AlignedAllocationTest(AllocT *alloc) {
     std::vector<std::pair<size_t, size_t>> sizes = {
         {hshm::Unit<size_t>::Kilobytes(4), hshm::Unit<size_t>::Kilobytes(4)},
@@ -0,0 +1,239 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+* Distributed under BSD 3-Clause license.                                   *
+* Copyright by The HDF Group.                                               *
+* Copyright by the Illinois Institute of Technology.                        *
+* All rights reserved.                                                      *
+*                                                                           *
+* This file is part of Hermes. The full Hermes copyright notice, including  *
+* terms governing use, modification, and redistribution, is contained in    *
+* the COPYING file, which can be found at the top directory. If you do not  *
+* have access to the file, you may request a copy from help@hdfgroup.org.   *
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "test_init.h"
+#include "hermes_shm/data_structures/ipc/btree_map.h"
+#include "hermes_shm/data_structures/ipc/string.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+using hshm::ipc::btree_map;
+using hshm::ipc::string;
+
+#define GET_INT_FROM_KEY(VAR) CREATE_GET_INT_FROM_VAR(Key, key_ret, VAR)
+#define GET_INT_FROM_VAL(VAR) CREATE_GET_INT_FROM_VAR(Val, val_ret, VAR)
+
+#define CREATE_KV_PAIR(KEY_NAME, KEY, VAL_NAME, VAL)\
+  CREATE_SET_VAR_TO_INT_OR_STRING(Key, KEY_NAME, KEY); \
+  CREATE_SET_VAR_TO_INT_OR_STRING(Val, VAL_NAME, VAL);
+
+/** Check that the map iterates \a count entries in increasing key order */
+template<typename MapT>
+void VerifyBtreeOrder(MapT &map, size_t count) {
+  size_t visited = 0;
+  auto prev = map.end();
+  for (auto iter = map.begin(); iter != map.end(); ++iter) {
+    if (!prev.is_end()) {
+      REQUIRE(prev.GetKey() < iter.GetKey());
+      REQUIRE(map.upper_bound(prev.GetKey()) == iter);
+    }
+    REQUIRE(map.lower_bound(iter.GetKey()) == iter);
+    prev = iter;
+    ++visited;
+  }
+  REQUIRE(visited == count);
+  REQUIRE(map.size() == count);
+}
+
+template<typename Key, typename Val>
+void BtreeMapOpTest() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  btree_map<Key, Val> map(alloc);
+  const int count = 1000;
+
+  // Insert entries out of order, so leaves and inner nodes split
+  PAGE_DIVIDE("Insert entries") {
+    for (int i = 0; i < count; ++i) {
+      int k = (i * 7) % count;
+      CREATE_KV_PAIR(key, k, val, k);
+      REQUIRE(map.emplace(key, val));
+    }
+    REQUIRE(map.size() == count);
+    REQUIRE(map.height() > 1);
+    VerifyBtreeOrder(map, count);
+  }
+
+  PAGE_DIVIDE("Find entries") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      auto iter = map.find(key);
+      REQUIRE(!iter.is_end());
+      REQUIRE((*iter).GetVal() == val);
+      REQUIRE(map[key] == val);
+    }
+    CREATE_KV_PAIR(key, count, val, count);
+    REQUIRE(map.find(key).is_end());
+    REQUIRE(!map.contains(key));
+  }
+
+  PAGE_DIVIDE("Replace entries") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i + 1);
+      REQUIRE(!map.try_emplace(key, val));
+      REQUIRE(map.emplace(key, val));
+      REQUIRE(map[key] == val);
+    }
+    REQUIRE(map.size() == count);
+  }
+
+  PAGE_DIVIDE("Range scan") {
+    CREATE_SET_VAR_TO_INT_OR_STRING(Key, lo, 100);
+    CREATE_SET_VAR_TO_INT_OR_STRING(Key, hi_key, 200);
+    size_t visited = 0;
+    for (auto entry : map.range(lo, hi_key)) {
+      REQUIRE(!(entry.GetKey() < lo));
+      REQUIRE(entry.GetKey() < hi_key);
+      ++visited;
+    }
+    size_t expected = 0;
+    for (auto iter = map.begin(); iter != map.end(); ++iter) {
+      expected += !(iter.GetKey() < lo) && iter.GetKey() < hi_key;
+    }
+    REQUIRE(visited == expected);
+    REQUIRE(visited > 0);
+    REQUIRE(map.range(hi_key, lo).begin() == map.range(hi_key, lo).end());
+  }
+
+  PAGE_DIVIDE("Copy the map") {
+    btree_map<Key, Val> cpy(alloc, map);
+    VerifyBtreeOrder(cpy, count);
+    for (auto iter = map.begin(); iter != map.end(); ++iter) {
+      REQUIRE(cpy[iter.GetKey()] == iter.GetVal());
+    }
+  }
+
+  // Erasing shrinks nodes until they borrow from or merge with siblings
+  PAGE_DIVIDE("Erase entries") {
+    for (int i = 0; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i);
+      map.erase(key);
+      REQUIRE(!map.contains(key));
+    }
+    VerifyBtreeOrder(map, count / 2);
+    for (int i = 1; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i + 1);
+      REQUIRE(map[key] == val);
+      map.erase(key);
+    }
+    REQUIRE(map.size() == 0);
+    REQUIRE(map.height() == 0);
+    REQUIRE(map.begin() == map.end());
+  }
+
+  PAGE_DIVIDE("Bulk load") {
+    // Order the ids the way their keys sort
+    std::vector<int> ids(count);
+    for (int i = 0; i < count; ++i) {
+      ids[i] = i;
+    }
+    std::sort(ids.begin(), ids.end(), [](int a, int b) {
+      CREATE_SET_VAR_TO_INT_OR_STRING(Key, key_a, a);
+      CREATE_SET_VAR_TO_INT_OR_STRING(Key, key_b, b);
+      return key_a < key_b;
+    });
+    std::vector<std::pair<Key, Val>> entries;
+    entries.reserve(count);
+    for (int i : ids) {
+      CREATE_KV_PAIR(key, i, val, i);
+      entries.emplace_back(key, val);
+    }
+    map.bulk_load(entries.begin(), entries.end());
+    VerifyBtreeOrder(map, count);
+    size_t i = 0;
+    for (auto iter = map.begin(); iter != map.end(); ++iter, ++i) {
+      REQUIRE(iter.GetKey() == entries[i].first);
+      REQUIRE(iter.GetVal() == entries[i].second);
+    }
+    for (int j = 0; j < count; j += 3) {
+      CREATE_KV_PAIR(key, j, val, j);
+      map.erase(key);
+    }
+    VerifyBtreeOrder(map, count - (count + 2) / 3);
+
+    // Unsorted input is emplaced one entry at a time
+    map.bulk_load(entries.rbegin(), entries.rend());
+    VerifyBtreeOrder(map, count);
+  }
+
+  PAGE_DIVIDE("Clear the map") {
+    map.clear();
+    REQUIRE(map.size() == 0);
+    REQUIRE(map.begin() == map.end());
+  }
+}
+
+TEST_CASE("BtreeMapOfIntInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BtreeMapOpTest<int, int>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("BtreeMapOfIntString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BtreeMapOpTest<int, string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("BtreeMapOfStringString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BtreeMapOpTest<string, string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("BtreeMapRandomOps") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    // Mixed inserts and erases against std::map
+    btree_map<int, int> map(alloc);
+    std::map<int, int> expected;
+    hshm::u64 x = 1;
+    for (int i = 0; i < 50000; ++i) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      int key = (int)(x % 4096);
+      if (x % 3 == 0) {
+        map.erase(key);
+        expected.erase(key);
+      } else {
+        map.emplace(key, i);
+        expected[key] = i;
+      }
+    }
+    REQUIRE(map.size() == expected.size());
+    auto it = expected.begin();
+    for (auto entry : map) {
+      REQUIRE(it != expected.end());
+      REQUIRE(entry.GetKey() == it->first);
+      REQUIRE(entry.GetVal() == it->second);
+      ++it;
+    }
+    REQUIRE(it == expected.end());
+    for (int key = -1; key <= 4096; ++key) {
+      auto iter = map.lower_bound(key);
+      auto exp = expected.lower_bound(key);
+      REQUIRE(iter.is_end() == (exp == expected.end()));
+      if (!iter.is_end()) {
+        REQUIRE(iter.GetKey() == exp->first);
+      }
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
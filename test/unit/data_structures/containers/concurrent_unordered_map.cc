@@ -0,0 +1,198 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+* Distributed under BSD 3-Clause license.                                   *
+* Copyright by The HDF Group.                                               *
+* Copyright by the Illinois Institute of Technology.                        *
+* All rights reserved.                                                      *
+*                                                                           *
+* This file is part of Hermes. The full Hermes copyright notice, including  *
+* terms governing use, modification, and redistribution, is contained in    *
+* the COPYING file, which can be found at the top directory. If you do not  *
+* have access to the file, you may request a copy from help@hdfgroup.org.   *
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <omp.h>
+
+#include "basic_test.h"
+#include "test_init.h"
+#include "hermes_shm/data_structures/ipc/concurrent_unordered_map.h"
+#include "hermes_shm/data_structures/ipc/string.h"
+
+using hshm::ipc::concurrent_unordered_map;
+using hshm::ipc::string;
+
+#define CREATE_KV_PAIR(KEY_NAME, KEY, VAL_NAME, VAL)\
+  CREATE_SET_VAR_TO_INT_OR_STRING(Key, KEY_NAME, KEY); \
+  CREATE_SET_VAR_TO_INT_OR_STRING(Val, VAL_NAME, VAL);
+
+template<typename Key, typename Val>
+void ConcurrentUnorderedMapOpTest() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  concurrent_unordered_map<Key, Val> map(alloc, 64, 4);
+  const int count = 1000;
+  REQUIRE(map.get_num_buckets() == 64);
+  REQUIRE(map.get_num_stripes() == 4);
+
+  PAGE_DIVIDE("Insert entries") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.emplace(key, val));
+    }
+    REQUIRE(map.size() == count);
+  }
+
+  PAGE_DIVIDE("Find entries") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      Val found;
+      REQUIRE(map.find(key, found));
+      REQUIRE(found == val);
+      REQUIRE(map.contains(key));
+    }
+    CREATE_KV_PAIR(key, count, val, count);
+    Val found;
+    REQUIRE(!map.find(key, found));
+    REQUIRE(!map.contains(key));
+  }
+
+  PAGE_DIVIDE("Replace and update entries") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i + 100);
+      REQUIRE(!map.try_emplace(key, val));
+      REQUIRE(!map.emplace(key, val));
+    }
+    CREATE_KV_PAIR(key, 4, val, 50);
+    REQUIRE(map.update(key, [&val](Val &cur) { cur = val; }));
+    Val found;
+    REQUIRE(map.find(key, found));
+    REQUIRE(found == val);
+    REQUIRE(map.size() == count);
+  }
+
+  PAGE_DIVIDE("Erase half of the entries") {
+    for (int i = 0; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.erase(key));
+      REQUIRE(!map.erase(key));
+    }
+    REQUIRE(map.size() == count / 2);
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.contains(key) == (i % 2 == 1));
+    }
+    size_t visited = 0;
+    map.for_each([&visited](const Key &, Val &) { ++visited; });
+    REQUIRE(visited == count / 2);
+  }
+
+  PAGE_DIVIDE("Erased nodes are reused") {
+    size_t used = alloc->GetCurrentlyAllocatedSize();
+    for (int i = 0; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.emplace(key, val));
+    }
+    if constexpr (std::is_same_v<Key, int> && std::is_same_v<Val, int>) {
+      REQUIRE(alloc->GetCurrentlyAllocatedSize() == used);
+    }
+    REQUIRE(map.size() == count);
+  }
+
+  PAGE_DIVIDE("Clear the map") {
+    map.clear();
+    REQUIRE(map.size() == 0);
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(!map.contains(key));
+    }
+    CREATE_KV_PAIR(key, 1, val, 1);
+    REQUIRE(map.emplace(key, val));
+    REQUIRE(map.size() == 1);
+  }
+}
+
+TEST_CASE("ConcurrentUnorderedMapOfIntInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ConcurrentUnorderedMapOpTest<int, int>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("ConcurrentUnorderedMapOfStringString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ConcurrentUnorderedMapOpTest<string, string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/** A value whose halves must always be read together */
+struct TornCheck {
+  size_t a_, b_;
+};
+
+/**
+ * Readers look up keys while a writer erases, re-inserts, and updates
+ * them. A reader must never see a half-written value.
+ * */
+void ConcurrentUnorderedMapReadWriteTest(int nreaders, size_t count,
+                                         size_t nrounds) {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  auto *map = alloc->NewObjLocal<concurrent_unordered_map<size_t, TornCheck>>(
+      HSHM_DEFAULT_MEM_CTX, 64).ptr_;
+  for (size_t i = 0; i < count; ++i) {
+    map->emplace(i, TornCheck{i, i});
+  }
+  std::atomic<bool> done(false);
+  std::atomic<size_t> torn(0), missing(0);
+
+  omp_set_dynamic(0);
+#pragma omp parallel shared(map, done, torn, missing) \
+    num_threads(nreaders + 1)
+  {
+    int rank = omp_get_thread_num();
+    if (rank == 0) {
+      for (size_t round = 1; round <= nrounds; ++round) {
+        for (size_t i = 0; i < count; ++i) {
+          if (i % 4 == 0) {
+            map->erase(i);
+            map->emplace(i, TornCheck{round, round});
+          } else {
+            map->update(i, [round](TornCheck &val) {
+              val.a_ = round;
+              val.b_ = round;
+            });
+          }
+        }
+        HSHM_THREAD_MODEL->Yield();
+      }
+      done = true;
+    } else {
+      do {
+        for (size_t i = 0; i < count; ++i) {
+          TornCheck val;
+          if (!map->find(i, val)) {
+            // Keys divisible by 4 are briefly absent while re-inserted
+            if (i % 4 != 0) {
+              missing.fetch_add(1);
+            }
+            continue;
+          }
+          if (val.a_ != val.b_) {
+            torn.fetch_add(1);
+          }
+        }
+        HSHM_THREAD_MODEL->Yield();
+      } while (!done.load());
+    }
+  }
+
+  REQUIRE(torn.load() == 0);
+  REQUIRE(missing.load() == 0);
+  REQUIRE(map->size() == count);
+  alloc->DelObj(HSHM_DEFAULT_MEM_CTX, map);
+}
+
+TEST_CASE("ConcurrentUnorderedMapMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ConcurrentUnorderedMapReadWriteTest(4, 512, 64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
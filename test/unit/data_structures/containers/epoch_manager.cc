@@ -0,0 +1,166 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "hermes_shm/data_structures/ipc/epoch_manager.h"
+
+#include "basic_test.h"
+#include "test_init.h"
+
+using hshm::ipc::epoch_guard;
+using hshm::ipc::epoch_manager;
+
+/** Counts the retired pointers it is called on */
+struct count_destroy {
+  static inline size_t count_ = 0;
+
+  void operator()(HSHM_DEFAULT_ALLOC_T *, const hipc::OffsetPointer &) const {
+    ++count_;
+  }
+};
+
+TEST_CASE("EpochManagerRetire") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  {
+    epoch_manager<> mgr(alloc, 8, 1);
+    hipc::MemContext writer, reader;
+    REQUIRE(mgr.Register(writer));
+    REQUIRE(mgr.Register(reader));
+    REQUIRE(writer.epoch_slot_ != reader.epoch_slot_);
+
+    // A reader within a critical section blocks reclamation
+    mgr.Enter(reader);
+    hipc::FullPtr<int> p =
+        alloc->template AllocateLocalPtr<int>(writer, sizeof(int));
+    mgr.Retire(writer, p);
+    for (int i = 0; i < 4; ++i) {
+      mgr.TryAdvance();
+      mgr.Reclaim(writer);
+    }
+    REQUIRE(mgr.GetPendingCount(writer) == 1);
+
+    // Once the reader exits, the retired pointer is freed
+    mgr.Exit(reader);
+    for (int i = 0; i < 4; ++i) {
+      mgr.TryAdvance();
+      mgr.Reclaim(writer);
+    }
+    REQUIRE(mgr.GetPendingCount(writer) == 0);
+
+    // Nested critical sections
+    {
+      epoch_guard<epoch_manager<>> guard(mgr, reader);
+      epoch_guard<epoch_manager<>> nested(mgr, reader);
+    }
+    REQUIRE(mgr.TryAdvance());
+
+    // Pending entries are freed on unregister or destruction
+    p = alloc->template AllocateLocalPtr<int>(writer, sizeof(int));
+    mgr.Retire(writer, p);
+    mgr.Unregister(writer);
+    mgr.Unregister(reader);
+    REQUIRE(!mgr.IsRegistered(writer));
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("EpochManagerRegisterPerManager") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  {
+    epoch_manager<> first(alloc, 2, 1), second(alloc, 1, 1);
+    hipc::MemContext ctx;
+    REQUIRE(first.Register(ctx));
+    REQUIRE(first.IsRegistered(ctx));
+
+    // A slot of one manager is not a slot of another
+    REQUIRE(!second.IsRegistered(ctx));
+    REQUIRE(!second.Register(ctx));
+    REQUIRE(second.GetPendingCount(ctx) == 0);
+    second.Unregister(ctx);
+    REQUIRE(first.IsRegistered(ctx));
+
+    // Once released, the context may register elsewhere
+    first.Unregister(ctx);
+    REQUIRE(second.Register(ctx));
+    REQUIRE(!first.IsRegistered(ctx));
+    second.Unregister(ctx);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("EpochManagerReapDeadSlots") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  {
+    epoch_manager<> mgr(alloc, 2, 1);
+    hipc::MemContext live, dead;
+    REQUIRE(mgr.Register(live));
+    REQUIRE(mgr.Register(dead));
+
+    // Emulate a process which died within a critical section
+    mgr.Enter(dead);
+    hipc::FullPtr<int> p =
+        alloc->template AllocateLocalPtr<int>(dead, sizeof(int));
+    mgr.Retire(dead, p);
+    (*mgr.slots_)[dead.epoch_slot_].owner_ = (hshm::min_u64)INT32_MAX;
+    mgr.TryAdvance();
+    REQUIRE(!mgr.TryAdvance());
+
+    // Its slot is recovered once the table is full
+    hipc::MemContext next;
+    REQUIRE(mgr.Register(next));
+    REQUIRE(next.epoch_slot_ == dead.epoch_slot_);
+    for (int i = 0; i < 4; ++i) {
+      mgr.TryAdvance();
+      mgr.Reclaim(live);
+    }
+    REQUIRE(mgr.orphan_count_.load() == 0);
+    mgr.Unregister(next);
+    mgr.Unregister(live);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("EpochManagerDestroyHook") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  {
+    epoch_manager<count_destroy> mgr(alloc, 2, 1);
+    hipc::MemContext writer;
+    REQUIRE(mgr.Register(writer));
+    count_destroy::count_ = 0;
+
+    // The hook runs on each retired pointer right before it is freed
+    hipc::FullPtr<int> p =
+        alloc->template AllocateLocalPtr<int>(writer, sizeof(int));
+    mgr.Retire(writer, p);
+    for (int i = 0; i < 4; ++i) {
+      mgr.TryAdvance();
+      mgr.Reclaim(writer);
+    }
+    REQUIRE(count_destroy::count_ == 1);
+
+    // Including pending pointers freed with the manager
+    p = alloc->template AllocateLocalPtr<int>(writer, sizeof(int));
+    mgr.Retire(writer, p);
+    mgr.FreeRetired();
+    REQUIRE(count_destroy::count_ == 2);
+
+    // And pointers still pending when their thread unregisters
+    p = alloc->template AllocateLocalPtr<int>(writer, sizeof(int));
+    mgr.Retire(writer, p);
+    mgr.Unregister(writer);
+  }
+  REQUIRE(count_destroy::count_ == 3);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
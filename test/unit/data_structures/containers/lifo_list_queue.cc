@@ -17,6 +17,11 @@
 
 using hshm::ipc::lifo_list_queue;
 
+/** A queue entry linked by a 4-byte offset */
+struct CompactPage : public hipc::compact_list_queue_entry {
+  hshm::u32 page_size_;
+};
+
 template <typename T>
 void lifo_list_queueTest() {
   auto *alloc = HSHM_DEFAULT_ALLOC;
@@ -37,3 +42,11 @@ TEST_CASE("lifo_list_queueOfMpPage") {
   lifo_list_queueTest<MpPage>();
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
+
+TEST_CASE("lifo_list_queueOfCompactPage") {
+  static_assert(sizeof(CompactPage) == 8);
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  lifo_list_queueTest<CompactPage>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
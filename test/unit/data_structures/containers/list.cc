@@ -36,11 +36,13 @@ void ListTestRunner(ListTestSuite<T, ListT> &test) {
  * HIPC list tests
  * */
 
-template <typename T>
-void HipcListTest() {
+template <typename T, hipc::ShmFlagField FLAGS = 0>
+void HipcListTest(hshm::u32 node_chunk = 0) {
+  using ListT = hipc::list<T, HSHM_DEFAULT_ALLOC_T, FLAGS>;
   auto *alloc = HSHM_DEFAULT_ALLOC;
-  hipc::list<T> lp(alloc);
-  ListTestSuite<T, hipc::list<T>> test(lp, alloc);
+  ListT lp(alloc);
+  lp.set_node_chunk(node_chunk);
+  ListTestSuite<T, ListT> test(lp, alloc);
   ListTestRunner(test);
 }
 
@@ -65,6 +67,124 @@ TEST_CASE("hipc::ListOfStdString") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+TEST_CASE("hipc::ListEmplaceFront") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("Prior links are kept when pushing to the front") {
+    hipc::list<int> lp(alloc);
+    for (int i = 0; i < 50; ++i) {
+      lp.emplace_front(i);
+    }
+    int i = 0;
+    for (auto iter = lp.last(); !iter.is_end(); --iter) {
+      REQUIRE(*iter == i);
+      if (iter.is_begin()) {
+        break;
+      }
+      ++i;
+    }
+    REQUIRE(i == 49);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("hipc::ListPooledOfInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  HipcListTest<int>(32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("hipc::ListPooledOfString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  HipcListTest<hipc::string>(32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("hipc::ListNodePool") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("Erased entries are recycled") {
+    hipc::list<int> lp(alloc);
+    REQUIRE(lp.set_node_chunk(32));
+    REQUIRE(lp.get_node_chunk() == 32);
+    for (int i = 0; i < 100; ++i) {
+      lp.emplace_back(i);
+    }
+    size_t pooled = alloc->GetCurrentlyAllocatedSize();
+    lp.erase(lp.begin(), lp.end());
+    REQUIRE(lp.size() == 0);
+    REQUIRE(alloc->GetCurrentlyAllocatedSize() == pooled);
+    for (int i = 0; i < 100; ++i) {
+      lp.emplace_back(i);
+    }
+    REQUIRE(alloc->GetCurrentlyAllocatedSize() == pooled);
+    int i = 0;
+    for (int &val : lp) {
+      REQUIRE(val == i++);
+    }
+    REQUIRE(i == 100);
+
+    // The pool can only be resized while the list is empty
+    REQUIRE(!lp.set_node_chunk(0));
+    REQUIRE(lp.get_node_chunk() == 32);
+
+    // Copies keep the chunk size
+    hipc::list<int> copy(lp);
+    REQUIRE(copy.get_node_chunk() == 32);
+    REQUIRE(copy.size() == 100);
+    copy = hipc::list<int>(alloc);
+    copy = lp;
+    REQUIRE(copy.get_node_chunk() == 32);
+    copy.clear();
+    lp.clear();
+    REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("hipc::ListCompactOfInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  HipcListTest<int, hipc::ShmFlag::kCompactLinks>();
+  HipcListTest<int, hipc::ShmFlag::kCompactLinks>(32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("hipc::ListCompactOfString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  HipcListTest<hipc::string, hipc::ShmFlag::kCompactLinks>();
+  HipcListTest<hipc::string, hipc::ShmFlag::kCompactLinks>(32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("hipc::ListCompactLinks") {
+  using CompactListT =
+      hipc::list<int, HSHM_DEFAULT_ALLOC_T, hipc::ShmFlag::kCompactLinks>;
+  static_assert(sizeof(hipc::list_entry<int, HSHM_DEFAULT_ALLOC_T,
+                                        hipc::ShmFlag::kCompactLinks>) == 12);
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("Links are followed in both directions") {
+    CompactListT lp(alloc);
+    for (int i = 0; i < 50; ++i) {
+      lp.emplace_front(i);
+    }
+    int i = 0;
+    for (auto iter = lp.last(); !iter.is_end(); --iter) {
+      REQUIRE(*iter == i);
+      if (iter.is_begin()) {
+        break;
+      }
+      ++i;
+    }
+    REQUIRE(i == 49);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 /**
  * HSHM list tests
  * */
@@ -15,6 +15,12 @@
 #include "basic_test.h"
 #include "test_init.h"
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <queue>
+
 /**
  * TEST TICKET QUEUE
  * */
@@ -34,6 +40,33 @@ TEST_CASE("TestTicketQueueIntMultiThreaded") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+TEST_CASE("TestTicketQueueFull") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hipc::ticket_queue<int> queue(alloc, 16);
+    for (int i = 0; i < 16; ++i) {
+      REQUIRE(!queue.emplace(i).IsNull());
+    }
+    REQUIRE(queue.emplace(16).IsNull());
+    REQUIRE(queue.GetSize() == 16);
+    int tkt;
+    for (int i = 0; i < 16; ++i) {
+      REQUIRE(!queue.pop(tkt).IsNull());
+      REQUIRE(tkt == i);
+    }
+    REQUIRE(queue.pop(tkt).IsNull());
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestLockedTicketQueueIntMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceAndConsume<hipc::locked_ticket_queue<int>, int>(8, 8, 8192, 64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 TEST_CASE("TestSplitTicketQueueInt") {
   auto *alloc = HSHM_DEFAULT_ALLOC;
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
@@ -49,6 +82,52 @@ TEST_CASE("TestSplitTicketQueueIntMultiThreaded") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+template <typename LaneT>
+void SplitTicketQueueLanes() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  // The probe sequence visits every lane exactly once
+  hipc::atomic<hshm::min_i32> rr(0);
+  for (size_t nlanes = 1; nlanes <= 5; ++nlanes) {
+    LaneT lanes(rr, nlanes);
+    REQUIRE(lanes.GetProbeCount() == nlanes);
+    std::vector<int> seen(nlanes, 0);
+    for (size_t i = 0; i < lanes.GetProbeCount(); ++i) {
+      seen[lanes.Probe(i)] += 1;
+    }
+    for (size_t lane = 0; lane < nlanes; ++lane) {
+      REQUIRE(seen[lane] == 1);
+    }
+  }
+  // Every split must be reachable once the home split is full or empty
+  hipc::split_ticket_queue<int, LaneT> queue(alloc, 8, 4);
+  for (int i = 0; i < 32; ++i) {
+    REQUIRE(!queue.emplace(i).IsNull());
+  }
+  REQUIRE(queue.emplace(32).IsNull());
+  std::vector<int> tkts;
+  int tkt;
+  for (int i = 0; i < 32; ++i) {
+    REQUIRE(!queue.pop(tkt).IsNull());
+    tkts.emplace_back(tkt);
+  }
+  REQUIRE(queue.pop(tkt).IsNull());
+  std::sort(tkts.begin(), tkts.end());
+  for (int i = 0; i < 32; ++i) {
+    REQUIRE(tkts[i] == i);
+  }
+  ProduceAndConsume<hipc::split_ticket_queue<int, LaneT>, int>(4, 4, 1024,
+                                                               64);
+}
+
+TEST_CASE("TestSplitTicketQueueLanes") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SplitTicketQueueLanes<hipc::split_rr_lanes>();
+  SplitTicketQueueLanes<hipc::split_cpu_lanes>();
+  SplitTicketQueueLanes<hipc::split_tid_lanes>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 /**
  * TEST DYNAMIC QUEUE
  * */
@@ -95,6 +174,37 @@ TEST_CASE("TestSpscListQueueInt") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+TEST_CASE("TestSpscListQueueCompact") {
+  struct CompactIntEntry : public hipc::compact_list_queue_entry {
+    int value;
+  };
+  static_assert(sizeof(CompactIntEntry) == 8);
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("Entries are popped in FIFO order") {
+    hipc::spsc_fifo_list_queue<CompactIntEntry> queue(alloc);
+    std::vector<CompactIntEntry *> entries;
+    for (int i = 0; i < 64; ++i) {
+      auto entry =
+          alloc->template NewObjLocal<CompactIntEntry>(HSHM_DEFAULT_MEM_CTX);
+      entry.ptr_->value = i;
+      entries.emplace_back(entry.ptr_);
+      REQUIRE(!queue.emplace(entry.ptr_).IsNull());
+    }
+    REQUIRE(queue.size() == 64);
+    for (int i = 0; i < 64; ++i) {
+      CompactIntEntry *entry;
+      REQUIRE(!queue.pop(entry).IsNull());
+      REQUIRE(entry->value == i);
+    }
+    REQUIRE(queue.size() == 0);
+    for (CompactIntEntry *entry : entries) {
+      alloc->DelObj(HSHM_DEFAULT_MEM_CTX, entry);
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 /**
  * TEST MPSC LIFO LIST QUEUE
  * */
@@ -117,6 +227,662 @@ TEST_CASE("TestMpscLifoListQueueIntMultithreaded") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+/**
+ * TEST MPMC LIFO LIST QUEUE
+ * */
+
+TEST_CASE("TestMpmcLifoListQueueInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceThenConsume<hipc::mpmc_lifo_list_queue<IntEntry>, IntEntry *>(1, 1, 32,
+                                                                       32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpmcLifoListQueueIntMultithreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceAndConsume<hipc::mpmc_lifo_list_queue<IntEntry>, IntEntry *>(
+      8, 1, 8000, 32);
+  ProduceAndConsume<hipc::mpmc_lifo_list_queue<IntEntry>, IntEntry *>(
+      4, 4, 8000, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+template <typename QueueT>
+void BatchQueueTest(size_t depth) {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  QueueT queue(alloc, depth);
+  int vals[8], out[16];
+  for (int i = 0; i < 8; ++i) {
+    vals[i] = i;
+  }
+
+  // A batch larger than the queue can never fit
+  REQUIRE(queue.reserve_n(depth + 1).IsNull());
+
+  // Reserve several slots at once and publish them out of order
+  hshm::qtok_t tok = queue.reserve_n(3);
+  REQUIRE(!tok.IsNull());
+  queue.commit(tok.id_ + 1, 10);
+  REQUIRE(queue.pop_n(out, 16) == 0);
+  queue.commit(tok.id_, 9);
+  REQUIRE(queue.pop_n(out, 16) == 2);
+  REQUIRE(out[0] == 9);
+  REQUIRE(out[1] == 10);
+  queue.commit(tok.id_ + 2, 11);
+
+  // Emplace and drain in batches
+  REQUIRE(!queue.emplace_n(vals, 8).IsNull());
+  REQUIRE(queue.pop_n(out, 4) == 4);
+  REQUIRE(out[0] == 11);
+  for (int i = 1; i < 4; ++i) {
+    REQUIRE(out[i] == i - 1);
+  }
+  REQUIRE(queue.pop_n(out, 16) == 5);
+  for (int i = 0; i < 5; ++i) {
+    REQUIRE(out[i] == i + 3);
+  }
+  REQUIRE(queue.pop_n(out, 16) == 0);
+  REQUIRE(queue.GetSize() == 0);
+}
+
+template <typename QueueT>
+void BatchQueueMultiThreaded(size_t nproducers, size_t count_per_rank,
+                             size_t batch, size_t depth) {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  QueueT queue(alloc, depth);
+  size_t total = nproducers * count_per_rank;
+  std::vector<int> entries;
+  entries.reserve(total);
+
+  omp_set_dynamic(0);
+#pragma omp parallel shared(queue, entries) num_threads(nproducers + 1)
+  {
+    size_t rank = omp_get_thread_num();
+    if (rank < nproducers) {
+      std::vector<int> vals(batch);
+      for (size_t i = 0; i < count_per_rank; i += batch) {
+        for (size_t j = 0; j < batch; ++j) {
+          vals[j] = (int)(rank * count_per_rank + i + j);
+        }
+        queue.emplace_n(vals.data(), batch);
+      }
+    } else {
+      std::vector<int> out(batch);
+      while (entries.size() < total) {
+        size_t count = queue.pop_n(out.data(), batch);
+        entries.insert(entries.end(), out.begin(), out.begin() + count);
+      }
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+  for (size_t i = 0; i < total; ++i) {
+    REQUIRE(entries[i] == (int)i);
+  }
+}
+
+/**
+ * TEST MPMC RING QUEUE
+ * */
+
+TEST_CASE("TestMpmcRingQueueInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceThenConsume<hipc::mpmc_ring_queue<int>, int>(1, 1, 32, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpmcRingQueueString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceThenConsume<hipc::mpmc_ring_queue<hipc::string>, hipc::string>(
+      1, 1, 32, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpmcRingQueueFull") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hshm::mpmc_ring_queue<int> queue(alloc, 6);
+    REQUIRE(queue.GetDepth() == 8);
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(!queue.emplace(i).IsNull());
+    }
+    REQUIRE(queue.emplace(8).IsNull());
+    int val;
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(!queue.pop(val).IsNull());
+      REQUIRE(val == i);
+    }
+    REQUIRE(queue.pop(val).IsNull());
+    REQUIRE(queue.GetSize() == 0);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpmcRingQueueIntMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceAndConsume<hipc::mpmc_ring_queue<int>, int>(4, 4, 2048, 64);
+  ProduceAndConsume<hipc::mpmc_ring_queue<int>, int>(8, 8, 2048, 64);
+  ProduceAndConsume<hipc::mpmc_ring_queue<int>, int>(16, 16, 256, 256);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * TEST MPMC SEGMENT QUEUE
+ * */
+
+template <typename T>
+void SegmentQueueTest(size_t count, size_t seg_size) {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  hipc::mpmc_segment_queue<T> queue(alloc, seg_size, 4);
+  hipc::MemContext ctx;
+  REQUIRE(queue.Register(ctx));
+  T val;
+  for (size_t i = 0; i < count; ++i) {
+    CREATE_SET_VAR_TO_INT_OR_STRING(T, var, i);
+    REQUIRE(!queue.emplace(ctx, var).IsNull());
+  }
+  REQUIRE(queue.GetSize(ctx) == count);
+  for (size_t i = 0; i < count; ++i) {
+    CREATE_SET_VAR_TO_INT_OR_STRING(T, var, i);
+    REQUIRE(!queue.pop(ctx, val).IsNull());
+    REQUIRE(val == var);
+  }
+  REQUIRE(queue.pop(ctx, val).IsNull());
+  REQUIRE(queue.GetSize(ctx) == 0);
+
+  // Entries left in the queue are destroyed with it
+  for (size_t i = 0; i < count; ++i) {
+    CREATE_SET_VAR_TO_INT_OR_STRING(T, var, i);
+    queue.emplace(ctx, var);
+  }
+  queue.Unregister(ctx);
+}
+
+void SegmentQueueMultiThreaded(size_t nproducers, size_t nconsumers,
+                               size_t count_per_rank, size_t seg_size) {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  hipc::mpmc_segment_queue<int> queue(alloc, seg_size,
+                                      nproducers + nconsumers);
+  size_t total = nproducers * count_per_rank;
+  std::vector<int> entries;
+  entries.reserve(total);
+  std::atomic<size_t> consumed(0);
+  hshm::Mutex lock;
+
+  omp_set_dynamic(0);
+#pragma omp parallel shared(queue, entries, consumed, lock) \
+    num_threads(nproducers + nconsumers)
+  {
+    size_t rank = omp_get_thread_num();
+    hipc::MemContext ctx;
+    queue.Register(ctx);
+    if (rank < nproducers) {
+      for (size_t i = 0; i < count_per_rank; ++i) {
+        queue.emplace(ctx, (int)(rank * count_per_rank + i));
+      }
+    } else {
+      std::vector<int> local;
+      int val;
+      while (consumed.load() < total) {
+        if (queue.pop(ctx, val).IsNull()) {
+          HSHM_THREAD_MODEL->Yield();
+          continue;
+        }
+        local.emplace_back(val);
+        consumed.fetch_add(1);
+      }
+      hshm::ScopedMutex guard(lock, 0);
+      entries.insert(entries.end(), local.begin(), local.end());
+    }
+    queue.Unregister(ctx);
+  }
+  std::sort(entries.begin(), entries.end());
+  REQUIRE(entries.size() == total);
+  for (size_t i = 0; i < total; ++i) {
+    REQUIRE(entries[i] == (int)i);
+  }
+}
+
+TEST_CASE("TestMpmcSegmentQueueInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SegmentQueueTest<int>(37, 4);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpmcSegmentQueueString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SegmentQueueTest<hipc::string>(37, 4);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpmcSegmentQueueIntMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SegmentQueueMultiThreaded(4, 4, 2048, 16);
+  SegmentQueueMultiThreaded(8, 2, 1024, 64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * TEST WS DEQUE
+ * */
+
+TEST_CASE("TestWsDeque") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hipc::ws_deque<int> deque(alloc, 4);
+    int val;
+    REQUIRE(deque.pop(val).IsNull());
+    REQUIRE(deque.steal(val).IsNull());
+
+    // The buffer grows past its initial depth
+    for (int i = 0; i < 37; ++i) {
+      deque.push(i);
+    }
+    REQUIRE(deque.GetSize() == 37);
+    REQUIRE(deque.GetDepth() == 64);
+
+    // Thieves take the oldest entries, the owner the newest
+    for (int i = 0; i < 10; ++i) {
+      REQUIRE(!deque.steal(val).IsNull());
+      REQUIRE(val == i);
+    }
+    for (int i = 36; i >= 10; --i) {
+      REQUIRE(!deque.pop(val).IsNull());
+      REQUIRE(val == i);
+    }
+    REQUIRE(deque.pop(val).IsNull());
+    REQUIRE(deque.steal(val).IsNull());
+    REQUIRE(deque.GetSize() == 0);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestWsDequeMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    const size_t nthieves = 4, total = 1 << 16;
+    hipc::ws_deque<size_t> deque(alloc, 16);
+    std::vector<size_t> taken(total, 0);
+    std::atomic<size_t> count(0);
+
+    // The owner pushes and pops while thieves steal; each entry is
+    // taken exactly once
+    omp_set_dynamic(0);
+#pragma omp parallel shared(deque, taken, count) num_threads(nthieves + 1)
+    {
+      size_t rank = omp_get_thread_num();
+      size_t val;
+      if (rank == 0) {
+        for (size_t i = 0; i < total; ++i) {
+          deque.push(i);
+          if (i % 3 == 0 && !deque.pop(val).IsNull()) {
+            taken[val] += 1;
+            count.fetch_add(1);
+          }
+        }
+        while (!deque.pop(val).IsNull()) {
+          taken[val] += 1;
+          count.fetch_add(1);
+        }
+      } else {
+        while (count.load() < total) {
+          if (!deque.steal(val).IsNull()) {
+            __atomic_fetch_add(&taken[val], 1, __ATOMIC_RELAXED);
+            count.fetch_add(1);
+          }
+        }
+      }
+    }
+    for (size_t i = 0; i < total; ++i) {
+      REQUIRE(taken[i] == 1);
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * TEST BYTE RING
+ * */
+
+TEST_CASE("TestByteRing") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hipc::spsc_byte_ring<> ring(alloc, 256);
+    REQUIRE(ring.GetCapacity() == 256);
+    REQUIRE(ring.peek().IsNull());
+    REQUIRE(ring.reserve(ring.GetMaxRecordSize() + 1).IsNull());
+
+    // Records of varying size wrap around the ring many times
+    for (size_t i = 0; i < 1000; ++i) {
+      size_t size = i % 97;
+      hipc::byte_ring_span span = ring.reserve(size);
+      REQUIRE(!span.IsNull());
+      memset(span.data(), (int)(i % 251), size);
+      ring.commit(span);
+      span = ring.peek();
+      REQUIRE(!span.IsNull());
+      REQUIRE(span.size() == size);
+      for (size_t j = 0; j < size; ++j) {
+        REQUIRE(span.data()[j] == (char)(i % 251));
+      }
+      ring.release(span);
+    }
+    REQUIRE(ring.peek().IsNull());
+    REQUIRE(ring.GetSize() == 0);
+
+    // Fill the ring until a reservation fails
+    size_t count = 0;
+    while (!ring.emplace(&count, sizeof(count)).IsNull()) {
+      ++count;
+    }
+    // Each record takes 32 bytes; one may be lost to padding at the end
+    REQUIRE(count >= 256 / 32 - 1);
+    for (size_t i = 0; i < count; ++i) {
+      hipc::byte_ring_span span = ring.peek();
+      REQUIRE(span.size() == sizeof(size_t));
+      REQUIRE(*reinterpret_cast<size_t *>(span.data()) == i);
+      ring.release(span);
+    }
+    REQUIRE(ring.peek().IsNull());
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestByteRingMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    const size_t nproducers = 4, count_per_rank = 4096;
+    hipc::mpsc_byte_ring<> ring(alloc, 4096);
+    std::vector<size_t> next(nproducers, 0);
+
+    // Each record holds (rank, i) followed by a variable-length body
+    omp_set_dynamic(0);
+#pragma omp parallel shared(ring, next) num_threads(nproducers + 1)
+    {
+      size_t rank = omp_get_thread_num();
+      if (rank < nproducers) {
+        for (size_t i = 0; i < count_per_rank; ++i) {
+          size_t size = 2 * sizeof(size_t) + (i % 64);
+          hipc::byte_ring_span span;
+          while ((span = ring.reserve(size)).IsNull()) {
+            HSHM_THREAD_MODEL->Yield();
+          }
+          size_t *hdr = reinterpret_cast<size_t *>(span.data());
+          hdr[0] = rank;
+          hdr[1] = i;
+          memset(span.data() + 2 * sizeof(size_t), (int)rank, i % 64);
+          ring.commit(span);
+        }
+      } else {
+        size_t total = nproducers * count_per_rank;
+        for (size_t n = 0; n < total;) {
+          hipc::byte_ring_span span = ring.peek();
+          if (span.IsNull()) {
+            HSHM_THREAD_MODEL->Yield();
+            continue;
+          }
+          size_t *hdr = reinterpret_cast<size_t *>(span.data());
+          size_t src = hdr[0], i = hdr[1];
+          REQUIRE(span.size() == 2 * sizeof(size_t) + (i % 64));
+          REQUIRE(next[src] == i);
+          for (size_t j = 0; j < i % 64; ++j) {
+            REQUIRE(span.data()[2 * sizeof(size_t) + j] == (char)src);
+          }
+          next[src] += 1;
+          ring.release(span);
+          ++n;
+        }
+      }
+    }
+    for (size_t i = 0; i < nproducers; ++i) {
+      REQUIRE(next[i] == count_per_rank);
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * TEST BROADCAST RING
+ * */
+
+TEST_CASE("TestBroadcastRing") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hipc::broadcast_ring<int> ring(alloc, 16, 4);
+    REQUIRE(ring.GetDepth() == 16);
+
+    // Without consumers the producer never blocks
+    for (int i = 0; i < 64; ++i) {
+      REQUIRE(!ring.emplace(i).IsNull());
+    }
+
+    // Every consumer sees every entry published after it joins
+    size_t a, b;
+    REQUIRE(ring.Register(a));
+    REQUIRE(ring.Register(b));
+    for (int i = 0; i < 16; ++i) {
+      REQUIRE(!ring.emplace(i).IsNull());
+    }
+    REQUIRE(ring.emplace(16).IsNull());
+    int val;
+    for (int i = 0; i < 16; ++i) {
+      REQUIRE(!ring.pop(a, val).IsNull());
+      REQUIRE(val == i);
+    }
+    REQUIRE(ring.pop(a, val).IsNull());
+
+    // The producer gates on the slowest consumer
+    REQUIRE(ring.emplace(16).IsNull());
+    int batch[16];
+    REQUIRE(ring.pop_n(b, batch, 8) == 8);
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(batch[i] == i);
+    }
+    for (int i = 16; i < 24; ++i) {
+      REQUIRE(!ring.emplace(i).IsNull());
+    }
+    REQUIRE(ring.emplace(24).IsNull());
+    REQUIRE(ring.GetSize(a) == 8);
+    REQUIRE(ring.GetSize(b) == 16);
+
+    // A consumer leaving releases the producer
+    ring.Unregister(b);
+    for (int i = 24; i < 32; ++i) {
+      REQUIRE(!ring.emplace(i).IsNull());
+    }
+    int sum = 0;
+    REQUIRE(ring.consume(a, 32, [&sum](const int &x) { sum += x; }) == 16);
+    REQUIRE(sum == (16 + 31) * 16 / 2);
+
+    // A joining consumer starts at the tail and reuses a free cursor
+    size_t c;
+    REQUIRE(ring.Register(c));
+    REQUIRE(c == b);
+    REQUIRE(ring.GetSize(c) == 0);
+    REQUIRE(!ring.emplace(32).IsNull());
+    REQUIRE(!ring.pop(c, val).IsNull());
+    REQUIRE(val == 32);
+
+    // The cursor of an exited process pins the producer until reaped
+    REQUIRE(ring.consume(a, 32, [](const int &) {}) == 1);
+    pid_t child = fork();
+    if (child == 0) {
+      _exit(0);
+    }
+    waitpid(child, nullptr, 0);
+    (*ring.cursors_)[c].owner_.store((hshm::min_u64)child);
+    for (int i = 33; i < 49; ++i) {
+      REQUIRE(!ring.emplace(i).IsNull());
+    }
+    REQUIRE(ring.consume(a, 32, [](const int &) {}) == 16);
+    REQUIRE(ring.emplace(49).IsNull());
+    REQUIRE(ring.ReapDeadConsumers() == 1);
+    REQUIRE(ring.ReapDeadConsumers() == 0);
+    REQUIRE(!ring.emplace(49).IsNull());
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestBroadcastRingMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    const size_t nconsumers = 3, count = 8192;
+    hipc::broadcast_ring<size_t> ring(alloc, 256, nconsumers);
+    std::vector<size_t> ids(nconsumers);
+    for (size_t i = 0; i < nconsumers; ++i) {
+      REQUIRE(ring.Register(ids[i]));
+    }
+
+    // One producer; each consumer reads every entry in batches
+    omp_set_dynamic(0);
+#pragma omp parallel shared(ring, ids) num_threads(nconsumers + 1)
+    {
+      size_t rank = omp_get_thread_num();
+      if (rank == nconsumers) {
+        for (size_t i = 0; i < count; ++i) {
+          while (ring.emplace(i).IsNull()) {
+            HSHM_THREAD_MODEL->Yield();
+          }
+        }
+      } else {
+        size_t next = 0;
+        while (next < count) {
+          size_t n = ring.consume(ids[rank], 32, [&next](const size_t &x) {
+            REQUIRE(x == next);
+            ++next;
+          });
+          if (n == 0) {
+            HSHM_THREAD_MODEL->Yield();
+          }
+        }
+        ring.Unregister(ids[rank]);
+      }
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * TEST PRIORITY QUEUE
+ * */
+
+TEST_CASE("TestPriorityQueue") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hipc::priority_queue<int> max_queue(alloc);
+    hipc::priority_queue<int, std::greater<int>> min_queue(alloc);
+    std::priority_queue<int> expected;
+    for (int i = 0; i < 1000; ++i) {
+      int val = (i * 7919) % 1009;
+      max_queue.push(val);
+      min_queue.push(val);
+      expected.push(val);
+    }
+    REQUIRE(max_queue.size() == 1000);
+
+    // Copies keep the heap order
+    hipc::priority_queue<int> copy(alloc, max_queue);
+    int prev = -1;
+    while (!expected.empty()) {
+      REQUIRE(max_queue.top() == expected.top());
+      REQUIRE(copy.top() == expected.top());
+      max_queue.pop();
+      copy.pop();
+      expected.pop();
+
+      int val;
+      REQUIRE(min_queue.pop(val));
+      REQUIRE(val >= prev);
+      prev = val;
+    }
+    int val;
+    REQUIRE(!max_queue.pop(val));
+    REQUIRE(min_queue.empty());
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMultiPriorityQueue") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hipc::multi_priority_queue<int, std::greater<int>> queue(alloc, 4);
+    REQUIRE(queue.GetNumHeaps() == 4);
+    for (int i = 0; i < 1024; ++i) {
+      REQUIRE(!queue.push(1023 - i).IsNull());
+    }
+    REQUIRE(queue.GetSize() == 1024);
+
+    // Ordering is relaxed, but every entry comes out once
+    std::vector<bool> seen(1024, false);
+    int val;
+    size_t early = 0;
+    for (int i = 0; i < 1024; ++i) {
+      REQUIRE(!queue.pop(val).IsNull());
+      REQUIRE(!seen[val]);
+      seen[val] = true;
+      early += i < 256 && val < 512;
+    }
+    REQUIRE(queue.pop(val).IsNull());
+    REQUIRE(queue.GetSize() == 0);
+    // Popping the better of two heaps mostly favors small entries
+    REQUIRE(early > 200);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMultiPriorityQueueMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    const size_t nthreads = 4, count_per_rank = 4096;
+    hipc::multi_priority_queue<size_t> queue(alloc, 2 * nthreads);
+    std::vector<size_t> seen(nthreads * count_per_rank, 0);
+    std::atomic<size_t> popped(0);
+
+    // Every thread pushes its own range, then all threads drain
+    omp_set_dynamic(0);
+#pragma omp parallel shared(queue, seen, popped) num_threads(nthreads)
+    {
+      size_t rank = omp_get_thread_num();
+      for (size_t i = 0; i < count_per_rank; ++i) {
+        queue.emplace(rank * count_per_rank + i);
+        size_t val;
+        if (i % 2 && !queue.pop(val).IsNull()) {
+          seen[val] += 1;
+          popped += 1;
+        }
+      }
+#pragma omp barrier
+      size_t val;
+      while (!queue.pop(val).IsNull()) {
+        seen[val] += 1;
+        popped += 1;
+      }
+    }
+    REQUIRE(popped == nthreads * count_per_rank);
+    for (size_t i = 0; i < seen.size(); ++i) {
+      REQUIRE(seen[i] == 1);
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 /**
  * TEST MPSC QUEUE
  * */
@@ -168,6 +934,52 @@ TEST_CASE("TestMpscQueuePeek") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+TEST_CASE("TestMpscQueueBatch") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BatchQueueTest<hipc::mpsc_queue<int>>(32);
+  BatchQueueTest<hipc::fast_mpsc_queue<int>>(32);
+  BatchQueueMultiThreaded<hipc::mpsc_queue<int>>(4, 8192, 16, 64);
+  BatchQueueMultiThreaded<hipc::fast_mpsc_queue<int>>(4, 8192, 16, 64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * MPSC Fast Queue
+ * */
+
+TEST_CASE("TestMpscFastQueueInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceThenConsume<hipc::fast_mpsc_queue<int>, int>(1, 1, 32, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpscFastQueueIntMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceAndConsume<hipc::fast_mpsc_queue<int>, int>(8, 1, 8192, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpscFastQueueDepth") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("TEST") {
+    hshm::fast_mpsc_queue<int> queue(alloc, 20);
+    REQUIRE(queue.GetDepth() == 32);
+    for (int i = 0; i < 100; ++i) {
+      queue.emplace(i);
+      int val;
+      REQUIRE(!queue.pop(val).IsNull());
+      REQUIRE(val == i);
+    }
+    int val;
+    REQUIRE(queue.pop(val).IsNull());
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 /**
  * MPSC Pointer Queue
  * */
@@ -186,6 +998,14 @@ TEST_CASE("TestMpscPtrQueueIntMultiThreaded") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+TEST_CASE("TestMpscPtrQueueBatch") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BatchQueueTest<hipc::mpsc_ptr_queue<int>>(32);
+  BatchQueueMultiThreaded<hipc::mpsc_ptr_queue<int>>(4, 8192, 16, 64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 TEST_CASE("TestMpscOffsetPointerQueueCompile") {
   auto *alloc = HSHM_DEFAULT_ALLOC;
   hipc::mpsc_ptr_queue<hipc::OffsetPointer> queue(alloc);
@@ -243,6 +1063,91 @@ TEST_CASE("TestSpscQueuePopBack") {
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
 
+/**
+ * TEST SPSC FAST QUEUE
+ * */
+
+TEST_CASE("TestSpscQueueBatch") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BatchQueueTest<hipc::spsc_queue<int>>(32);
+  BatchQueueTest<hipc::fast_spsc_queue<int>>(32);
+  BatchQueueTest<hipc::spsc_ptr_queue<int>>(32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestSpscFastQueueInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceThenConsume<hipc::fast_spsc_queue<int>, int>(1, 1, 32, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestSpscFastQueueIntMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  ProduceAndConsume<hipc::fast_spsc_queue<int>, int>(1, 1, 8192, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * Blocking Queues
+ * */
+
+template <typename QueueT>
+void BlockingQueueTest(size_t count, size_t depth) {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  QueueT queue(alloc, depth);
+  int val;
+
+  // Timed waits give up on an empty or full queue
+  REQUIRE(queue.pop_wait(val, 1000).IsNull());
+  for (size_t i = 0; i < depth; ++i) {
+    REQUIRE(!queue.emplace_wait((int)i, 1000).IsNull());
+  }
+  REQUIRE(queue.emplace_wait(-1, 1000).IsNull());
+  for (size_t i = 0; i < depth; ++i) {
+    REQUIRE(!queue.pop_wait(val, 1000).IsNull());
+    REQUIRE(val == (int)i);
+  }
+
+  // A sleeping consumer is woken by the producer and vice versa
+  std::vector<int> entries;
+  omp_set_dynamic(0);
+#pragma omp parallel shared(queue, entries) num_threads(2)
+  {
+    if (omp_get_thread_num() == 0) {
+      for (size_t i = 0; i < count; ++i) {
+        REQUIRE(!queue.emplace_wait((int)i).IsNull());
+      }
+    } else {
+      int entry;
+      for (size_t i = 0; i < count; ++i) {
+        REQUIRE(!queue.pop_wait(entry).IsNull());
+        entries.emplace_back(entry);
+      }
+    }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    REQUIRE(entries[i] == (int)i);
+  }
+}
+
+TEST_CASE("TestSpscBlockingQueueWait") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BlockingQueueTest<hipc::blocking_spsc_queue<int>>(8192, 4);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("TestMpscBlockingQueueWait") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  BlockingQueueTest<hipc::blocking_mpsc_queue<int>>(8192, 4);
+  ProduceAndConsume<hipc::blocking_mpsc_queue<int>, int>(4, 1, 2048, 32);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
 template <typename T>
 void PointerQueueTest(T base_val) {
   auto *alloc = HSHM_DEFAULT_ALLOC;
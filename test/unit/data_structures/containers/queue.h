@@ -13,6 +13,8 @@
 #ifndef HSHM_SHM_TEST_UNIT_DATA_STRUCTURES_CONTAINERS_QUEUE_H_
 #define HSHM_SHM_TEST_UNIT_DATA_STRUCTURES_CONTAINERS_QUEUE_H_
 
+#include <memory>
+
 #include "basic_test.h"
 #include "hermes_shm/data_structures/all.h"
 #include "hermes_shm/types/numbers.h"
@@ -166,10 +168,21 @@ class QueueTestSuite {
   }
 };
 
+/** Create a queue of \a depth, or an unbounded queue if it has no depth */
+template <typename QueueT>
+std::unique_ptr<QueueT> MakeTestQueue(size_t depth) {
+  if constexpr (std::is_constructible_v<QueueT, size_t>) {
+    return std::make_unique<QueueT>(depth);
+  } else {
+    return std::make_unique<QueueT>();
+  }
+}
+
 template <typename QueueT, typename T>
 void ProduceThenConsume(size_t nproducers, size_t nconsumers,
                         size_t count_per_rank, size_t depth) {
-  QueueT queue(depth);
+  auto queue_ptr = MakeTestQueue<QueueT>(depth);
+  QueueT &queue = *queue_ptr;
   QueueTestSuite<QueueT, T> q(queue);
   std::atomic<size_t> count = 0;
   std::vector<size_t> entries;
@@ -200,7 +213,8 @@ void ProduceThenConsume(size_t nproducers, size_t nconsumers,
 template <typename QueueT, typename T>
 void ProduceAndConsume(size_t nproducers, size_t nconsumers,
                        size_t count_per_rank, size_t depth) {
-  QueueT queue(depth);
+  auto queue_ptr = MakeTestQueue<QueueT>(depth);
+  QueueT &queue = *queue_ptr;
   size_t nthreads = nproducers + nconsumers;
   QueueTestSuite<QueueT, T> q(queue);
   std::atomic<size_t> count = 0;
@@ -0,0 +1,216 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+* Distributed under BSD 3-Clause license.                                   *
+* Copyright by The HDF Group.                                               *
+* Copyright by the Illinois Institute of Technology.                        *
+* All rights reserved.                                                      *
+*                                                                           *
+* This file is part of Hermes. The full Hermes copyright notice, including  *
+* terms governing use, modification, and redistribution, is contained in    *
+* the COPYING file, which can be found at the top directory. If you do not  *
+* have access to the file, you may request a copy from help@hdfgroup.org.   *
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <omp.h>
+
+#include "basic_test.h"
+#include "test_init.h"
+#include "hermes_shm/data_structures/ipc/skiplist_map.h"
+#include "hermes_shm/data_structures/ipc/string.h"
+
+using hshm::ipc::epoch_guard;
+using hshm::ipc::skiplist_map;
+using hshm::ipc::string;
+
+#define CREATE_KV_PAIR(KEY_NAME, KEY, VAL_NAME, VAL)\
+  CREATE_SET_VAR_TO_INT_OR_STRING(Key, KEY_NAME, KEY); \
+  CREATE_SET_VAR_TO_INT_OR_STRING(Val, VAL_NAME, VAL);
+
+/** Check that the map iterates \a count entries in increasing key order */
+template<typename MapT>
+void VerifySkiplistOrder(MapT &map, const hipc::MemContext &ctx,
+                         size_t count) {
+  epoch_guard<MapT> guard(map, ctx);
+  size_t visited = 0;
+  auto prev = map.end();
+  for (auto iter = map.begin(); iter != map.end(); ++iter) {
+    if (!prev.is_end()) {
+      REQUIRE(prev.GetKey() < iter.GetKey());
+    }
+    REQUIRE(map.lower_bound(iter.GetKey()) == iter);
+    prev = iter;
+    ++visited;
+  }
+  REQUIRE(visited == count);
+  REQUIRE(map.size() == count);
+}
+
+template<typename Key, typename Val>
+void SkiplistMapOpTest() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  skiplist_map<Key, Val> map(alloc, 4);
+  hipc::MemContext ctx;
+  REQUIRE(map.Register(ctx));
+  const int count = 1000;
+
+  PAGE_DIVIDE("Insert entries out of order") {
+    for (int i = 0; i < count; ++i) {
+      int k = (i * 7) % count;
+      CREATE_KV_PAIR(key, k, val, k);
+      REQUIRE(map.try_emplace(ctx, key, val));
+    }
+    REQUIRE(map.get_levels() > 1);
+    VerifySkiplistOrder(map, ctx, count);
+  }
+
+  PAGE_DIVIDE("Find entries") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      Val found;
+      REQUIRE(map.find(ctx, key, found));
+      REQUIRE(found == val);
+      REQUIRE(map.contains(ctx, key));
+    }
+    CREATE_KV_PAIR(key, count, val, count);
+    Val found;
+    REQUIRE(!map.find(ctx, key, found));
+    REQUIRE(!map.contains(ctx, key));
+  }
+
+  PAGE_DIVIDE("Existing entries are not replaced") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i + 1);
+      REQUIRE(!map.try_emplace(ctx, key, val));
+    }
+    CREATE_KV_PAIR(key, 5, val, 5);
+    Val found;
+    REQUIRE(map.find(ctx, key, found));
+    REQUIRE(found == val);
+    REQUIRE(map.size() == count);
+  }
+
+  PAGE_DIVIDE("Erase half of the entries") {
+    for (int i = 0; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.erase(ctx, key));
+      REQUIRE(!map.erase(ctx, key));
+    }
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.contains(ctx, key) == (i % 2 == 1));
+    }
+    VerifySkiplistOrder(map, ctx, count / 2);
+  }
+
+  PAGE_DIVIDE("Lower bound skips erased entries") {
+    epoch_guard<skiplist_map<Key, Val>> guard(map, ctx);
+    CREATE_KV_PAIR(key, 2, val, 2);
+    CREATE_KV_PAIR(next_key, 3, next_val, 3);
+    auto iter = map.lower_bound(key);
+    REQUIRE(!iter.is_end());
+    REQUIRE(iter.GetKey() == next_key);
+    REQUIRE((*iter).second == next_val);
+  }
+
+  PAGE_DIVIDE("Re-insert erased entries") {
+    for (int i = 0; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.try_emplace(ctx, key, val));
+    }
+    VerifySkiplistOrder(map, ctx, count);
+  }
+
+  PAGE_DIVIDE("Clear the map") {
+    map.clear(ctx);
+    VerifySkiplistOrder(map, ctx, 0);
+    CREATE_KV_PAIR(key, 1, val, 1);
+    REQUIRE(map.try_emplace(ctx, key, val));
+    REQUIRE(map.size() == 1);
+  }
+  map.Unregister(ctx);
+}
+
+TEST_CASE("SkiplistMapOfIntInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SkiplistMapOpTest<int, int>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SkiplistMapOfIntString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SkiplistMapOpTest<int, string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SkiplistMapOfStringString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SkiplistMapOpTest<string, string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+/**
+ * Threads insert and erase overlapping keys while readers walk the map.
+ * Each key is inserted and erased by exactly one thread per round, and
+ * readers must always see the map in order.
+ * */
+void SkiplistMapMultiThreadedTest(int nthreads, size_t count,
+                                  size_t nrounds) {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  auto *map = alloc->NewObjLocal<skiplist_map<size_t, size_t>>(
+      HSHM_DEFAULT_MEM_CTX, nthreads).ptr_;
+  std::atomic<size_t> inserted(0), erased(0), unordered(0);
+
+  omp_set_dynamic(0);
+#pragma omp parallel shared(map, inserted, erased, unordered) \
+    num_threads(nthreads)
+  {
+    hipc::MemContext ctx;
+    map->Register(ctx);
+    for (size_t round = 0; round < nrounds; ++round) {
+      // Every thread races to insert and then erase every key
+      for (size_t i = 0; i < count; ++i) {
+        if (map->try_emplace(ctx, i, i)) {
+          inserted.fetch_add(1);
+        }
+      }
+      {
+        epoch_guard<skiplist_map<size_t, size_t>> guard(*map, ctx);
+        size_t prev = 0;
+        bool first = true;
+        for (auto iter = map->begin(); !iter.is_end(); ++iter) {
+          if (!first && iter.GetKey() <= prev) {
+            unordered.fetch_add(1);
+          }
+          prev = iter.GetKey();
+          first = false;
+        }
+      }
+      for (size_t i = 0; i < count; ++i) {
+        if (map->erase(ctx, i)) {
+          erased.fetch_add(1);
+        }
+      }
+    }
+    map->Unregister(ctx);
+  }
+
+  REQUIRE(unordered.load() == 0);
+  REQUIRE(inserted.load() == erased.load() + map->size());
+  hipc::MemContext ctx;
+  REQUIRE(map->Register(ctx));
+  for (size_t i = 0; i < count; ++i) {
+    REQUIRE(map->try_emplace(ctx, i, i));
+  }
+  VerifySkiplistOrder(*map, ctx, count);
+  map->Unregister(ctx);
+  alloc->DelObj(HSHM_DEFAULT_MEM_CTX, map);
+}
+
+TEST_CASE("SkiplistMapMultiThreaded") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SkiplistMapMultiThreadedTest(8, 2048, 16);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
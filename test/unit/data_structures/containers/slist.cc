@@ -18,11 +18,13 @@
 
 using hshm::ipc::slist;
 
-template<typename T>
-void SlistTest() {
+template<typename T, hipc::ShmFlagField FLAGS = 0>
+void SlistTest(hshm::u32 node_chunk = 0) {
+  using SlistT = slist<T, HSHM_DEFAULT_ALLOC_T, FLAGS>;
   auto *alloc = HSHM_DEFAULT_ALLOC;
-  slist<T> lp(alloc);
-  ListTestSuite<T, slist<T>, HSHM_DEFAULT_ALLOC_T> test(lp, alloc);
+  SlistT lp(alloc);
+  lp.set_node_chunk(node_chunk);
+  ListTestSuite<T, SlistT, HSHM_DEFAULT_ALLOC_T> test(lp, alloc);
 
   test.EmplaceTest(30);
   test.ForwardIteratorTest();
@@ -57,3 +59,76 @@ TEST_CASE("SlistOfStdString") {
   SlistTest<std::string>();
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
+
+TEST_CASE("SlistPooledOfInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SlistTest<int>(64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SlistPooledOfString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SlistTest<hipc::string>(64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SlistCompactOfInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SlistTest<int, hipc::ShmFlag::kCompactLinks>();
+  SlistTest<int, hipc::ShmFlag::kCompactLinks>(64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SlistCompactOfString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SlistTest<hipc::string, hipc::ShmFlag::kCompactLinks>();
+  SlistTest<hipc::string, hipc::ShmFlag::kCompactLinks>(64);
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SlistNodePool") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("Erased entries are recycled") {
+    slist<int> lp(alloc);
+    REQUIRE(lp.set_node_chunk(32));
+    for (int i = 0; i < 100; ++i) {
+      lp.emplace_back(i);
+    }
+    REQUIRE(!lp.set_node_chunk(0));
+    REQUIRE(lp.get_node_chunk() == 32);
+    size_t pooled = alloc->GetCurrentlyAllocatedSize();
+    for (int i = 0; i < 50; ++i) {
+      lp.erase(lp.begin());
+    }
+    for (int i = 100; i < 150; ++i) {
+      lp.emplace_back(i);
+    }
+    REQUIRE(lp.size() == 100);
+    REQUIRE(alloc->GetCurrentlyAllocatedSize() == pooled);
+    int i = 50;
+    for (int &val : lp) {
+      REQUIRE(val == i++);
+    }
+    REQUIRE(i == 150);
+
+    // Copies keep the chunk size
+    slist<int> copy(lp);
+    REQUIRE(copy.get_node_chunk() == 32);
+    REQUIRE(copy.size() == 100);
+    copy = slist<int>(alloc);
+    copy = lp;
+    REQUIRE(copy.get_node_chunk() == 32);
+
+    // Pooled entries cannot be spliced into another slist
+    slist<int> plain(alloc);
+    REQUIRE_THROWS(plain.splice_front(lp));
+    REQUIRE(lp.size() == 100);
+    REQUIRE(plain.size() == 0);
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
@@ -0,0 +1,158 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "hermes_shm/data_structures/ipc/small_vector.h"
+
+#include "basic_test.h"
+#include "hermes_shm/data_structures/ipc/string.h"
+#include "hermes_shm/data_structures/ipc/vector.h"
+#include "test_init.h"
+#include "vector.h"
+
+using hshm::ipc::small_vector;
+using hshm::ipc::string;
+using hshm::ipc::vector;
+
+template <typename T, size_t N>
+void SmallVectorTest() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  auto vec = small_vector<T, N>(alloc);
+  VectorTestSuite<T, small_vector<T, N>> test(vec, alloc);
+  test.EmplaceTest(15);
+  test.IndexTest();
+  test.ForwardIteratorTest();
+  test.ConstForwardIteratorTest();
+  test.CopyConstructorTest();
+  test.CopyAssignmentTest();
+  test.MoveConstructorTest();
+  test.MoveAssignmentTest();
+  test.EmplaceFrontTest();
+  test.ModifyEntryCopyIntoTest();
+  test.ModifyEntryMoveIntoTest();
+  test.EraseTest();
+}
+
+/** Elements stay inline up to N and spill to the allocator past it */
+template <typename T>
+void SmallVectorSpillTest() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  small_vector<T, 4> vec(alloc);
+
+  PAGE_DIVIDE("Inline elements do not allocate") {
+    size_t before = alloc->GetCurrentlyAllocatedSize();
+    for (int i = 0; i < 4; ++i) {
+      CREATE_SET_VAR_TO_INT_OR_STRING(T, var, i);
+      vec.emplace_back(var);
+    }
+    REQUIRE(vec.is_inline());
+    REQUIRE(vec.capacity() == 4);
+    if constexpr (!IS_SHM_ARCHIVEABLE(T)) {
+      REQUIRE(alloc->GetCurrentlyAllocatedSize() == before);
+    }
+  }
+
+  PAGE_DIVIDE("Insert into the middle spills the vector") {
+    CREATE_SET_VAR_TO_INT_OR_STRING(T, var, 100);
+    vec.emplace(vec.begin() + 2, var);
+    REQUIRE(!vec.is_inline());
+    REQUIRE(vec.size() == 5);
+    int expected[] = {0, 1, 100, 2, 3};
+    for (int i = 0; i < 5; ++i) {
+      CREATE_SET_VAR_TO_INT_OR_STRING(T, exp, expected[i]);
+      REQUIRE(vec[i] == exp);
+    }
+  }
+
+  PAGE_DIVIDE("Moving an inline vector moves its elements") {
+    small_vector<T, 4> small(alloc);
+    CREATE_SET_VAR_TO_INT_OR_STRING(T, var, 7);
+    small.emplace_back(var);
+    small_vector<T, 4> moved(std::move(small));
+    REQUIRE(small.IsNull());
+    REQUIRE(moved.is_inline());
+    REQUIRE(moved.size() == 1);
+    REQUIRE(moved[0] == var);
+  }
+
+  PAGE_DIVIDE("Copies keep the growth factor") {
+    vec.set_growth_factor(2);
+    REQUIRE_THROWS(vec.set_growth_factor(0.5f));
+    REQUIRE_THROWS(vec.set_growth_factor(NAN));
+    REQUIRE(vec.get_growth_factor() == 2);
+    small_vector<T, 4> copy(vec);
+    REQUIRE(copy.get_growth_factor() == 2);
+    REQUIRE(copy.size() == vec.size());
+    small_vector<T, 4> assigned(alloc);
+    assigned = vec;
+    REQUIRE(assigned.get_growth_factor() == 2);
+  }
+
+  PAGE_DIVIDE("Resize constructs and destroys elements") {
+    vec.resize(2);
+    REQUIRE(vec.size() == 2);
+    vec.resize(6);
+    REQUIRE(vec.size() == 6);
+    vec.clear();
+    REQUIRE(vec.size() == 0);
+  }
+}
+
+TEST_CASE("SmallVectorOfInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SmallVectorTest<int, 4>();
+  SmallVectorTest<int, 32>();
+  SmallVectorSpillTest<int>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SmallVectorOfString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SmallVectorTest<string, 4>();
+  SmallVectorTest<string, 32>();
+  SmallVectorSpillTest<string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SmallVectorOfStdString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  SmallVectorTest<std::string, 4>();
+  SmallVectorTest<std::string, 32>();
+  SmallVectorSpillTest<std::string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("SmallVectorNested") {
+  static_assert(hipc::is_trivially_relocatable_v<small_vector<int, 4>>);
+  static_assert(hipc::is_trivially_relocatable_v<small_vector<string, 4>>);
+  static_assert(
+      !hipc::is_trivially_relocatable_v<small_vector<std::string, 4>>);
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("A vector of small vectors") {
+    vector<small_vector<string, 2>> vec(alloc);
+    for (int i = 0; i < 20; ++i) {
+      vec.emplace_back();
+      for (int j = 0; j <= i % 4; ++j) {
+        vec.back().emplace_back(std::to_string(j));
+      }
+    }
+    for (int i = 0; i < 20; ++i) {
+      REQUIRE(vec[i].size() == (size_t)(i % 4 + 1));
+      REQUIRE(vec[i].is_inline() == (i % 4 < 2));
+      REQUIRE(vec[i].back() == std::to_string(i % 4));
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
@@ -32,12 +32,14 @@ using hshm::ipc::string;
   CREATE_SET_VAR_TO_INT_OR_STRING(Key, KEY_NAME, KEY); \
   CREATE_SET_VAR_TO_INT_OR_STRING(Val, VAL_NAME, VAL);
 
-template<typename Key, typename Val>
+template<typename Key, typename Val, hipc::ShmFlagField FLAGS = 0>
 void UnorderedMapOpTest() {
+  using MapT =
+      unordered_map<Key, Val, hshm::hash<Key>, HSHM_DEFAULT_ALLOC_T, FLAGS>;
   auto *alloc = HSHM_DEFAULT_ALLOC;
-  unordered_map<Key, Val> map(alloc, 5);
+  MapT map(alloc, 5);
 
-  // Insert 20 entries into the map (no growth trigger)
+  // Insert 20 entries into the map (triggers growth)
   PAGE_DIVIDE("Insert entries") {
     for (int i = 0; i < 20; ++i) {
       CREATE_KV_PAIR(key, i, val, i);
@@ -77,7 +79,7 @@ void UnorderedMapOpTest() {
     for (int i = 0; i < 20; ++i) {
       CREATE_KV_PAIR(key, i, val, i);
       auto iter = map.find(key);
-      hipc::pair<Key, Val> &pair = *iter;
+      auto &pair = *iter;
       REQUIRE(pair.GetVal() == val);
     }
   }
@@ -95,7 +97,7 @@ void UnorderedMapOpTest() {
   PAGE_DIVIDE("Modify the fourth map entry") {
     CREATE_KV_PAIR(key, 4, val, 25);
     auto iter = map.find(key);
-    hipc::pair<Key, Val>& pair = *iter;
+    auto &pair = *iter;
     pair.GetVal() = val;
     REQUIRE(pair.GetVal() == val);
   }
@@ -110,7 +112,7 @@ void UnorderedMapOpTest() {
   PAGE_DIVIDE("Copy assignment test") {
     CREATE_KV_PAIR(key, 4, val, 50);
     auto iter = map.find(key);
-    hipc::pair<Key, Val>& pair = *iter;
+    auto &pair = *iter;
     pair.GetVal() = val;
     REQUIRE(pair.GetVal() == val);
   }
@@ -166,7 +168,7 @@ void UnorderedMapOpTest() {
     REQUIRE(map.size() == 0);
   }
 
-  // Add 100 entries to the map (should force a growth)
+  // Add 100 entries to the map (forces a growth)
   PAGE_DIVIDE("Add 100 entries to the map") {
     for (int i = 0; i < 100; ++i) {
       CREATE_KV_PAIR(key, i, val, i);
@@ -176,7 +178,7 @@ void UnorderedMapOpTest() {
       CREATE_KV_PAIR(key, i, val, i);
       auto iter = map.find(key);
       REQUIRE(iter != map.end());
-      hipc::pair<Key, Val>& pair = *iter;
+      auto &pair = *iter;
       REQUIRE(pair.GetKey() == key);
       REQUIRE(pair.GetVal() == val);
     }
@@ -184,19 +186,19 @@ void UnorderedMapOpTest() {
 
   // Copy assignment operator
   PAGE_DIVIDE("Copy the map") {
-    unordered_map<Key, Val> cpy(alloc);
+    MapT cpy(alloc);
     cpy = map;
     for (int i = 0; i < 100; ++i) {
       CREATE_KV_PAIR(key, i, val, i);
       auto iter1 = map.find(key);
       auto iter2 = cpy.find(key);
       REQUIRE(!iter1.is_end());
-      hipc::pair<Key, Val>& pair1 = *iter1;
+      auto &pair1 = *iter1;
       REQUIRE(pair1.GetKey() == key);
       REQUIRE(pair1.GetVal() == val);
 
       REQUIRE(!iter2.is_end());
-      hipc::pair<Key, Val>& pair2 = *iter2;
+      auto &pair2 = *iter2;
       REQUIRE(pair2.GetKey() == key);
       REQUIRE(pair2.GetVal() == val);
     }
@@ -204,13 +206,13 @@ void UnorderedMapOpTest() {
 
   // Move assignment operator
   PAGE_DIVIDE("Move the map") {
-    unordered_map<Key, Val> cpy(alloc);
+    MapT cpy(alloc);
     cpy = std::move(map);
     for (int i = 0; i < 100; ++i) {
       CREATE_KV_PAIR(key, i, val, i);
       auto iter = cpy.find(key);
       REQUIRE(!iter.is_end());
-      hipc::pair<Key, Val>& pair = *iter;
+      auto &pair = *iter;
       REQUIRE(pair.GetKey() == key);
       REQUIRE(pair.GetVal() == val);
     }
@@ -246,3 +248,195 @@ TEST_CASE("UnorderedMapOfStringString") {
   UnorderedMapOpTest<string, string>();
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
+
+TEST_CASE("UnorderedMapCompactOfIntInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  UnorderedMapOpTest<int, int, hipc::ShmFlag::kCompactLinks>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("UnorderedMapCompactOfStringString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  UnorderedMapOpTest<string, string, hipc::ShmFlag::kCompactLinks>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+template<typename Key, typename Val>
+void UnorderedMapGrowthTest() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  unordered_map<Key, Val> map(alloc, 5);
+  const int count = 10000;
+
+  // Insert enough entries to grow the map many times
+  PAGE_DIVIDE("Grow while inserting") {
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      map.emplace(key, val);
+    }
+    REQUIRE(map.size() == count);
+    REQUIRE(map.get_num_buckets() * 4 / 5 >= count / 2);
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map[key] == val);
+    }
+  }
+
+  // Erase and re-emplace entries while a rehash is in progress
+  PAGE_DIVIDE("Erase during a rehash") {
+    while (!map.IsRehashing()) {
+      CREATE_KV_PAIR(key, (int)map.size(), val, (int)map.size());
+      map.emplace(key, val);
+    }
+    size_t size = map.size();
+    for (int i = 0; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i);
+      map.erase(key);
+    }
+    REQUIRE(map.size() == size - count / 2);
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE((map.find(key) == map.end()) == (i % 2 == 0));
+    }
+    for (int i = 0; i < count; i += 2) {
+      CREATE_KV_PAIR(key, i, val, i);
+      REQUIRE(map.try_emplace(key, val));
+    }
+    REQUIRE(map.size() == size);
+  }
+
+  // Iteration visits both the new and the not yet moved old buckets
+  PAGE_DIVIDE("Iterate during a rehash") {
+    while (!map.IsRehashing()) {
+      CREATE_KV_PAIR(key, (int)map.size(), val, (int)map.size());
+      map.emplace(key, val);
+    }
+    std::vector<int> keys;
+    for (auto &entry : map) {
+      GET_INT_FROM_KEY(entry.GetKey());
+      keys.emplace_back(key_ret);
+    }
+    REQUIRE(map.IsRehashing());
+    REQUIRE(keys.size() == map.size());
+    std::sort(keys.begin(), keys.end());
+    REQUIRE(std::unique(keys.begin(), keys.end()) == keys.end());
+  }
+
+  // Iterating on from a found entry never revisits an entry
+  PAGE_DIVIDE("Iterate from find during a rehash") {
+    REQUIRE(map.IsRehashing());
+    for (auto &entry : map) {
+      std::vector<int> keys;
+      for (auto iter = map.find(entry.GetKey()); !iter.is_end(); ++iter) {
+        GET_INT_FROM_KEY((*iter).GetKey());
+        keys.emplace_back(key_ret);
+      }
+      REQUIRE(keys.size() <= map.size());
+      std::sort(keys.begin(), keys.end());
+      REQUIRE(std::unique(keys.begin(), keys.end()) == keys.end());
+    }
+  }
+
+  // Copy a map in the middle of a rehash
+  PAGE_DIVIDE("Copy during a rehash") {
+    unordered_map<Key, Val> cpy(alloc, map);
+    REQUIRE(cpy.size() == map.size());
+    for (auto &entry : map) {
+      auto iter = cpy.find(entry.GetKey());
+      REQUIRE(!iter.is_end());
+      REQUIRE((*iter).GetVal() == entry.GetVal());
+    }
+  }
+
+  // Reserve buckets up front so inserts never rehash
+  PAGE_DIVIDE("Reserve") {
+    unordered_map<Key, Val> rmap(alloc, 5);
+    rmap.max_load_factor(hshm::RealNumber(1, 1));
+    rmap.reserve(count);
+    size_t num_buckets = rmap.get_num_buckets();
+    REQUIRE(num_buckets >= (size_t)count);
+    REQUIRE(!rmap.IsRehashing());
+    for (int i = 0; i < count; ++i) {
+      CREATE_KV_PAIR(key, i, val, i);
+      rmap.emplace(key, val);
+      REQUIRE(!rmap.IsRehashing());
+    }
+    REQUIRE(rmap.get_num_buckets() == num_buckets);
+  }
+
+  // Clear in the middle of a rehash
+  PAGE_DIVIDE("Clear during a rehash") {
+    while (!map.IsRehashing()) {
+      CREATE_KV_PAIR(key, (int)map.size(), val, (int)map.size());
+      map.emplace(key, val);
+    }
+    map.clear();
+    REQUIRE(map.size() == 0);
+    REQUIRE(!map.IsRehashing());
+  }
+}
+
+TEST_CASE("UnorderedMapGrowthOfIntInt") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  UnorderedMapGrowthTest<int, int>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("UnorderedMapGrowthOfStringString") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  UnorderedMapGrowthTest<string, string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("UnorderedMapHeterogeneousLookup") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  {
+    unordered_map<string, int> map(alloc, 16);
+    const int count = 100;
+    // Keys longer than the SSO buffer, so a temporary key would allocate
+    std::vector<std::string> keys;
+    for (int i = 0; i < count; ++i) {
+      keys.emplace_back(std::string(64, 'k') + std::to_string(i));
+      map.emplace(string(keys.back()), i);
+    }
+
+    PAGE_DIVIDE("Find with foreign string types") {
+      size_t used = alloc->GetCurrentlyAllocatedSize();
+      for (int i = 0; i < count; ++i) {
+        std::string_view view(keys[i]);
+        REQUIRE((*map.find(view)).GetVal() == i);
+        REQUIRE((*map.find(keys[i])).GetVal() == i);
+        REQUIRE((*map.find(keys[i].c_str())).GetVal() == i);
+        REQUIRE(map.contains(view));
+      }
+      REQUIRE(!map.contains(std::string_view("missing")));
+      REQUIRE(map.find("missing").is_end());
+      REQUIRE(alloc->GetCurrentlyAllocatedSize() == used);
+    }
+
+    PAGE_DIVIDE("Find with a precomputed hash") {
+      auto hasher = map.hash_function();
+      for (int i = 0; i < count; ++i) {
+        std::string_view view(keys[i]);
+        size_t hash = hasher(view);
+        REQUIRE(hash == string(keys[i]).Hash());
+        REQUIRE((*map.find(view, hash)).GetVal() == i);
+        REQUIRE(map.contains(view, hash));
+      }
+    }
+
+    PAGE_DIVIDE("Erase with foreign string types") {
+      for (int i = 0; i < count; i += 2) {
+        std::string_view view(keys[i]);
+        map.erase(view, map.hash_function()(view));
+        map.erase(keys[i + 1].c_str());
+      }
+      REQUIRE(map.size() == 0);
+    }
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
@@ -131,3 +131,125 @@ TEST_CASE("VectorOfListOfString") {
   VectorOfListOfStringTest();
   REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
 }
+
+/** Insert into and erase from the middle, checked against std::vector */
+template <typename T>
+void VectorMiddleTest() {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  auto vec = vector<T>(alloc);
+  std::vector<int> expected;
+  for (int i = 0; i < 200; ++i) {
+    size_t pos = expected.size() / 2;
+    CREATE_SET_VAR_TO_INT_OR_STRING(T, var, i);
+    vec.emplace(vec.begin() + pos, var);
+    expected.insert(expected.begin() + pos, i);
+  }
+  for (int i = 0; i < 50; ++i) {
+    size_t pos = expected.size() / 3;
+    vec.erase(vec.begin() + pos, vec.begin() + pos + 2);
+    expected.erase(expected.begin() + pos, expected.begin() + pos + 2);
+  }
+  REQUIRE(vec.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    CREATE_SET_VAR_TO_INT_OR_STRING(T, var, expected[i]);
+    REQUIRE(vec[i] == var);
+  }
+}
+
+TEST_CASE("VectorRelocation") {
+  static_assert(hipc::is_trivially_relocatable_v<int>);
+  static_assert(hipc::is_trivially_relocatable_v<string>);
+  static_assert(hipc::is_trivially_relocatable_v<vector<list<string>>>);
+  static_assert(!hipc::is_trivially_relocatable_v<std::string>);
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  VectorMiddleTest<int>();
+  VectorMiddleTest<string>();
+  VectorMiddleTest<std::string>();
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
+
+TEST_CASE("VectorBulkInsert") {
+  auto *alloc = HSHM_DEFAULT_ALLOC;
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+  PAGE_DIVIDE("Trivially-copyable elements") {
+    std::vector<int> src(1000);
+    for (int i = 0; i < 1000; ++i) {
+      src[i] = i;
+    }
+    auto vec = vector<int>(alloc);
+    vec.set_growth_factor(2);
+    REQUIRE(vec.get_growth_factor() == 2);
+
+    // Factors below 1, infinite or NaN are rejected
+    REQUIRE_THROWS(vec.set_growth_factor(0.5f));
+    REQUIRE_THROWS(vec.set_growth_factor(-2));
+    REQUIRE_THROWS(vec.set_growth_factor(INFINITY));
+    REQUIRE_THROWS(vec.set_growth_factor(NAN));
+    REQUIRE(vec.get_growth_factor() == 2);
+
+    // Growth never rounds the capacity down, even for large vectors
+    size_t big = (size_t(1) << 28) + 15;
+    REQUIRE(vector<int>::grown_capacity(big, 1.0f) > big);
+    REQUIRE(vector<int>::grown_capacity(big, 1.25f) > big);
+    REQUIRE(vector<int>::grown_capacity(SIZE_MAX / 2, FLT_MAX) == SIZE_MAX);
+    REQUIRE(vector<int>::grown_capacity(0, 1.0f) == 10);
+
+    // Copies keep the growth factor
+    auto copy = vector<int>(vec);
+    REQUIRE(copy.get_growth_factor() == 2);
+    copy = vector<int>(alloc);
+    copy = vec;
+    REQUIRE(copy.get_growth_factor() == 2);
+
+    // Bulk loads allocate exactly, later appends grow geometrically
+    vec.assign(src.data(), 500);
+    REQUIRE(vec.size() == 500);
+    REQUIRE(vec.capacity() == 500);
+    vec.append_n(src.data() + 500, 500);
+    REQUIRE(vec.size() == 1000);
+    REQUIRE(vec.capacity() == 1000);
+    vec.append_n(src.data(), 1);
+    REQUIRE(vec.capacity() == 2000);
+    vec.pop_back();
+    for (int i = 0; i < 1000; ++i) {
+      REQUIRE(vec[i] == i);
+    }
+
+    // Insert a range into the middle
+    vec.insert(vec.begin() + 10, src.begin(), src.begin() + 5);
+    REQUIRE(vec.size() == 1005);
+    for (int i = 0; i < 1005; ++i) {
+      int val = i < 10 ? i : (i < 15 ? i - 10 : i - 5);
+      REQUIRE(vec[i] == val);
+    }
+
+    // Fill the vector through data()
+    vec.resize_uninitialized(3000);
+    REQUIRE(vec.size() == 3000);
+    int *data = reinterpret_cast<int *>(vec.data());
+    for (int i = 0; i < 3000; ++i) {
+      data[i] = 3 * i;
+    }
+    REQUIRE(vec[2999] == 3 * 2999);
+    vec.assign(src.data(), 0);
+    REQUIRE(vec.size() == 0);
+  }
+
+  PAGE_DIVIDE("Shared-memory elements") {
+    std::vector<std::string> src = {"a", "b", "c", "d"};
+    auto vec = vector<string>(alloc);
+    vec.emplace_back("x");
+    vec.emplace_back("y");
+    vec.insert(vec.begin() + 1, src.begin(), src.end());
+    REQUIRE(vec.size() == 6);
+    REQUIRE(vec[0] == "x");
+    REQUIRE(vec[1] == "a");
+    REQUIRE(vec[4] == "d");
+    REQUIRE(vec[5] == "y");
+    vec.insert(vec.end(), src.begin(), src.begin() + 2);
+    REQUIRE(vec.size() == 8);
+    REQUIRE(vec[7] == "b");
+  }
+  REQUIRE(alloc->GetCurrentlyAllocatedSize() == 0);
+}
@@ -217,4 +217,22 @@ TEST_CASE("SerializeHshm") {
     srl(h);
     REQUIRE(h == "hello");
   }
+  /** hipc::small_vector */
+  PAGE_DIVIDE("hipc::small_vector") {
+    hipc::LocalSerialize srl(buf);
+    hipc::small_vector<int, 4> h;
+    for (int i = 0; i < 10; ++i) {
+      h.emplace_back(i);
+    }
+    srl(h);
+  }
+  PAGE_DIVIDE("hipc::small_vector") {
+    hipc::LocalDeserialize srl(buf);
+    hipc::small_vector<int, 4> h;
+    srl(h);
+    REQUIRE(h.size() == 10);
+    for (int i = 0; i < 10; ++i) {
+      REQUIRE(h[i] == i);
+    }
+  }
 }